@@ -18,6 +18,34 @@
 
 // * @doFillEventWithArtHits@ - This private method is optional, but is necessary if your detector produces hits that will end up in the Art event. The argument is the GEANT hit collection for the event in question. To add a collection of Art hits to the Art event, you must convert the GEANT hits into Art hits, and then put your collection into the Art event. 
 
+// * @doConvertHits@ and @doPutHits@ - An alternative to @doFillEventWithArtHits@ that lets the DetectorHolderService convert this detector's hits at the same time as other detectors' (if its @parallelHitConversion@ parameter is set). Return true from @doConvertsHitsConcurrently@ to use them. @doConvertHits@ builds the Art hits from the GEANT hits and keeps them; it may run on another thread, so it must not touch the Art event, GEANT managers or anything shared with other detectors. @doPutHits@ then puts what was built into the Art event, on the main thread. @doFillEventWithArtHits@ is not called for such a detector.
+
+// A detector can also put parts of the geometry into G4 regions with their own production cuts and user limits, e.g. to simulate passive supports coarsely, with a @regions@ sequence in its parameters. The DetectorHolderService sets them up once all detectors are placed:
+//
+//   regions: [ { name: "supports"
+//                volumes: [ "supportLV" ]   // logical volume names; all of this detector's LVs if omitted
+//                productionCut: 5.0         // mm; or gammaCut, electronCut, positronCut, protonCut
+//                maxStep: 10.0              // mm; also maxTrackLength, maxTime (ns), minKineticEnergy (MeV), minRange (mm)
+//              } ]
+//
+// Daughters of a region's volumes are in the region too, unless they are in another one. User limits only act if the physics list has the G4StepLimiter (maxStep) and G4UserSpecialCuts (the others) processes.
+
+// * @doMakeFastSimulationModels@ - This private method is optional. A detector with a @fastSimulation@ table in its parameters gets a fast simulation region (envelope), and can construct its own G4VFastSimulationModels for it here. Built-in models, a parameterized electromagnetic shower and a library of recorded showers, can be switched on instead, or as well, from the same table:
+//
+//   fastSimulation: {
+//     region: "calo"                          // an existing region (see regions above); by default the region <category>FastSim of all this detector's LVs
+//     parameterizedEMShower: { enabled: true  minEnergy: 100 }   // see artg4/fastSim/ParameterizedEMShowerModel.hh
+//     showerLibrary: { enabled: true  libraryFile: "caloShowers.bin" }   // see artg4/fastSim/ShowerLibraryModel.hh
+//   }
+//
+// The models deposit energy spots into sensitive detectors that accept them (see @artg4/util/EnergySpot.hh@).
+
+// * @doOverlayHits@ - This private method is optional. When the DetectorHolderService overlays background events from a library (its @backgroundOverlay@ parameter), it is called at the end of each event, once for each background event with hits in this detector, before the hits are converted. A time sliced event gets its background slice by slice instead: before each slice is flushed, this is called with the background hits whose shifted time falls in that slice. Append the background hits to this event's, e.g. with @SoASensitiveDetector::overlay@ (see @artg4/util/BackgroundHits.hh@).
+
+// * @doFlushTimeSlice@ - This private method is optional. When events are simulated in time slices (see @artg4/pluginActions/timeSlicing@), it is called at the end of every slice but the last, with the global time the slice started at. Hand the slice's hits over to a per-slice product and let the sensitive detector start again with an empty collection (see @artg4/util/TimeSlicedHits.hh@). The last slice is left for @doFillEventWithArtHits@ as usual; the DetectorHolderService's @timeSliceStart@ says when it started.
+
+// Rather than converting G4 hits, a detector can have its sensitive detector fill an Art hit collection directly: see @artg4/util/SoAHitCollection.hh@ and @artg4/util/SoASensitiveDetector.hh@. Then this method only has to move the collection into the event. To write it with less precision (and fewer bytes), see @artg4/util/HitQuantization.hh@.
+
 // See below for information about each method. Note that many of them you never
 // call yourself. 
 
@@ -39,10 +67,13 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "artg4/services/DetectorHolder_service.hh"
 
+#include "artg4/util/BackgroundHits.hh"
+
 // Forward referencing
 class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4HCofThisEvent;
+class G4Region;
 
 // h3. Declare the @DetectorBase@ class
 
@@ -80,7 +111,9 @@ namespace artg4 {
     // Destructor
     virtual ~DetectorBase(){}
   
-    // Intialize after the particle list is set up
+    // Intialize after the particle list is set up. Called once per job.
+    // The logical and physical volumes are likewise built once per job, not
+    // once per run, unless artg4Main's @reinitializeEachRun@ is set.
     virtual void initialize() {};
     
     // Build and store the logical volume (calls your @doBuild@ method). You
@@ -110,6 +143,31 @@ namespace artg4 {
       doFillEventWithArtHits(hc);
     }
 
+    // The split version of @fillEventWithArtHits@ for detectors that
+    // support concurrent conversion (see above). You do not need to call
+    // these methods yourself.
+    bool convertsHitsConcurrently() const { return doConvertsHitsConcurrently(); }
+    void convertHits(G4HCofThisEvent * hc) { doConvertHits(hc); }
+    void putHits(art::Event & e) { doPutHits(e); }
+
+    // Add hits from a background event, shifted by timeShift. You do not
+    // need to call this method yourself.
+    void overlayHits(BackgroundHits const& hits, double timeShift) {
+      doOverlayHits(hits, timeShift);
+    }
+
+    // Hand over the hits of the time slice that started at sliceStart. You
+    // do not need to call this method yourself.
+    void flushTimeSlice(double sliceStart) {
+      doFlushTimeSlice(sliceStart);
+    }
+
+    // Make the detector's fast simulation models for its region. You do not
+    // need to call this method yourself.
+    void makeFastSimulationModels(G4Region * region) {
+      doMakeFastSimulationModels(region);
+    }
+
     // h3. Accessors
 
     // Return this detector's Geant Physical Volume
@@ -150,6 +208,27 @@ namespace artg4 {
     // Convert G4 hits into Art hits. Put them in the event (which you can get
     // from the DetectorHolder service).
     virtual void doFillEventWithArtHits(G4HCofThisEvent*) {}
+
+    // Opt in to concurrent hit conversion (see list above)
+    virtual bool doConvertsHitsConcurrently() const { return false; }
+
+    // Convert G4 hits into Art hits and hold on to them. May run on another
+    // thread concurrently with other detectors.
+    virtual void doConvertHits(G4HCofThisEvent*) {}
+
+    // Put the hits built by @doConvertHits@ into the event
+    virtual void doPutHits(art::Event &) {}
+
+    // Add background hits to this event's (see list above)
+    virtual void doOverlayHits(BackgroundHits const&, double /*timeShift*/) {}
+
+    // Move the hits of the time slice that started at sliceStart out of
+    // your sensitive detectors (see list above)
+    virtual void doFlushTimeSlice(double /*sliceStart*/) {}
+
+    // Construct your G4VFastSimulationModels with the given region. Geant
+    // keeps them for the rest of the job.
+    virtual void doMakeFastSimulationModels(G4Region *) {}
   
     
     // h3. Private data
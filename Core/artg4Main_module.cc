@@ -25,6 +25,10 @@
 #include "artg4/geantInit/ArtG4SteppingAction.hh"
 #include "artg4/geantInit/ArtG4StackingAction.hh"
 #include "artg4/geantInit/ArtG4TrackingAction.hh"
+#include "artg4/geantInit/ArtG4EventWatchdog.hh"
+#include "artg4/util/EventAbortStatus.hh"
+#include "artg4/geantInit/ArtG4MemoryMonitor.hh"
+#include "artg4/util/MemoryRunSummary.hh"
 
 // Services
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -33,6 +37,22 @@
 #include "artg4/services/PhysicsListHolder_service.hh"
 #include "art/Framework/Services/Optional/RandomNumberGenerator.h"
 
+// Materials
+#include "artg4/material/Materials.hh"
+#include "artg4/material/OpticalCache.hh"
+
+// Forked workers
+#include "artg4/util/WorkerPartition.hh"
+#include "artg4/util/ForkedRunSummary.hh"
+#include "CLHEP/Random/Random.h"
+
+#include "artg4/util/Fingerprint.hh"
+
+#include <chrono>
+#include <ctime>
+#include <sstream>
+#include <utility>
+
 
 // G4 includes
 #ifdef G4VIS_USE
@@ -62,8 +82,24 @@ namespace artg4 {
     virtual void beginJob() override;
     virtual void beginRun(art::Run &r) override;
     virtual void endRun(art::Run &) override;
+    virtual void endJob() override;
 
   private:
+    // Give Geant the physics list, detector and actions and initialize it
+    void initializeGeant();
+
+    // What Geant's geometry and physics were built from (see
+    // DetectorHolderService::geometryFingerprint and
+    // PhysicsListHolderService::physicsFingerprint). It hashes the services'
+    // job-level configuration only, so it cannot change within a job.
+    std::uint64_t configurationFingerprint() const;
+
+    // Record the time since the last lap as the named phase
+    void lap(std::string const & phase);
+
+    // Log (and clear) the phase times
+    void reportPhaseTimes(art::Run const & r, bool reused);
+
     // Our custom run manager
     unique_ptr<ArtG4RunManager> runManager_;
   
@@ -122,6 +158,53 @@ namespace artg4 {
     
     // Run diagnostic level (verbosity)
     int rmvlevel_;
+
+    // Build all of the artg4Materials materials and optical surfaces up
+    // front (and report how long that took) instead of on first use.
+    // False by default, can be set by config file
+    bool prebuildMaterials_;
+
+    // Have Geant store trajectories (/tracking/storeTrajectory). They cost
+    // memory for every track, so by default they are only stored when
+    // visualizing. TrajectoryStoreService turns them into an Art product.
+    bool storeTrajectories_;
+
+    // File holding precomputed optical properties tables and surfaces (see
+    // material/OpticalCache.hh). If it is missing or stale the tables are
+    // built as usual and the file is (re)written. Empty means no cache.
+    std::string opticalCacheFile_;
+
+    // Number of worker processes to fork once Geant is initialized, and the
+    // prefix of their working directories (see util/WorkerPartition.hh).
+    // 0 (the default) means don't fork.
+    unsigned int forkWorkers_;
+    std::string forkDirPrefix_;
+
+    // MessageFacility configuration each forked worker restarts its logging
+    // with (same syntax as services.message). Empty (the default) logs to
+    // the console.
+    fhicl::ParameterSet workerMessages_;
+
+    // Run Geant's initialization at every begin run (as artg4 used to). False
+    // by default, in which case Geant is initialized once, at the first begin
+    // run, and the geometry and physics are reused for every later run. This
+    // is the only thing that decides reuse: nothing that goes into the
+    // geometry or physics can change between runs of one job.
+    bool reinitializeEachRun_;
+
+    // Whether Geant has been initialized, and the configuration it was
+    // initialized with
+    bool geantInitialized_;
+    std::uint64_t initializedFingerprint_;
+
+    // Time spent in each phase of setting up the current run
+    std::vector< std::pair<std::string, double> > phaseTimes_;
+    std::chrono::steady_clock::time_point lapStart_;
+
+    // This run so far (for the forked run summary)
+    unsigned int nEventsThisRun_;
+    std::chrono::steady_clock::time_point runStartWall_;
+    std::clock_t runStartCPU_;
     
     // When to pop up user interface
     bool uiAtBeginRun_;
@@ -153,6 +236,20 @@ artg4::artg4Main::artg4Main(fhicl::ParameterSet const & p)
 	visSpecificEvents_(p.get<bool>("visualizeSpecificEvents",false)),
 	eventsToDisplay_(),
     rmvlevel_( p.get<int>("rmvlevel",0)),
+    prebuildMaterials_( p.get<bool>("prebuildMaterials", false)),
+    storeTrajectories_( p.get<bool>("storeTrajectories", enableVisualization_)),
+    opticalCacheFile_( p.get<std::string>("opticalCacheFile", "")),
+    forkWorkers_( p.get<unsigned int>("forkWorkers", 0)),
+    forkDirPrefix_( p.get<std::string>("forkDirPrefix", "worker")),
+    workerMessages_( p.get<fhicl::ParameterSet>("workerMessages", fhicl::ParameterSet())),
+    reinitializeEachRun_( p.get<bool>("reinitializeEachRun", false)),
+    geantInitialized_(false),
+    initializedFingerprint_(0),
+    phaseTimes_(),
+    lapStart_(),
+    nEventsThisRun_(0),
+    runStartWall_(),
+    runStartCPU_(0),
     uiAtBeginRun_( p.get<bool>("uiAtBeginRun", false)),
     uiAtEndEvent_(false),
     afterEvent_( p.get<std::string>("afterEvent", "pass")),
@@ -172,11 +269,75 @@ artg4::artg4Main::artg4Main(fhicl::ParameterSet const & p)
 		// do something silly, it'll probably just crash. 
 	}
 
+  // Workers can't share a display or a terminal
+  if ( forkWorkers_ > 0 ) {
+    if ( enableVisualization_ || uiAtBeginRun_ || afterEvent_ != "pass" ) {
+      throw cet::exception("ArtG4Main") << "forkWorkers cannot be used with visualization "
+                                        << "or a user interface\n";
+    }
+    if ( reinitializeEachRun_ ) {
+      throw cet::exception("ArtG4Main") << "forkWorkers cannot be used with reinitializeEachRun: "
+                                        << "the workers reuse what the parent initialized\n";
+    }
+    produces<ForkedRunSummary, art::InRun>();
+  }
+
+  // Give every event a budget, if asked (see ArtG4EventWatchdog.hh)
+  ArtG4EventWatchdog::instance().setBudget(
+    ArtG4EventWatchdog::Budget( p.get<fhicl::ParameterSet>("eventBudget", fhicl::ParameterSet()) ) );
+  if ( ArtG4EventWatchdog::instance().enabled() ) {
+    produces<EventAbortStatus>();
+    produces<EventAbortRunSummary, art::InRun>();
+  }
+
+  // Follow the memory of every event, if asked (see ArtG4MemoryMonitor.hh)
+  ArtG4MemoryMonitor::instance().setSettings(
+    ArtG4MemoryMonitor::Settings( p.get<fhicl::ParameterSet>("memoryMonitor", fhicl::ParameterSet()) ) );
+  if ( ArtG4MemoryMonitor::instance().enabled() ) {
+    produces<MemoryRunSummary, art::InRun>();
+  }
+
+  // The optical cache has to be installed before anything builds an
+  // optical material or surface
+  if ( ! opticalCacheFile_.empty() ) {
+    std::string reason;
+    if ( artg4Materials::loadOpticalCache(opticalCacheFile_, reason) ) {
+      logInfo_ << "Loaded optical tables from " << opticalCacheFile_ << "\n";
+    }
+    else {
+      logInfo_ << "Not using optical cache: " << reason << "\n";
+      if ( artg4Materials::writeOpticalCache(opticalCacheFile_, reason) ) {
+        logInfo_ << "Wrote optical tables to " << opticalCacheFile_ << "\n";
+      }
+      else {
+        mf::LogWarning("ArtG4Main") << "Could not write optical cache: " << reason;
+      }
+    }
+  }
+
   // We need all of the services to run @produces@ on the data they will store. We do this
   // by retrieving the holder services.
   art::ServiceHandle<ActionHolderService> actionHolder;
   art::ServiceHandle<DetectorHolderService> detectorHolder;
     detectorHolder->initialize();
+
+    // Pay for material construction now, if asked, so it shows up as one
+    // measured chunk rather than being spread over detector construction
+    if ( prebuildMaterials_ ) {
+      artg4Materials::PrebuildReport report = artg4Materials::prebuildAll();
+      for ( auto const & timing : report.materials ) {
+        mf::LogDebug("ArtG4Main") << "Built material " << timing.name 
+                                  << " in " << timing.seconds << " s";
+      }
+      for ( auto const & timing : report.surfaces ) {
+        mf::LogDebug("ArtG4Main") << "Built optical surface " << timing.name 
+                                  << " in " << timing.seconds << " s";
+      }
+      logInfo_ << "Prebuilt " << report.materials.size() << " materials and "
+               << report.surfaces.size() << " optical surfaces in "
+               << report.totalSeconds << " s\n";
+    }
+
     //hjw:
     //detectorHolder -> callArtProduces(this);
     // Build the detectors' logical volumes
@@ -219,14 +380,50 @@ void artg4::artg4Main::beginJob()
   // Set up run manager
   mf::LogDebug("Main_Run_Manager") << "In begin job";
   runManager_.reset( new ArtG4RunManager );
+
+  // Initialize Geant and build the physics tables once, before forking, so
+  // the workers share the geometry and physics tables. The parent also
+  // stores them in the physics table cache, once for all workers.
+  if ( forkWorkers_ > 0 ) {
+    lapStart_ = std::chrono::steady_clock::now();
+    initializeGeant();
+    runManager_->InitializePhysicsTables();
+    lap("physics tables");
+
+    art::ServiceHandle<PhysicsListHolderService> physicsListHolder;
+    physicsListHolder->physicsTablesBuilt();
+    lap("physics table cache");
+
+    WorkerPartition & partition = WorkerPartition::instance();
+    partition.forkWorkers(forkWorkers_, forkDirPrefix_, workerMessages_);
+
+    if ( partition.isWorker() ) {
+      // Each worker needs its own random numbers
+      CLHEP::HepRandom::getTheEngine()->setSeed( seed_ + partition.rank(), 0 );
+      logInfo_ << "Worker " << partition.rank() << " of " << forkWorkers_
+               << " running with seed " << seed_ + partition.rank() << "\n";
+    }
+    else {
+      logInfo_ << "Forked " << forkWorkers_ << " workers\n";
+    }
+  }
 }
 
-// At begin run
-void artg4::artg4Main::beginRun(art::Run & r)
-{  
+// At end job
+void artg4::artg4Main::endJob()
+{
+  if ( WorkerPartition::instance().isParent() ) {
+    WorkerPartition::instance().waitForWorkers();
+  }
+}
+
+// Set up Geant
+void artg4::artg4Main::initializeGeant()
+{
   // Get the physics list and pass it to Geant and initialize the list if necessary
   art::ServiceHandle<PhysicsListHolderService> physicsListHolder;
   runManager_->SetUserInitialization( physicsListHolder->makePhysicsList() );
+  lap("physics list");
   
   // Get all of the detectors and initialize them
   art::ServiceHandle<DetectorHolderService> detectorHolder;
@@ -243,9 +440,7 @@ void artg4::artg4Main::beginRun(art::Run & r)
   // Get all of the actions and initialize them
   art::ServiceHandle<ActionHolderService> actionHolder;
   actionHolder->initialize();
-  
-  // Store the run in the action holder
-  actionHolder->setCurrArtRun(r);
+  lap("action initialization");
   
   // Declare the primary generator action to Geant
   runManager_->SetUserAction(new ArtG4PrimaryGeneratorAction);
@@ -262,11 +457,91 @@ void artg4::artg4Main::beginRun(art::Run & r)
   runManager_ -> SetUserAction(new ArtG4RunAction);
 
   runManager_->Initialize();
+  lap("Geant initialization");
   physicsListHolder->initializePhysicsList();
+  lap("physics list initialization");
+
+  // Now that the regions and materials are known, look for cached tables
+  physicsListHolder->setUpPhysicsTableCache();
 
   //get the pointer to the User Interface manager   
   UI_ = G4UImanager::GetUIpointer();  
 
+  // Trajectories on or off (a vis macro may still turn them on)
+  UI_->ApplyCommand( storeTrajectories_ ? "/tracking/storeTrajectory 1"
+                                        : "/tracking/storeTrajectory 0" );
+
+  geantInitialized_ = true;
+  initializedFingerprint_ = configurationFingerprint();
+}
+
+// What the current geometry and physics would be built from
+std::uint64_t artg4::artg4Main::configurationFingerprint() const
+{
+  art::ServiceHandle<DetectorHolderService> detectorHolder;
+  art::ServiceHandle<PhysicsListHolderService> physicsListHolder;
+  Fingerprint f;
+  f.add( detectorHolder->geometryFingerprint() );
+  f.add( physicsListHolder->physicsFingerprint() );
+  return f.value();
+}
+
+void artg4::artg4Main::lap(std::string const & phase)
+{
+  auto now = std::chrono::steady_clock::now();
+  phaseTimes_.push_back( std::make_pair( phase, std::chrono::duration<double>(now - lapStart_).count() ) );
+  lapStart_ = now;
+}
+
+void artg4::artg4Main::reportPhaseTimes(art::Run const & r, bool reused)
+{
+  mf::LogInfo log("ArtG4Main");
+  double total = 0;
+  for ( auto const & phase : phaseTimes_ ) total += phase.second;
+  log << "Began run " << r.id().run() << " in " << total << " s"
+      << ( reused ? " (reusing geometry and physics)" : "" ) << ":\n";
+  for ( auto const & phase : phaseTimes_ ) {
+    log << "  " << phase.first << ": " << phase.second << " s\n";
+  }
+  phaseTimes_.clear();
+}
+
+// At begin run
+void artg4::artg4Main::beginRun(art::Run & r)
+{  
+  WorkerPartition const & partition = WorkerPartition::instance();
+  if ( ! partition.forked() ) lapStart_ = std::chrono::steady_clock::now();
+
+  // Initialize Geant at the first begin run, and again only if
+  // reinitializeEachRun is set. The fingerprints are built from job-level
+  // configuration, so comparing them only guards against a service that
+  // rebuilds itself; it cannot trigger a reinitialization in a normal job.
+  // Forked processes were initialized before forking.
+  bool reuse = geantInitialized_ && ! reinitializeEachRun_ &&
+               configurationFingerprint() == initializedFingerprint_;
+  lap("configuration check");
+  if ( ! reuse ) {
+    if ( partition.forked() ) {
+      throw cet::exception("ArtG4Main") << "The geometry or physics fingerprint changed "
+                                        << "after the workers were forked\n";
+    }
+    initializeGeant();
+  }
+
+  // Store the run in the action holder
+  art::ServiceHandle<ActionHolderService> actionHolder;
+  actionHolder->setCurrArtRun(r);
+
+  nEventsThisRun_ = 0;
+  runStartWall_ = std::chrono::steady_clock::now();
+  runStartCPU_ = std::clock();
+
+  // The parent of forked workers simulates nothing
+  if ( partition.isParent() ) {
+    reportPhaseTimes(r, reuse);
+    return;
+  }
+
   // Set up visualization if it's allowed by current values of env. variables
 #ifdef G4VIS_USE
 
@@ -315,13 +590,30 @@ void artg4::artg4Main::beginRun(art::Run & r)
     delete session_;
   }
 
-  // Start the Geant run!
+  lap("visualization and UI");
+
+  // Start the Geant run! Forked workers find the tables already built.
   runManager_ -> BeamOnBeginRun(r.id().run());
+  lap("run initialization (physics tables)");
+
+  // The physics tables have now been built (or retrieved); cache them.
+  // Forked workers leave that to the parent, which did it before forking.
+  if ( ! partition.forked() ) {
+    art::ServiceHandle<PhysicsListHolderService> physicsListHolder;
+    physicsListHolder->physicsTablesBuilt();
+    lap("physics table cache");
+  }
+
+  reportPhaseTimes(r, reuse);
 }
 
 // Produce the Geant event
 void artg4::artg4Main::produce(art::Event & e)
 {
+  // Some other process's event (see artg4WorkerFilter)
+  if ( ! WorkerPartition::instance().owns(e.id().event()) ) return;
+  ++nEventsThisRun_;
+
   // The holder services need the event
   art::ServiceHandle<ActionHolderService> actionHolder;
   art::ServiceHandle<DetectorHolderService> detectorHolder;
@@ -334,16 +626,41 @@ void artg4::artg4Main::produce(art::Event & e)
   
   logInfo_ << "Producing event " << e.id().event() << "\n" << endl;
 
+  // Say whether the event was completed
+  ArtG4EventWatchdog const & watchdog = ArtG4EventWatchdog::instance();
+  if ( watchdog.enabled() ) {
+    std::unique_ptr<EventAbortStatus> status = watchdog.eventStatus();
+    if ( status->aborted ) {
+      mf::LogWarning("ArtG4Main") << "Event " << e.id().event() << " aborted over budget after "
+                                  << status->nSteps << " steps, " << status->wallSeconds << " s wall, "
+                                  << status->cpuSeconds << " s CPU";
+    }
+    e.put( std::move(status) );
+  }
+
   // Done with the event
   runManager_ -> BeamOnEndEvent();
 
+  ArtG4MemoryMonitor const & memoryMonitor = ArtG4MemoryMonitor::instance();
+  if ( memoryMonitor.enabled() ) {
+    if ( memoryMonitor.settings().logEvents ) {
+      std::ostringstream report;
+      memoryMonitor.describeEvent(report);
+      mf::LogInfo("ArtG4Main") << report.str();
+    }
+    if ( memoryMonitor.growthFlaggedThisEvent() ) {
+      std::ostringstream report;
+      memoryMonitor.describeGrowth(report);
+      mf::LogWarning("ArtG4Main") << report.str();
+    }
+  }
+
 #ifdef G4VIS_USE
   // If visualization is enabled, and we want to pause after each event, do
   // the pausing.
   if (enableVisualization_) {
     
     // Flush the visualization
-    //UI_->ApplyCommand("/tracking/storeTrajectory 1");
     UI_->ApplyCommand("/vis/viewer/flush");
 
     // Only pause or bring up a UI if
@@ -380,7 +697,56 @@ void artg4::artg4Main::endRun(art::Run & r)
   art::ServiceHandle<ActionHolderService> actionHolder;
   actionHolder->setCurrArtRun(r);
 
-  runManager_ -> BeamOnEndRun();
+  WorkerPartition & partition = WorkerPartition::instance();
+  if ( ! partition.isParent() ) runManager_ -> BeamOnEndRun();
+
+  // Count the events that went over budget
+  ArtG4EventWatchdog const & watchdog = ArtG4EventWatchdog::instance();
+  if ( watchdog.enabled() ) {
+    std::unique_ptr<EventAbortRunSummary> aborts( new EventAbortRunSummary( watchdog.runSummary() ) );
+    if ( aborts->nAborted() > 0 ) {
+      mf::LogWarning("ArtG4Main") << aborts->nAborted() << " of " << aborts->nEvents
+                                  << " events in run " << r.id().run() << " were aborted over budget";
+    }
+    r.put( std::move(aborts) );
+  }
+
+  // The memory used by the events
+  ArtG4MemoryMonitor const & memoryMonitor = ArtG4MemoryMonitor::instance();
+  if ( memoryMonitor.enabled() ) {
+    std::unique_ptr<MemoryRunSummary> memory( new MemoryRunSummary( memoryMonitor.runSummary() ) );
+    if ( memory->growthFlagged ) {
+      mf::LogWarning("ArtG4Main") << "Memory grew for up to " << memory->longestGrowth << " events in a row "
+                                  << "in run " << r.id().run() << "; see the MemoryRunSummary";
+    }
+    r.put( std::move(memory) );
+  }
+
+  // Summarize the run: a worker its own part (also sent to the parent), the
+  // parent all of them
+  if ( partition.forked() ) {
+    std::unique_ptr<ForkedRunSummary> summary( new ForkedRunSummary );
+
+    if ( partition.isWorker() ) {
+      WorkerPartition::RunReport report;
+      report.rank = partition.rank();
+      report.nEvents = nEventsThisRun_;
+      report.wallSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - runStartWall_ ).count();
+      report.cpuSeconds = double( std::clock() - runStartCPU_ ) / CLOCKS_PER_SEC;
+      partition.sendReport(report);
+      summary->addWorker(report.rank, report.nEvents, report.wallSeconds, report.cpuSeconds);
+    }
+    else {
+      for ( auto const & report : partition.collectReports() ) {
+        summary->addWorker(report.rank, report.nEvents, report.wallSeconds, report.cpuSeconds);
+      }
+      logInfo_ << "Run " << r.id().run() << ": " << summary->rank.size() << " of " << forkWorkers_
+               << " workers simulated " << summary->totalEvents << " events at "
+               << summary->eventsPerSecond << " events/s\n";
+    }
+
+    r.put( std::move(summary) );
+  }
 
   //  visualization stuff
 #ifdef G4VIS_USE
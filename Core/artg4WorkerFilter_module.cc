@@ -0,0 +1,43 @@
+// artg4WorkerFilter passes only the events this process simulates.
+//
+// When artg4Main forks workers (its @forkWorkers@ parameter; see
+// @artg4/util/WorkerPartition.hh@), every process still reads every event.
+// Put this filter at the front of the path with artg4Main, and select that
+// path in the output module, so that each worker's file holds only its own
+// events and the parent's holds none:
+//
+//   physics: {
+//     producers: { artg4Main: { ... forkWorkers: 8 } }
+//     filters: { workerFilter: { module_type: artg4WorkerFilter } }
+//     path1: [ workerFilter, artg4Main ]
+//     stream1: [ out1 ]
+//     trigger_paths: [ path1 ]
+//     end_paths: [ stream1 ]
+//   }
+//   outputs: { out1: { module_type: RootOutput  fileName: "sim.root"
+//                      SelectEvents: { SelectEvents: [ path1 ] } } }
+//
+// Without forking it passes everything.
+
+// Art includes
+#include "art/Framework/Core/EDFilter.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+
+#include "artg4/util/WorkerPartition.hh"
+
+namespace artg4 {
+
+  class artg4WorkerFilter : public art::EDFilter {
+  public:
+    explicit artg4WorkerFilter(fhicl::ParameterSet const &) {}
+    virtual ~artg4WorkerFilter() {}
+
+    virtual bool filter(art::Event & e) override {
+      return WorkerPartition::instance().owns( e.id().event() );
+    }
+  };
+}
+
+using artg4::artg4WorkerFilter;
+DEFINE_ART_MODULE(artg4WorkerFilter)
@@ -38,6 +38,10 @@ namespace artg4 {
     // Intialize - Instead of putting initialization code into your constructor, put
     // such code in this initialize method. This method will get called at the correct
     // time, after particle lists are already constructed and known to geant.
+    // It is called whenever Geant is initialized, which is once per job
+    // (before any workers are forked), not once per run, unless artg4Main's
+    // @reinitializeEachRun@ is set. Per-run setup belongs in a RunActionBase's
+    // @beginOfRunAction@.
     virtual void initialize() {}
 
     // Call produces<T> to notify Art what you'll be adding to the Art event.
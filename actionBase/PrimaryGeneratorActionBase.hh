@@ -8,6 +8,12 @@
 // and action object is equivalent to putting it in the @GeneratePrimaries@ 
 // method of the simulation's primary generator action class.
 
+// @filterPrimaries@ - Called once all the actions have generated their
+// primaries, to look at the whole event before anything is tracked. An
+// action can use it to decide that some primaries (or all of them) are not
+// worth tracking; it then kills them when they are stacked (see
+// @StackingActionBase@ and @artg4/pluginActions/acceptanceFilter@).
+
 
 // Include guard
 #ifndef PRIMARY_GENERATOR_ACTION_BASE_HH
@@ -47,6 +53,9 @@ namespace artg4 {
     
     // Called for the generation of primaries
     virtual void generatePrimaries(G4Event *) {}
+
+    // Called after all actions have generated their primaries
+    virtual void filterPrimaries(G4Event *) {}
   };
 }
 
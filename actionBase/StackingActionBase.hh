@@ -3,9 +3,22 @@
 
 // The usual method in @G4UserStackingAction@ is @ClassifyNewTrack@. Here, you instead 
 // supply a function for @killNewTrack@, which returns @true@ if the track should be killed
-// and @false@ if the track should remain in the Urgent list (there is no capability to 
-// put a track on the waiting list). See @artg4/geantInit/ArtG4StackingAction.hh@ and @.cc@ for 
-// how this class is handled. 
+// and @false@ if the track should remain in the Urgent list. See
+// @artg4/geantInit/ArtG4StackingAction.hh@ and @.cc@ for how this class is handled. 
+
+// Events can also be processed in stages. A track for which @deferNewTrack@
+// returns @true@ goes on the Waiting list and is only tracked once everything
+// in the current stage is done. At the end of each stage that leaves deferred
+// tracks behind, @abortAfterStage@ is called; if any action returns @true@
+// the rest of the event is abandoned. It is not called once the event has
+// nothing left to track, so a completed event is never aborted.
+// That way, for instance, an event can be thrown away when the primaries
+// left no energy in the trigger detectors, before its showers are tracked:
+// defer the secondaries in stage 0, look at the trigger detectors at the end
+// of stage 0. Deferred tracks are classified again at the start of the next
+// stage, so they can be put off again. An aborting action should record its
+// decision in the Art event (e.g. in @fillEventWithArtStuff@), as the event
+// itself goes on to be written with whatever was simulated.
 
 // Include guard
 #ifndef STACKING_ACTION_BASE_HH
@@ -42,6 +55,18 @@ namespace artg4 {
         // killNewTrack (see above)
         virtual bool killNewTrack( const G4Track* ) { return false; }
 
+        // deferNewTrack - put the track off to the next stage (see above).
+        // stage is the current one, counting from 0.
+        virtual bool deferNewTrack( const G4Track*, unsigned int /*stage*/ ) { return false; }
+
+        // abortAfterStage - called when a stage is done and deferred tracks
+        // remain; return true to abort the event
+        virtual bool abortAfterStage( unsigned int /*stage*/ ) { return false; }
+
+        // prepareNewEvent - called before each event's first track is
+        // classified
+        virtual void prepareNewEvent() {}
+
     };
 }
 
@@ -0,0 +1,43 @@
+// Implementation of EnergySpotDepositor
+
+#include "artg4/fastSim/EnergySpotDepositor.hh"
+
+#include "Geant4/G4Navigator.hh"
+#include "Geant4/G4TouchableHistory.hh"
+#include "Geant4/G4TransportationManager.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4VSensitiveDetector.hh"
+#include "Geant4/G4Track.hh"
+
+#include "artg4/util/EnergySpot.hh"
+
+artg4::EnergySpotDepositor::EnergySpotDepositor() :
+  navigator_(),
+  touchable_()
+{}
+
+artg4::EnergySpotDepositor::~EnergySpotDepositor()
+{}
+
+void artg4::EnergySpotDepositor::deposit(G4ThreeVector const& position, double energy,
+                                         double time, const G4Track& track) {
+  // The world is only known once the geometry is closed, so set up lazily
+  if ( ! navigator_ ) {
+    navigator_.reset( new G4Navigator );
+    navigator_->SetWorldVolume( G4TransportationManager::GetTransportationManager()
+                                  ->GetNavigatorForTracking()->GetWorldVolume() );
+    touchable_.reset( new G4TouchableHistory );
+  }
+
+  navigator_->LocateGlobalPointAndUpdateTouchable(position, touchable_.get(), false);
+  G4VPhysicalVolume * pv = touchable_->GetVolume();
+  if ( ! pv ) return;
+
+  G4VSensitiveDetector * sd = pv->GetLogicalVolume()->GetSensitiveDetector();
+  EnergySpotSensitiveDetector * receiver = dynamic_cast<EnergySpotSensitiveDetector*>(sd);
+  if ( ! receiver ) return;
+
+  EnergySpot spot = { position, energy, time };
+  receiver->processSpot(spot, touchable_.get(), track);
+}
@@ -0,0 +1,37 @@
+// EnergySpotDepositor hands energy spots from a fast simulation model to
+// the sensitive detectors of the volumes they land in (see
+// @artg4/util/EnergySpot.hh@).
+
+// It locates each spot with a navigator of its own, so as not to disturb
+// the tracking navigator. Spots in volumes without a sensitive detector,
+// or with one that does not take spots, are dropped.
+
+#ifndef ENERGYSPOTDEPOSITOR_HH
+#define ENERGYSPOTDEPOSITOR_HH
+
+#include <memory>
+
+#include "Geant4/G4ThreeVector.hh"
+
+class G4Navigator;
+class G4TouchableHistory;
+class G4Track;
+
+namespace artg4 {
+
+  class EnergySpotDepositor {
+  public:
+    EnergySpotDepositor();
+    ~EnergySpotDepositor();
+
+    // Put one spot (global position and time) into the sensitive detector
+    // of its volume, if any. The track is the one the model replaced.
+    void deposit(G4ThreeVector const& position, double energy, double time, const G4Track& track);
+
+  private:
+    std::unique_ptr<G4Navigator> navigator_;
+    std::unique_ptr<G4TouchableHistory> touchable_;
+  };
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Implementation of the parameterized EM shower model
+
+#include "artg4/fastSim/ParameterizedEMShowerModel.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cetlib/exception.h"
+
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/RandGamma.h"
+
+#include "Geant4/G4FastTrack.hh"
+#include "Geant4/G4FastStep.hh"
+#include "Geant4/G4Material.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4Electron.hh"
+#include "Geant4/G4Positron.hh"
+#include "Geant4/G4Gamma.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+#include "Geant4/G4PhysicalConstants.hh"
+
+namespace {
+
+  // Rossi's approximations, as in the PDG review
+  double criticalEnergyOf(const G4Material* material) {
+    double zEff = material->GetTotNbOfElectPerVolume() / material->GetTotNbOfAtomsPerVolume();
+    if ( material->GetState() == kStateGas ) return 710 * CLHEP::MeV / (zEff + 0.92);
+    return 610 * CLHEP::MeV / (zEff + 1.24);
+  }
+}
+
+artg4::ParameterizedEMShowerModel::ParameterizedEMShowerModel(G4String const& name, G4Region* region,
+                                                              fhicl::ParameterSet const& p,
+                                                              const G4Material* material) :
+  G4VFastSimulationModel(name, region),
+  minEnergy_( p.get<double>("minEnergy", 100.) * CLHEP::MeV ),
+  maxEnergy_( p.get<double>("maxEnergy", 0.) * CLHEP::MeV ),
+  spotsPerGeV_( p.get<double>("spotsPerGeV", 100.) ),
+  radiationLength_(0),
+  moliereRadius_(0),
+  criticalEnergy_(0),
+  depositor_()
+{
+  // The shower shape, by default from the material
+  bool complete = p.has_key("radiationLength") && p.has_key("moliereRadius") && p.has_key("criticalEnergy");
+  if ( ! complete && ! material ) {
+    throw cet::exception("ParameterizedEMShowerModel") << name << ": no material to take the shower "
+                                                       << "shape from; give radiationLength, "
+                                                       << "moliereRadius and criticalEnergy\n";
+  }
+  double x0 = material ? material->GetRadlen() : 0;
+  double ec = material ? criticalEnergyOf(material) : 0;
+  radiationLength_ = p.has_key("radiationLength") ? p.get<double>("radiationLength") * CLHEP::mm : x0;
+  criticalEnergy_ = p.has_key("criticalEnergy") ? p.get<double>("criticalEnergy") * CLHEP::MeV : ec;
+  moliereRadius_ = p.has_key("moliereRadius") ? p.get<double>("moliereRadius") * CLHEP::mm
+                                              : 21.2052 * CLHEP::MeV * radiationLength_ / criticalEnergy_;
+}
+
+artg4::ParameterizedEMShowerModel::~ParameterizedEMShowerModel()
+{}
+
+G4bool artg4::ParameterizedEMShowerModel::IsApplicable(const G4ParticleDefinition& particle) {
+  return &particle == G4Electron::ElectronDefinition() ||
+         &particle == G4Positron::PositronDefinition() ||
+         &particle == G4Gamma::GammaDefinition();
+}
+
+G4bool artg4::ParameterizedEMShowerModel::ModelTrigger(const G4FastTrack& fastTrack) {
+  double energy = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  return energy >= minEnergy_ && ( maxEnergy_ <= 0 || energy <= maxEnergy_ );
+}
+
+void artg4::ParameterizedEMShowerModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) {
+  const G4Track & track = *fastTrack.GetPrimaryTrack();
+
+  // The spots carry the energy; the step itself deposits nothing, so that
+  // it is not counted twice
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.0);
+
+  double energy = track.GetKineticEnergy();
+  bool isGamma = track.GetDefinition() == G4Gamma::GammaDefinition();
+  if ( track.GetDefinition() == G4Positron::PositronDefinition() ) energy += 2 * CLHEP::electron_mass_c2;
+
+  // Longitudinal profile
+  const double b = 0.5;
+  double tMax = std::log(energy / criticalEnergy_) + ( isGamma ? 0.5 : -0.5 );
+  double a = std::max(1., b * tMax + 1);
+
+  // Shower axes
+  G4ThreeVector origin = track.GetPosition();
+  G4ThreeVector axis = track.GetMomentumDirection();
+  G4ThreeVector u = axis.orthogonal().unit();
+  G4ThreeVector v = axis.cross(u);
+
+  int nSpots = std::max( 10, static_cast<int>( energy / CLHEP::GeV * spotsPerGeV_ ) );
+  double spotEnergy = energy / nSpots;
+
+  for ( int i = 0; i < nSpots; ++i ) {
+    double depth = CLHEP::RandGamma::shoot(a, b) * radiationLength_;
+
+    // Invert the lateral distribution's cumulative, F(r) = r^2 / (r^2 + R^2)
+    double f = CLHEP::RandFlat::shoot();
+    double r = moliereRadius_ * std::sqrt( f / (1 - f) );
+    double phi = CLHEP::RandFlat::shoot(0., 2 * M_PI);
+
+    G4ThreeVector position = origin + depth * axis + r * ( std::cos(phi) * u + std::sin(phi) * v );
+    double time = track.GetGlobalTime() + depth / CLHEP::c_light;
+    depositor_.deposit(position, spotEnergy, time, track);
+  }
+}
@@ -0,0 +1,78 @@
+// A parameterized electromagnetic shower model
+//
+// Simulating electromagnetic showers in a calorimeter step by step is
+// usually the largest CPU cost of an event. This fast simulation model
+// replaces an electron, positron or photon above @minEnergy@ entering its
+// region by a shower of energy spots, deposited straight into the
+// sensitive detectors of the volumes they land in (see
+// @artg4/util/EnergySpot.hh@).
+//
+// The shower is the usual average parameterization:
+// * longitudinal: a gamma distribution in depth t (in radiation lengths),
+//   dE/dt ~ (bt)^(a-1) exp(-bt) with b = 0.5 and the maximum at
+//   t = ln(E/Ec) - 0.5 for electrons and + 0.5 for photons
+// * lateral: f(r) ~ 2 r R^2 / (r^2 + R^2)^2 with R the Moliere radius
+//
+// Fluctuations come only from sampling the spots. Energy carried by spots
+// outside any sensitive volume is lost, like shower leakage.
+//
+// Configure it in a detector's @fastSimulation@ table (see DetectorBase.hh):
+//
+//   parameterizedEMShower: {
+//     enabled: true
+//     minEnergy: 100         // MeV; lower energy particles are simulated in full
+//     maxEnergy: 0           // MeV; 0 means no limit
+//     spotsPerGeV: 100       // (at least 10 spots per shower)
+//     radiationLength: 8.9   // mm    } by default computed from the
+//     moliereRadius: 22.     // mm    } material of the region's
+//     criticalEnergy: 9.6    // MeV   } volume
+//   }
+//
+// The physics list has to have the G4FastSimulationManagerProcess for
+// e+, e- and gamma for any fast simulation model to be called.
+
+#ifndef PARAMETERIZEDEMSHOWERMODEL_HH
+#define PARAMETERIZEDEMSHOWERMODEL_HH
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "Geant4/G4VFastSimulationModel.hh"
+
+#include "artg4/fastSim/EnergySpotDepositor.hh"
+
+class G4Material;
+
+namespace artg4 {
+
+  class ParameterizedEMShowerModel : public G4VFastSimulationModel {
+  public:
+
+    // Parameters as above. The material gives the defaults for the shower
+    // shape.
+    ParameterizedEMShowerModel(G4String const& name, G4Region* region,
+                               fhicl::ParameterSet const& p, const G4Material* material);
+    virtual ~ParameterizedEMShowerModel();
+
+    // e+, e- and gamma
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+
+    // Within the energy range
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+
+    // Replace the particle by its shower
+    virtual void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+  private:
+
+    double minEnergy_;
+    double maxEnergy_;
+    double spotsPerGeV_;
+    double radiationLength_;
+    double moliereRadius_;
+    double criticalEnergy_;
+
+    EnergySpotDepositor depositor_;
+  };
+}
+
+#endif
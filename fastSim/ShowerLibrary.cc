@@ -0,0 +1,255 @@
+// Implementation of ShowerLibrary and ShowerLibraryBuilder
+
+#include "artg4/fastSim/ShowerLibrary.hh"
+
+#include "cetlib/exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  const char fileMagic[8] = { 'A','R','T','G','4','S','H','L' };
+  const std::uint32_t fileVersion = 1;
+
+  struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nPdgIDs;
+    std::uint32_t nEnergyBins;
+    std::uint32_t nCosTheta;
+    std::uint64_t nShowers;
+    std::uint64_t nSpots;
+  };
+
+  // The pdg ID block is padded so that what follows stays 8 byte aligned
+  std::size_t pdgBlockSize(std::size_t nPdgIDs) {
+    return ( nPdgIDs * sizeof(std::int32_t) + 7 ) / 8 * 8;
+  }
+}
+
+
+int artg4::ShowerLibrary::Binning::bin(int pdgID, double energy, double cosTheta) const {
+  auto pdg = std::find( pdgIDs.begin(), pdgIDs.end(), pdgID );
+  if ( pdg == pdgIDs.end() || energyEdges.size() < 2 ) return -1;
+  if ( energy < energyEdges.front() || energy >= energyEdges.back() ) return -1;
+
+  int ip = pdg - pdgIDs.begin();
+  int ie = std::upper_bound( energyEdges.begin(), energyEdges.end(), energy ) - energyEdges.begin() - 1;
+  int nc = std::max( nCosTheta, 1u );
+  int ic = std::max( 0, std::min( static_cast<int>( (cosTheta + 1) / 2 * nc ), nc - 1 ) );
+
+  return ( ip * static_cast<int>( energyEdges.size() - 1 ) + ie ) * nc + ic;
+}
+
+
+artg4::ShowerLibrary::ShowerLibrary(std::string const& fileName) :
+  fileName_(fileName),
+  binning_(),
+  data_(MAP_FAILED),
+  size_(0),
+  binStart_(0),
+  showers_(0),
+  spots_(0),
+  nShowers_(0),
+  nSpots_(0)
+{
+  int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd < 0 ) {
+    throw cet::exception("ShowerLibrary") << "Cannot open shower library " << fileName << ": "
+                                          << std::strerror(errno) << "\n";
+  }
+  struct stat info;
+  if ( fstat(fd, &info) == 0 && info.st_size > 0 ) {
+    size_ = info.st_size;
+    data_ = mmap( 0, size_, PROT_READ, MAP_SHARED, fd, 0 );
+  }
+  close(fd);
+  if ( data_ == MAP_FAILED ) {
+    throw cet::exception("ShowerLibrary") << "Cannot map shower library " << fileName << "\n";
+  }
+
+  // Check the header, then that the file is as long as it says
+  const char* bytes = static_cast<const char*>(data_);
+  FileHeader header;
+  bool valid = size_ >= sizeof(header);
+  if ( valid ) {
+    std::memcpy( &header, bytes, sizeof(header) );
+    valid = std::equal( fileMagic, fileMagic + sizeof(fileMagic), header.magic ) &&
+            header.version == fileVersion && header.nEnergyBins > 0 && header.nCosTheta > 0;
+  }
+  if ( ! valid ) {
+    munmap( data_, size_ );
+    throw cet::exception("ShowerLibrary") << fileName << " is not a version " << fileVersion
+                                          << " shower library\n";
+  }
+
+  // Counts too big for the file would overflow the offsets below
+  if ( header.nShowers > size_ / sizeof(Shower) || header.nSpots > size_ / sizeof(Spot) ||
+       std::uint64_t(header.nPdgIDs) * header.nEnergyBins > size_ / header.nCosTheta ) {
+    munmap( data_, size_ );
+    throw cet::exception("ShowerLibrary") << fileName << " is corrupt: its header counts are too big "
+                                          << "for its " << size_ << " bytes\n";
+  }
+
+  std::size_t nBins = std::size_t(header.nPdgIDs) * header.nEnergyBins * header.nCosTheta;
+  std::size_t offset = sizeof(header);
+  std::size_t pdgOffset = offset;       offset += pdgBlockSize(header.nPdgIDs);
+  std::size_t edgesOffset = offset;     offset += ( header.nEnergyBins + 1 ) * sizeof(double);
+  std::size_t binStartOffset = offset;  offset += ( nBins + 1 ) * sizeof(std::uint64_t);
+  std::size_t showersOffset = offset;   offset += header.nShowers * sizeof(Shower);
+  std::size_t spotsOffset = offset;     offset += header.nSpots * sizeof(Spot);
+  if ( offset != size_ ) {
+    munmap( data_, size_ );
+    throw cet::exception("ShowerLibrary") << fileName << " is " << size_ << " bytes long, but its "
+                                          << "header says " << offset << "\n";
+  }
+
+  const std::int32_t* pdgIDs = reinterpret_cast<const std::int32_t*>( bytes + pdgOffset );
+  const double* edges = reinterpret_cast<const double*>( bytes + edgesOffset );
+  binning_.pdgIDs.assign( pdgIDs, pdgIDs + header.nPdgIDs );
+  binning_.energyEdges.assign( edges, edges + header.nEnergyBins + 1 );
+  binning_.nCosTheta = header.nCosTheta;
+
+  binStart_ = reinterpret_cast<const std::uint64_t*>( bytes + binStartOffset );
+  showers_ = reinterpret_cast<const Shower*>( bytes + showersOffset );
+  spots_ = reinterpret_cast<const Spot*>( bytes + spotsOffset );
+  nShowers_ = header.nShowers;
+  nSpots_ = header.nSpots;
+
+  // The lengths only show that the arrays are there. Check that what they
+  // hold stays inside them too, so that a damaged file can't send sample()
+  // or spots() off the end of the mapping.
+  const char* problem = 0;
+  if ( binStart_[0] != 0 || binStart_[nBins] != nShowers_ ) {
+    problem = "bin starts do not run from 0 to the number of showers";
+  }
+  for ( std::size_t b = 0; b < nBins && ! problem; ++b ) {
+    if ( binStart_[b + 1] < binStart_[b] ) problem = "bin starts decrease";
+  }
+  for ( std::size_t i = 0; i < nShowers_ && ! problem; ++i ) {
+    if ( showers_[i].firstSpot > nSpots_ || showers_[i].nSpots > nSpots_ - showers_[i].firstSpot ) {
+      problem = "a shower's spots run past the end of the spots";
+    }
+  }
+  if ( problem ) {
+    munmap( data_, size_ );
+    throw cet::exception("ShowerLibrary") << fileName << " is corrupt: " << problem << "\n";
+  }
+}
+
+artg4::ShowerLibrary::~ShowerLibrary() {
+  munmap( data_, size_ );
+}
+
+int artg4::ShowerLibrary::findBin(int pdgID, double energy, double cosTheta) const {
+  int bin = binning_.bin(pdgID, energy, cosTheta);
+  if ( bin < 0 ) return -1;
+
+  // Step out in energy, keeping the particle and the angle
+  int nEnergy = binning_.energyEdges.size() - 1;
+  int nCos = binning_.nCosTheta;
+  int energyBin = ( bin / nCos ) % nEnergy;
+  for ( int d = 0; d < nEnergy; ++d ) {
+    for ( int e : { energyBin - d, energyBin + d } ) {
+      if ( e < 0 || e >= nEnergy ) continue;
+      int candidate = bin + ( e - energyBin ) * nCos;
+      if ( binStart_[candidate + 1] > binStart_[candidate] ) return candidate;
+    }
+  }
+  return -1;
+}
+
+artg4::ShowerLibrary::Shower const& artg4::ShowerLibrary::sample(int bin, double u) const {
+  std::uint64_t first = binStart_[bin];
+  std::uint64_t n = binStart_[bin + 1] - first;
+  std::uint64_t i = std::min( static_cast<std::uint64_t>( u * n ), n - 1 );
+  return showers_[first + i];
+}
+
+
+artg4::ShowerLibraryBuilder::ShowerLibraryBuilder(ShowerLibrary::Binning const& binning,
+                                                  unsigned int maxShowersPerBin) :
+  binning_(binning),
+  maxShowersPerBin_(maxShowersPerBin),
+  bins_(),
+  nShowers_(0)
+{
+  if ( binning_.pdgIDs.empty() || binning_.energyEdges.size() < 2 ||
+       ! std::is_sorted( binning_.energyEdges.begin(), binning_.energyEdges.end() ) ) {
+    throw cet::exception("ShowerLibrary") << "A shower library needs particles and at least two "
+                                          << "increasing energy edges\n";
+  }
+  binning_.nCosTheta = std::max( binning_.nCosTheta, 1u );
+  bins_.resize( binning_.nBins() );
+}
+
+bool artg4::ShowerLibraryBuilder::wants(int pdgID, double energy, double cosTheta) const {
+  int bin = binning_.bin(pdgID, energy, cosTheta);
+  return bin >= 0 && ( maxShowersPerBin_ == 0 || bins_[bin].size() < maxShowersPerBin_ );
+}
+
+bool artg4::ShowerLibraryBuilder::add(int pdgID, double energy, double cosTheta,
+                                      std::vector<ShowerLibrary::Spot> const& spots) {
+  if ( ! wants(pdgID, energy, cosTheta) ) return false;
+  Recorded shower = { energy, spots };
+  bins_[ binning_.bin(pdgID, energy, cosTheta) ].push_back( std::move(shower) );
+  ++nShowers_;
+  return true;
+}
+
+void artg4::ShowerLibraryBuilder::write(std::string const& fileName) const {
+  std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( ! out ) {
+    throw cet::exception("ShowerLibrary") << "Cannot open " << fileName << " for writing\n";
+  }
+
+  // Lay out the showers bin by bin
+  std::vector<std::uint64_t> binStart(1, 0);
+  std::vector<ShowerLibrary::Shower> showers;
+  std::uint64_t nSpots = 0;
+  for ( auto const& bin : bins_ ) {
+    for ( auto const& recorded : bin ) {
+      ShowerLibrary::Shower shower = { recorded.energy, nSpots, recorded.spots.size() };
+      showers.push_back(shower);
+      nSpots += recorded.spots.size();
+    }
+    binStart.push_back( showers.size() );
+  }
+
+  FileHeader header;
+  std::copy( fileMagic, fileMagic + sizeof(fileMagic), header.magic );
+  header.version = fileVersion;
+  header.nPdgIDs = binning_.pdgIDs.size();
+  header.nEnergyBins = binning_.energyEdges.size() - 1;
+  header.nCosTheta = binning_.nCosTheta;
+  header.nShowers = showers.size();
+  header.nSpots = nSpots;
+  out.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+
+  std::vector<std::int32_t> pdgIDs( pdgBlockSize( binning_.pdgIDs.size() ) / sizeof(std::int32_t), 0 );
+  std::copy( binning_.pdgIDs.begin(), binning_.pdgIDs.end(), pdgIDs.begin() );
+  out.write( reinterpret_cast<const char*>( pdgIDs.data() ), pdgIDs.size() * sizeof(std::int32_t) );
+  out.write( reinterpret_cast<const char*>( binning_.energyEdges.data() ),
+             binning_.energyEdges.size() * sizeof(double) );
+  out.write( reinterpret_cast<const char*>( binStart.data() ), binStart.size() * sizeof(std::uint64_t) );
+  out.write( reinterpret_cast<const char*>( showers.data() ), showers.size() * sizeof(ShowerLibrary::Shower) );
+  for ( auto const& bin : bins_ ) {
+    for ( auto const& recorded : bin ) {
+      out.write( reinterpret_cast<const char*>( recorded.spots.data() ),
+                 recorded.spots.size() * sizeof(ShowerLibrary::Spot) );
+    }
+  }
+
+  out.close();
+  if ( ! out ) {
+    throw cet::exception("ShowerLibrary") << "Error writing " << fileName << "\n";
+  }
+}
@@ -0,0 +1,133 @@
+// ShowerLibrary - showers recorded from full simulation, for replay
+//
+// A shower library holds the energy deposits of showers started by
+// particles entering a calorimeter, binned by the entering particle's type,
+// kinetic energy and angle of entry (cos theta to the entered volume's
+// local z axis). Each shower is a list of spots in the shower's own frame:
+// the distance along the particle's direction, two coordinates across it,
+// the time after entry and the fraction of the particle's energy deposited.
+//
+// Libraries are written by ShowerLibraryBuilder (filled from full
+// simulation by ShowerLibraryMakerService, see
+// @artg4/pluginActions/showerLibrary@) and replayed by ShowerLibraryModel.
+// A library is read by mapping the file into memory: nothing is copied,
+// and the pages are shared by all the jobs on a machine that use the same
+// file.
+//
+// The file is native endian. After a header, it holds the binning, the
+// index of the first shower of each bin, the showers and then the spots.
+
+#ifndef SHOWERLIBRARY_HH
+#define SHOWERLIBRARY_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace artg4 {
+
+  class ShowerLibrary {
+  public:
+
+    // One deposit of a shower
+    struct Spot {
+      float along;            // mm along the particle's direction
+      float across1;          // mm across it, see ShowerLibraryModel.hh
+      float across2;
+      float time;             // ns after the particle entered
+      float energyFraction;   // of the particle's kinetic energy
+    };
+
+    // One shower; its spots are nSpots starting at firstSpot
+    struct Shower {
+      double energy;          // MeV, of the particle that started it
+      std::uint64_t firstSpot;
+      std::uint64_t nSpots;
+    };
+
+    struct Binning {
+      std::vector<int> pdgIDs;
+      std::vector<double> energyEdges;   // MeV, increasing
+      unsigned int nCosTheta;            // equal bins over [-1, 1]
+
+      std::size_t nBins() const { return pdgIDs.size() * ( energyEdges.size() - 1 ) * nCosTheta; }
+
+      // The bin of a particle, or -1 if it is outside the binning
+      int bin(int pdgID, double energy, double cosTheta) const;
+    };
+
+    // Map a library file. Throws cet::exception if it cannot be read or is
+    // not a library.
+    explicit ShowerLibrary(std::string const& fileName);
+    ~ShowerLibrary();
+
+    ShowerLibrary(ShowerLibrary const&) = delete;
+    ShowerLibrary& operator=(ShowerLibrary const&) = delete;
+
+    // The bin to take a shower for this particle from: its own, or if that
+    // is empty the nearest energy bin with showers at the same angle. -1 if
+    // there is none.
+    int findBin(int pdgID, double energy, double cosTheta) const;
+
+    // A shower from a bin found above, given a uniform random number in
+    // [0,1)
+    Shower const& sample(int bin, double u) const;
+
+    const Spot* spots(Shower const& shower) const { return spots_ + shower.firstSpot; }
+
+    Binning const& binning() const { return binning_; }
+    std::string const& fileName() const { return fileName_; }
+    std::size_t nShowers() const { return nShowers_; }
+    std::size_t nSpots() const { return nSpots_; }
+
+  private:
+    std::string fileName_;
+    Binning binning_;
+
+    // The mapping
+    void* data_;
+    std::size_t size_;
+
+    // Into the mapping
+    const std::uint64_t* binStart_;   // nBins + 1
+    const Shower* showers_;
+    const Spot* spots_;
+    std::size_t nShowers_;
+    std::size_t nSpots_;
+  };
+
+
+  // Collects recorded showers and writes them out as a library
+  class ShowerLibraryBuilder {
+  public:
+
+    // At most maxShowersPerBin showers are kept in each bin; 0 means no limit
+    ShowerLibraryBuilder(ShowerLibrary::Binning const& binning, unsigned int maxShowersPerBin);
+
+    // Whether a shower of this particle would be kept
+    bool wants(int pdgID, double energy, double cosTheta) const;
+
+    // Add a shower. The spots' energy fractions are of the particle's energy.
+    // Returns false if it was not kept.
+    bool add(int pdgID, double energy, double cosTheta, std::vector<ShowerLibrary::Spot> const& spots);
+
+    std::size_t nShowers() const { return nShowers_; }
+
+    // Write the library. Throws cet::exception on failure.
+    void write(std::string const& fileName) const;
+
+  private:
+    struct Recorded {
+      double energy;
+      std::vector<ShowerLibrary::Spot> spots;
+    };
+
+    ShowerLibrary::Binning binning_;
+    unsigned int maxShowersPerBin_;
+    std::vector<std::vector<Recorded> > bins_;
+    std::size_t nShowers_;
+  };
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Implementation of the shower library model
+
+#include "artg4/fastSim/ShowerLibraryModel.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CLHEP/Random/RandFlat.h"
+
+#include "Geant4/G4FastTrack.hh"
+#include "Geant4/G4FastStep.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::ShowerLibraryModel::ShowerLibraryModel(G4String const& name, G4Region* region,
+                                              fhicl::ParameterSet const& p) :
+  G4VFastSimulationModel(name, region),
+  library_( new ShowerLibrary( p.get<std::string>("libraryFile") ) ),
+  minEnergy_( p.get<double>("minEnergy", 0.) * CLHEP::MeV ),
+  maxEnergy_( p.get<double>("maxEnergy", 0.) * CLHEP::MeV ),
+  depositor_()
+{}
+
+artg4::ShowerLibraryModel::~ShowerLibraryModel()
+{}
+
+G4bool artg4::ShowerLibraryModel::IsApplicable(const G4ParticleDefinition& particle) {
+  std::vector<int> const& pdgIDs = library_->binning().pdgIDs;
+  return std::find( pdgIDs.begin(), pdgIDs.end(), particle.GetPDGEncoding() ) != pdgIDs.end();
+}
+
+int artg4::ShowerLibraryModel::binFor(const G4FastTrack& fastTrack) const {
+  const G4Track & track = *fastTrack.GetPrimaryTrack();
+  return library_->findBin( track.GetDefinition()->GetPDGEncoding(), track.GetKineticEnergy() / CLHEP::MeV,
+                            fastTrack.GetPrimaryTrackLocalDirection().cosTheta() );
+}
+
+G4bool artg4::ShowerLibraryModel::ModelTrigger(const G4FastTrack& fastTrack) {
+  double energy = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  if ( energy < minEnergy_ || ( maxEnergy_ > 0 && energy > maxEnergy_ ) ) return false;
+  return binFor(fastTrack) >= 0;
+}
+
+void artg4::ShowerLibraryModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) {
+  const G4Track & track = *fastTrack.GetPrimaryTrack();
+
+  // The spots carry the energy; the step itself deposits nothing
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.0);
+
+  ShowerLibrary::Shower const& shower = library_->sample( binFor(fastTrack), CLHEP::RandFlat::shoot() );
+  const ShowerLibrary::Spot* spots = library_->spots(shower);
+
+  // The shower's frame, turned by a random angle about its axis. The
+  // library's across axes are orthogonal() and its cross product, as here.
+  G4ThreeVector origin = track.GetPosition();
+  G4ThreeVector axis = track.GetMomentumDirection();
+  G4ThreeVector u = axis.orthogonal().unit();
+  G4ThreeVector v = axis.cross(u);
+  double phi = CLHEP::RandFlat::shoot(0., 2 * M_PI);
+  G4ThreeVector across1 = std::cos(phi) * u + std::sin(phi) * v;
+  G4ThreeVector across2 = axis.cross(across1);
+
+  double energy = track.GetKineticEnergy();
+  double t0 = track.GetGlobalTime();
+  for ( std::uint64_t i = 0; i < shower.nSpots; ++i ) {
+    ShowerLibrary::Spot const& spot = spots[i];
+    G4ThreeVector position = origin + spot.along * CLHEP::mm * axis
+                                    + spot.across1 * CLHEP::mm * across1
+                                    + spot.across2 * CLHEP::mm * across2;
+    depositor_.deposit(position, spot.energyFraction * energy, t0 + spot.time * CLHEP::ns, track);
+  }
+}
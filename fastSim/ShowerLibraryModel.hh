@@ -0,0 +1,73 @@
+// A fast simulation model that replays showers from a shower library
+//
+// Instead of parameterizing the shower (see ParameterizedEMShowerModel.hh),
+// this model takes a shower recorded from full simulation (see
+// ShowerLibrary.hh) for a particle entering its region, and deposits its
+// spots, scaled to the particle's energy, as energy spots (see
+// @artg4/util/EnergySpot.hh@). The particle is killed and its secondaries
+// are never tracked.
+//
+// The shower is taken from the bin of the particle's type, energy and
+// angle to the local z axis of the envelope volume it enters; if that bin
+// is empty, from the nearest energy bin that is not. The shower is placed
+// at the particle's position, along its direction, and turned by a random
+// angle about it. Particles outside the library's binning are left to the
+// next model, or to full simulation.
+//
+// Configure it in a detector's @fastSimulation@ table (see DetectorBase.hh):
+//
+//   showerLibrary: {
+//     enabled: true
+//     libraryFile: "caloShowers.bin"
+//     minEnergy: 0    // MeV; by default the library's energy range
+//     maxEnergy: 0    // MeV; 0 means no limit
+//   }
+//
+// If the parameterized shower is enabled as well, it takes the particles
+// the library cannot.
+
+#ifndef SHOWERLIBRARYMODEL_HH
+#define SHOWERLIBRARYMODEL_HH
+
+#include <memory>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "Geant4/G4VFastSimulationModel.hh"
+
+#include "artg4/fastSim/EnergySpotDepositor.hh"
+#include "artg4/fastSim/ShowerLibrary.hh"
+
+namespace artg4 {
+
+  class ShowerLibraryModel : public G4VFastSimulationModel {
+  public:
+
+    // Parameters as above. Throws cet::exception if the library cannot be
+    // read.
+    ShowerLibraryModel(G4String const& name, G4Region* region, fhicl::ParameterSet const& p);
+    virtual ~ShowerLibraryModel();
+
+    // The particles in the library
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+
+    // Within the energy range, and with a shower to replay
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+
+    // Replace the particle by a library shower
+    virtual void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+  private:
+
+    // The library bin for this particle, or -1
+    int binFor(const G4FastTrack& fastTrack) const;
+
+    std::unique_ptr<ShowerLibrary> library_;
+    double minEnergy_;
+    double maxEnergy_;
+
+    EnergySpotDepositor depositor_;
+  };
+}
+
+#endif
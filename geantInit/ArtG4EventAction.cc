@@ -11,6 +11,7 @@
 #include "artg4/services/ActionHolder_service.hh"
 #include "artg4/services/DetectorHolder_service.hh"
 #include "artg4/Core/DetectorBase.hh"
+#include "artg4/geantInit/ArtG4MemoryMonitor.hh"
 
 // Art
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -36,9 +37,14 @@ void artg4::ArtG4EventAction::BeginOfEventAction(const G4Event * currentEvent)
 // event and pass the call on to the action objects.
 void artg4::ArtG4EventAction::EndOfEventAction(const G4Event * currentEvent)
 {
+  // Tracking is over (see ArtG4MemoryMonitor.hh)
+  ArtG4MemoryMonitor & memoryMonitor = ArtG4MemoryMonitor::instance();
+  memoryMonitor.endPhase(kTrackPhase);
+
   // Convert geant hits to art for DETECTORS
   art::ServiceHandle<artg4::DetectorHolderService> dhs;
   dhs -> fillEventWithArtHits( currentEvent->GetHCofThisEvent() );
+  memoryMonitor.endPhase(kHitConversionPhase);
  
   // Run EndOfEventAction
   art::ServiceHandle<ActionHolderService> ahs;
@@ -48,4 +54,5 @@ void artg4::ArtG4EventAction::EndOfEventAction(const G4Event * currentEvent)
   // (do this within ArtG4EventAction) since some still need to be within
   // Geant
   ahs -> fillEventWithArtStuff();
+  memoryMonitor.endPhase(kArtPutPhase);
 }
@@ -0,0 +1,119 @@
+// Implementation of the per-event budget watchdog
+
+#include "artg4/geantInit/ArtG4EventWatchdog.hh"
+
+#include <sstream>
+
+#include "CLHEP/Random/Random.h"
+#include "CLHEP/Random/RandomEngine.h"
+
+#include "Geant4/G4RunManager.hh"
+
+artg4::ArtG4EventWatchdog& artg4::ArtG4EventWatchdog::instance() {
+  static ArtG4EventWatchdog watchdog;
+  return watchdog;
+}
+
+artg4::ArtG4EventWatchdog::ArtG4EventWatchdog() :
+  budget_(),
+  watching_(false),
+  eventNumber_(0),
+  nSteps_(0),
+  stepsUntilCheck_(0),
+  wallStart_(),
+  cpuStart_(0),
+  reason_(kNotAborted),
+  wallSeconds_(0),
+  cpuSeconds_(0),
+  engineName_(),
+  engineState_(),
+  runSummary_()
+{}
+
+void artg4::ArtG4EventWatchdog::beginRun() {
+  runSummary_ = EventAbortRunSummary();
+}
+
+void artg4::ArtG4EventWatchdog::beginEvent(int eventNumber) {
+  if ( ! enabled() ) return;
+
+  eventNumber_ = eventNumber;
+  nSteps_ = 0;
+  stepsUntilCheck_ = budget_.checkEvery;
+  reason_ = kNotAborted;
+  wallSeconds_ = 0;
+  cpuSeconds_ = 0;
+
+  // Remember where the random numbers started, in case this event has to
+  // be looked at again
+  CLHEP::HepRandomEngine* engine = CLHEP::HepRandom::getTheEngine();
+  std::ostringstream state;
+  engine->put(state);
+  engineName_ = engine->name();
+  engineState_ = state.str();
+
+  watching_ = true;
+  wallStart_ = std::chrono::steady_clock::now();
+  cpuStart_ = std::clock();
+}
+
+void artg4::ArtG4EventWatchdog::endEvent() {
+  if ( ! enabled() ) return;
+
+  if ( watching_ ) {
+    wallSeconds_ = std::chrono::duration<double>( std::chrono::steady_clock::now() - wallStart_ ).count();
+    cpuSeconds_ = double( std::clock() - cpuStart_ ) / CLOCKS_PER_SEC;
+    watching_ = false;
+  }
+
+  ++runSummary_.nEvents;
+  switch ( reason_ ) {
+    case kWallTimeExceeded: ++runSummary_.nWallTimeExceeded; break;
+    case kCPUTimeExceeded:  ++runSummary_.nCPUTimeExceeded;  break;
+    case kStepsExceeded:    ++runSummary_.nStepsExceeded;    break;
+    case kNotAborted: break;
+  }
+  if ( reason_ != kNotAborted ) runSummary_.abortedEvents.push_back(eventNumber_);
+}
+
+void artg4::ArtG4EventWatchdog::checkClocks() {
+  stepsUntilCheck_ = budget_.checkEvery;
+
+  if ( budget_.wallSeconds > 0 ) {
+    double wall = std::chrono::duration<double>( std::chrono::steady_clock::now() - wallStart_ ).count();
+    if ( wall > budget_.wallSeconds ) {
+      abortEvent(kWallTimeExceeded);
+      return;
+    }
+  }
+
+  if ( budget_.cpuSeconds > 0 ) {
+    double cpu = double( std::clock() - cpuStart_ ) / CLOCKS_PER_SEC;
+    if ( cpu > budget_.cpuSeconds ) abortEvent(kCPUTimeExceeded);
+  }
+}
+
+void artg4::ArtG4EventWatchdog::abortEvent(EventAbortReason reason) {
+  reason_ = reason;
+  wallSeconds_ = std::chrono::duration<double>( std::chrono::steady_clock::now() - wallStart_ ).count();
+  cpuSeconds_ = double( std::clock() - cpuStart_ ) / CLOCKS_PER_SEC;
+  watching_ = false;
+
+  // Kills the current track and clears the stack; the event then ends
+  // normally
+  G4RunManager::GetRunManager()->AbortEvent();
+}
+
+std::unique_ptr<artg4::EventAbortStatus> artg4::ArtG4EventWatchdog::eventStatus() const {
+  std::unique_ptr<EventAbortStatus> status( new EventAbortStatus );
+  status->aborted = reason_ != kNotAborted;
+  status->reason = reason_;
+  status->wallSeconds = wallSeconds_;
+  status->cpuSeconds = cpuSeconds_;
+  status->nSteps = nSteps_;
+  if ( status->aborted ) {
+    status->engineName = engineName_;
+    status->engineState = engineState_;
+  }
+  return status;
+}
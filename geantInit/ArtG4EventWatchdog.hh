@@ -0,0 +1,122 @@
+// Per-event budget watchdog
+//
+// One pathological event (electrons looping in a field, a stuck track) can
+// take hours and stall a whole grid job. The watchdog gives every event a
+// budget of wall time, CPU time and steps. @ArtG4RunManager@ starts it at
+// the beginning of each event and @ArtG4SteppingAction@ feeds it every
+// step; when the event goes over budget it has Geant abort the event
+// (@G4RunManager::AbortEvent@), which kills the current track and clears
+// the stack. The event then ends as usual, with what was simulated so far.
+//
+// The budget comes from the @eventBudget@ table of artg4Main's parameters:
+//
+//   eventBudget: {
+//     wallSeconds: 600   // 0 (the default) means no limit
+//     cpuSeconds: 600
+//     maxSteps: 50000000
+//     checkEvery: 1000   // steps between looks at the clocks
+//   }
+//
+// artg4Main then puts an @EventAbortStatus@ into every event and an
+// @EventAbortRunSummary@ into every run (see
+// @artg4/util/EventAbortStatus.hh@).
+
+#ifndef ARTG4EVENTWATCHDOG_HH
+#define ARTG4EVENTWATCHDOG_HH
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "artg4/util/EventAbortStatus.hh"
+
+namespace artg4 {
+
+  class ArtG4EventWatchdog {
+  public:
+
+    struct Budget {
+
+      // No limits
+      Budget() : wallSeconds(0), cpuSeconds(0), maxSteps(0), checkEvery(1000) {}
+
+      // From an @eventBudget@ table (see above)
+      explicit Budget(fhicl::ParameterSet const& p) :
+        wallSeconds( p.get<double>("wallSeconds", 0) ),
+        cpuSeconds( p.get<double>("cpuSeconds", 0) ),
+        maxSteps( p.get<unsigned long>("maxSteps", 0) ),
+        checkEvery( p.get<unsigned int>("checkEvery", 1000) )
+      {
+        if ( checkEvery == 0 ) checkEvery = 1;
+      }
+
+      bool enabled() const { return wallSeconds > 0 || cpuSeconds > 0 || maxSteps > 0; }
+
+      double wallSeconds;
+      double cpuSeconds;
+      unsigned long maxSteps;
+      unsigned int checkEvery;
+    };
+
+    // The one watchdog
+    static ArtG4EventWatchdog& instance();
+
+    void setBudget(Budget const& budget) { budget_ = budget; }
+    Budget const& budget() const { return budget_; }
+    bool enabled() const { return budget_.enabled(); }
+
+    // h3. Called by the run manager
+
+    void beginRun();
+    void beginEvent(int eventNumber);
+    void endEvent();
+
+    // h3. Called by the stepping action, every step
+
+    void step() {
+      if ( ! watching_ ) return;
+      ++nSteps_;
+      if ( budget_.maxSteps > 0 && nSteps_ > budget_.maxSteps ) abortEvent(kStepsExceeded);
+      else if ( --stepsUntilCheck_ == 0 ) checkClocks();
+    }
+
+    // h3. Results
+
+    // The status of the event just processed
+    std::unique_ptr<EventAbortStatus> eventStatus() const;
+
+    // The aborts of this run so far
+    EventAbortRunSummary const& runSummary() const { return runSummary_; }
+
+  private:
+
+    ArtG4EventWatchdog();
+    ArtG4EventWatchdog(ArtG4EventWatchdog const&);
+    ArtG4EventWatchdog& operator=(ArtG4EventWatchdog const&);
+
+    void checkClocks();
+    void abortEvent(EventAbortReason reason);
+
+    Budget budget_;
+
+    // The current event
+    bool watching_;
+    int eventNumber_;
+    unsigned long nSteps_;
+    unsigned int stepsUntilCheck_;
+    std::chrono::steady_clock::time_point wallStart_;
+    std::clock_t cpuStart_;
+    EventAbortReason reason_;
+    double wallSeconds_;
+    double cpuSeconds_;
+    std::string engineName_;
+    std::string engineState_;
+
+    EventAbortRunSummary runSummary_;
+  };
+}
+
+#endif
@@ -0,0 +1,159 @@
+// Implementation of the per-event memory monitor
+
+#include "artg4/geantInit/ArtG4MemoryMonitor.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+  double megabytes(long long bytes) { return bytes / ( 1024. * 1024. ); }
+}
+
+artg4::ArtG4MemoryMonitor& artg4::ArtG4MemoryMonitor::instance() {
+  static ArtG4MemoryMonitor monitor;
+  return monitor;
+}
+
+artg4::ArtG4MemoryMonitor::ArtG4MemoryMonitor() :
+  settings_(),
+  watching_(false),
+  eventNumber_(0),
+  last_(),
+  rssDelta_(),
+  heapDelta_(),
+  havePrevious_(false),
+  previousAtEnd_(0),
+  growth_(0),
+  flaggedThisEvent_(false),
+  runSummary_()
+{}
+
+artg4::ArtG4MemoryMonitor::Sample artg4::ArtG4MemoryMonitor::sample() {
+  Sample s = { 0, 0 };
+
+#ifdef __linux__
+  if ( std::FILE* statm = std::fopen("/proc/self/statm", "r") ) {
+    long pages = 0;
+    if ( std::fscanf(statm, "%*s %ld", &pages) == 1 ) s.rss = static_cast<long long>(pages) * sysconf(_SC_PAGESIZE);
+    std::fclose(statm);
+  }
+#endif
+
+  // In use: small chunks from the arenas plus large ones mapped on their own
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+  struct mallinfo2 info = mallinfo2();
+  s.heap = static_cast<long long>(info.uordblks) + static_cast<long long>(info.hblkhd);
+#else
+  // The fields are ints; read them as unsigned to get up to 4 GB
+  struct mallinfo info = mallinfo();
+  s.heap = static_cast<long long>( static_cast<unsigned int>(info.uordblks) ) +
+           static_cast<long long>( static_cast<unsigned int>(info.hblkhd) );
+#endif
+#endif
+
+  return s;
+}
+
+void artg4::ArtG4MemoryMonitor::beginRun() {
+  runSummary_ = MemoryRunSummary();
+  havePrevious_ = false;
+  growth_ = 0;
+}
+
+void artg4::ArtG4MemoryMonitor::beginEvent(int eventNumber) {
+  if ( ! enabled() ) return;
+
+  eventNumber_ = eventNumber;
+  std::fill( rssDelta_, rssDelta_ + kNMemoryPhases, 0 );
+  std::fill( heapDelta_, heapDelta_ + kNMemoryPhases, 0 );
+  flaggedThisEvent_ = false;
+  watching_ = true;
+  last_ = sample();
+}
+
+void artg4::ArtG4MemoryMonitor::endPhase(MemoryPhase phase) {
+  if ( ! watching_ ) return;
+
+  Sample now = sample();
+  rssDelta_[phase] += now.rss - last_.rss;
+  heapDelta_[phase] += now.heap - last_.heap;
+  last_ = now;
+}
+
+void artg4::ArtG4MemoryMonitor::endEvent() {
+  if ( ! watching_ ) return;
+  endPhase(kCleanupPhase);
+  watching_ = false;
+
+  runSummary_.event.push_back(eventNumber_);
+  runSummary_.rssAtEnd.push_back(last_.rss);
+  runSummary_.heapAtEnd.push_back(last_.heap);
+  runSummary_.rssDelta.insert( runSummary_.rssDelta.end(), rssDelta_, rssDelta_ + kNMemoryPhases );
+  runSummary_.heapDelta.insert( runSummary_.heapDelta.end(), heapDelta_, heapDelta_ + kNMemoryPhases );
+
+  // ru_maxrss is in kilobytes on Linux
+  struct rusage usage;
+  if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+    runSummary_.peakRss = std::max( runSummary_.peakRss, static_cast<long long>(usage.ru_maxrss) * 1024 );
+  }
+
+  // The heap is exact to the byte; the RSS moves in pages and is only the
+  // fallback
+  long long atEnd = last_.heap > 0 ? last_.heap : last_.rss;
+  growth_ = ( havePrevious_ && atEnd > previousAtEnd_ ) ? growth_ + 1 : 0;
+  havePrevious_ = true;
+  previousAtEnd_ = atEnd;
+  runSummary_.longestGrowth = std::max(runSummary_.longestGrowth, growth_);
+
+  if ( settings_.growthEvents > 0 && growth_ == settings_.growthEvents ) {
+    flaggedThisEvent_ = true;
+    runSummary_.growthFlagged = true;
+  }
+}
+
+void artg4::ArtG4MemoryMonitor::describeEvent(std::ostream & os) const {
+  std::size_t i = runSummary_.nEvents();
+  if ( i == 0 ) return;
+  --i;
+
+  os << "Memory after event " << runSummary_.event[i] << ": RSS " << megabytes(runSummary_.rssAtEnd[i])
+     << " MB, heap " << megabytes(runSummary_.heapAtEnd[i]) << " MB; change by phase (RSS/heap, MB):";
+  for ( int p = 0; p < kNMemoryPhases; ++p ) {
+    MemoryPhase phase = static_cast<MemoryPhase>(p);
+    os << " " << MemoryRunSummary::phaseName(phase) << " " << megabytes( runSummary_.rssDeltaOf(i, phase) )
+       << "/" << megabytes( runSummary_.heapDeltaOf(i, phase) );
+  }
+}
+
+void artg4::ArtG4MemoryMonitor::describeGrowth(std::ostream & os) const {
+  std::size_t n = runSummary_.nEvents();
+  if ( n == 0 ) return;
+
+  // Over the events of the streak, and the one before it
+  std::size_t first = n - std::min<std::size_t>(growth_ + 1, n);
+  bool useHeap = runSummary_.heapAtEnd.back() > 0;
+  std::vector<long long> const& atEnd = useHeap ? runSummary_.heapAtEnd : runSummary_.rssAtEnd;
+
+  os << ( useHeap ? "Heap" : "RSS" ) << " left at the end of events has grown for " << growth_
+     << " events in a row, by " << megabytes( atEnd.back() - atEnd[first] ) << " MB (to "
+     << megabytes( atEnd.back() ) << " MB). Growth by phase (MB):";
+  for ( int p = 0; p < kNMemoryPhases; ++p ) {
+    MemoryPhase phase = static_cast<MemoryPhase>(p);
+    long long total = 0;
+    for ( std::size_t i = first + 1; i < n; ++i ) {
+      total += useHeap ? runSummary_.heapDeltaOf(i, phase) : runSummary_.rssDeltaOf(i, phase);
+    }
+    os << " " << MemoryRunSummary::phaseName(phase) << " " << megabytes(total);
+  }
+}
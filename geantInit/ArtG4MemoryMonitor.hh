@@ -0,0 +1,122 @@
+// Per-event memory monitor
+//
+// A long production job can grow until the batch system kills it, and it
+// is hard to tell afterwards whether Geant, the hits or an action was
+// responsible. The monitor samples the resident set size (RSS, from
+// /proc/self/statm) and the heap in use (from the allocator's statistics)
+// at the start of each event and at the end of each of its phases (see
+// @MemoryPhase@ in @artg4/util/MemoryRunSummary.hh@). @ArtG4RunManager@
+// starts and ends each event and marks the end of generation;
+// @ArtG4EventAction@ marks the others.
+//
+// It is switched on by the @memoryMonitor@ table of artg4Main's
+// parameters:
+//
+//   memoryMonitor: {
+//     enabled: true
+//     growthEvents: 20    // warn when the heap has grown over this many events in a row; 0 never
+//     logEvents: false    // log every event's phases
+//   }
+//
+// artg4Main then puts a @MemoryRunSummary@ into every run, and warns when
+// the memory left at the end of events has grown for @growthEvents@ events
+// in a row, naming the phases that grew most. Where the allocator has no
+// statistics (not glibc), the RSS is used instead.
+//
+// Sampling costs a read of /proc and a walk over the allocator's bins, a
+// few times an event.
+
+#ifndef ARTG4MEMORYMONITOR_HH
+#define ARTG4MEMORYMONITOR_HH
+
+#include <ostream>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "artg4/util/MemoryRunSummary.hh"
+
+namespace artg4 {
+
+  class ArtG4MemoryMonitor {
+  public:
+
+    struct Settings {
+
+      // Off
+      Settings() : enabled(false), growthEvents(20), logEvents(false) {}
+
+      // From a @memoryMonitor@ table (see above)
+      explicit Settings(fhicl::ParameterSet const& p) :
+        enabled( p.get<bool>("enabled", false) ),
+        growthEvents( p.get<unsigned int>("growthEvents", 20) ),
+        logEvents( p.get<bool>("logEvents", false) )
+      {}
+
+      bool enabled;
+      unsigned int growthEvents;
+      bool logEvents;
+    };
+
+    // The one monitor
+    static ArtG4MemoryMonitor& instance();
+
+    void setSettings(Settings const& settings) { settings_ = settings; }
+    Settings const& settings() const { return settings_; }
+    bool enabled() const { return settings_.enabled; }
+
+    // h3. Called by the run manager and the event action
+
+    void beginRun();
+    void beginEvent(int eventNumber);
+
+    // The given phase is over (all but the last, which endEvent ends)
+    void endPhase(MemoryPhase phase);
+
+    void endEvent();
+
+    // h3. Results
+
+    // The events of this run so far
+    MemoryRunSummary const& runSummary() const { return runSummary_; }
+
+    // Whether the last event made the growth streak reach growthEvents
+    bool growthFlaggedThisEvent() const { return flaggedThisEvent_; }
+
+    // Describe the last event's phases, and the growth over the current
+    // streak, for the log
+    void describeEvent(std::ostream & os) const;
+    void describeGrowth(std::ostream & os) const;
+
+  private:
+
+    ArtG4MemoryMonitor();
+    ArtG4MemoryMonitor(ArtG4MemoryMonitor const&);
+    ArtG4MemoryMonitor& operator=(ArtG4MemoryMonitor const&);
+
+    struct Sample {
+      long long rss;
+      long long heap;
+    };
+
+    static Sample sample();
+
+    Settings settings_;
+
+    // The current event
+    bool watching_;
+    int eventNumber_;
+    Sample last_;
+    long long rssDelta_[kNMemoryPhases];
+    long long heapDelta_[kNMemoryPhases];
+
+    // Growth of what is left at the end of events
+    bool havePrevious_;
+    long long previousAtEnd_;
+    unsigned int growth_;
+    bool flaggedThisEvent_;
+
+    MemoryRunSummary runSummary_;
+  };
+}
+
+#endif
@@ -14,12 +14,16 @@
 
 // ArtG4 includes.
 #include "artg4/geantInit/ArtG4RunManager.hh"
+#include "artg4/util/EventArena.hh"
+#include "artg4/geantInit/ArtG4EventWatchdog.hh"
+#include "artg4/geantInit/ArtG4MemoryMonitor.hh"
 
 // Includes from G4.
 #include "Geant4/G4UImanager.hh"
 #include "Geant4/G4ScoringManager.hh"
 #include "Geant4/G4Timer.hh"
 #include "Geant4/G4Run.hh"
+#include "Geant4/G4Event.hh"
 
 using namespace std;
 
@@ -35,7 +39,8 @@ namespace artg4 {
   realElapsed_(0.),
   systemElapsed_(0.),
   userElapsed_(0.),
-  msg_(""){
+  msg_(""),
+  arenaHeldByKeptEvents_(false){
   }
   
   // Destructor of base is called automatically.  No need to do anything.
@@ -73,6 +78,18 @@ namespace artg4 {
     numberOfEventToBeProcessed = 1;
     ConstructScoringWorlds();
     RunInitialization();
+
+    ArtG4EventWatchdog::instance().beginRun();
+    ArtG4MemoryMonitor::instance().beginRun();
+  }
+  
+  // The kernel's part of RunInitialization (physics tables and geometry
+  // optimization), leaving Geant idle. No G4Run is made and no run action
+  // is called.
+  void ArtG4RunManager::InitializePhysicsTables(){
+    if ( ! ConfirmBeamOnCondition() ) return;
+    ConstructScoringWorlds();
+    if ( kernel->RunInitialization() ) kernel->RunTermination();
   }
   
   // Do the "per event" part of DoEventLoop.
@@ -80,9 +97,19 @@ namespace artg4 {
     
     timer->Start();
     
+    // The watchdog may abort the event if it goes over budget
+    ArtG4EventWatchdog & watchdog = ArtG4EventWatchdog::instance();
+    watchdog.beginEvent(eventNumber);
+    
+    // The other phases are marked by ArtG4EventAction
+    ArtG4MemoryMonitor & memoryMonitor = ArtG4MemoryMonitor::instance();
+    memoryMonitor.beginEvent(eventNumber);
+    
     // This is the body of the event loop from DoEventLoop().
     currentEvent = GenerateEvent(eventNumber);
+    memoryMonitor.endPhase(kGeneratePhase);
     eventManager->ProcessOneEvent(currentEvent);
+    watchdog.endEvent();
     AnalyzeEvent(currentEvent);
     UpdateScoring();
     
@@ -120,9 +147,21 @@ namespace artg4 {
   
   void ArtG4RunManager::BeamOnEndEvent(){
     
+    // Hits in the event arena (see artg4/util/EventArena.hh) die with the
+    // G4Event, which StackPreviousEvent deletes unless Geant was asked to
+    // keep it. Kept events live until the end of the run, and so must the
+    // arena.
+    bool eventKept = n_perviousEventsToBeKept > 0 || ( currentEvent && currentEvent->ToBeKept() );
+    
     StackPreviousEvent(currentEvent);
     currentEvent = 0;
     
+    if ( eventKept ) arenaHeldByKeptEvents_ = true;
+    if ( ! arenaHeldByKeptEvents_ ) EventArena::instance().reset();
+    
+    // What is left now stays into the next event
+    ArtG4MemoryMonitor::instance().endEvent();
+    
     ++nProcessed_;
   }
   
@@ -138,6 +177,9 @@ namespace artg4 {
       { G4cout << "  G4Run Aborted after " << nProcessed_ << " events processed." << G4endl; }
       else
       { G4cout << "  Number of events processed : " << nProcessed_ << G4endl; }
+      if ( ArtG4EventWatchdog::instance().enabled() )
+      { G4cout << "  Events aborted over budget : "
+               << ArtG4EventWatchdog::instance().runSummary().nAborted() << G4endl; }
       G4cout << "  User="  << userElapsed_
       << "s Real="  << realElapsed_
       << "s Sys="   << systemElapsed_
@@ -159,6 +201,10 @@ namespace artg4 {
     
     // From G4RunManager::BeamOn.
     RunTermination();
+    
+    // Any kept events have now been deleted
+    EventArena::instance().reset();
+    arenaHeldByKeptEvents_ = false;
   }
   
 } // end namespace artg4
@@ -44,6 +44,11 @@ namespace artg4 {
     virtual void BeamOnDoOneEvent( int eventNumber );
     virtual void BeamOnEndEvent();
     virtual void BeamOnEndRun();
+
+    // Build (or retrieve) the physics tables and close the geometry without
+    // starting a run, e.g. so that forked workers share them. The first
+    // BeamOnBeginRun then finds nothing left to build.
+    void InitializePhysicsTables();
     
     
     // ArtG4 specific accessors.
@@ -88,6 +93,11 @@ namespace artg4 {
     // The command that executes the macro file.
     G4String msg_;
     
+    // True once an event of this run has been kept by Geant beyond the end
+    // of the event; the event arena may then only be reset at the end of
+    // the run.
+    bool arenaHeldByKeptEvents_;
+    
   };
   
 } // end namespace artg4.
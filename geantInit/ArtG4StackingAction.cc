@@ -13,6 +13,10 @@
 // Art
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 
+// Geant
+#include "Geant4/G4RunManager.hh"
+#include "Geant4/G4StackManager.hh"
+
 
 // Called at the end of each step
 G4ClassificationOfNewTrack artg4::ArtG4StackingAction::ClassifyNewTrack(const G4Track * currTrack)
@@ -27,6 +31,44 @@ G4ClassificationOfNewTrack artg4::ArtG4StackingAction::ClassifyNewTrack(const G4
   if ( killTrack ) {
     trackDisposition = fKill;
   }
+  else if ( actionHolder -> deferNewTrack(currTrack) ) {
+    trackDisposition = fWaiting;
+  }
   
   return trackDisposition;
 }
+
+// Called when a stage is done
+void artg4::ArtG4StackingAction::NewStage()
+{
+  // Geant has already moved the waiting tracks to the urgent stack. It also
+  // calls this after the last track of the event, with nothing left to
+  // track; the event is complete then and there is no stage to abort.
+  if ( stackManager -> GetNUrgentTrack() + stackManager -> GetNWaitingTrack() == 0 ) {
+    return;
+  }
+
+  art::ServiceHandle<ActionHolderService> actionHolder;
+
+  if ( actionHolder -> endOfStage() ) {
+    // Also clears the stacks
+    G4RunManager::GetRunManager() -> AbortEvent();
+    return;
+  }
+
+  // Let the actions see the deferred tracks again, in case they want to put
+  // some off further.
+  stackManager -> ReClassify();
+
+  // If everything was put off again, nothing would ever be tracked
+  if ( stackManager -> GetNUrgentTrack() == 0 ) {
+    stackManager -> TransferStackedTracks(fWaiting, fUrgent);
+  }
+}
+
+// Called at the start of each event
+void artg4::ArtG4StackingAction::PrepareNewEvent()
+{
+  art::ServiceHandle<ActionHolderService> actionHolder;
+  actionHolder -> prepareNewEvent();
+}
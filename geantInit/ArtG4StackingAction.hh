@@ -24,8 +24,16 @@ namespace artg4 {
     // Compiler-generated constructor, destructor, copy constructor, and 
     // equality operator are okay here.
     
-    // Called for each new track
+    // Called for each new track, and again for deferred tracks at the
+    // start of each stage
     G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track *);
+
+    // Called when the urgent stack is empty: the end of a stage (see
+    // StackingActionBase.hh). Aborts the event or starts the next stage.
+    void NewStage();
+
+    // Called at the start of each event
+    void PrepareNewEvent();
   };
 
 }
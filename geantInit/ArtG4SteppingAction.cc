@@ -9,6 +9,7 @@
 
 // Other local includes
 #include "artg4/services/ActionHolder_service.hh"
+#include "artg4/geantInit/ArtG4EventWatchdog.hh"
 
 // Art
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -17,6 +18,9 @@
 // Called at the end of each step
 void artg4::ArtG4SteppingAction::UserSteppingAction(const G4Step * currentStep)
 {
+  // Keep an eye on the event's budget
+  ArtG4EventWatchdog::instance().step();
+
   // Get the action holder service
   art::ServiceHandle<ActionHolderService> actionHolder;
   
@@ -11,9 +11,15 @@
     http://www.efunda.com/materials/materials_home/materials.cfm 
 
     There's a static initialization issue with trying to get a file
-    scope pointer to the NistManager.  The static initialization in
-    these implementations works, though.  So don't think about
-    changing it, or you'll end up back in the crashing regime.
+    scope pointer to the NistManager.  So nothing here touches Geant
+    at static initialization time: the registries at the bottom of
+    this file are function-local statics that only record builder
+    functions, and each material or surface is built the first time
+    somebody asks for it.
+
+    Building is serialized with a single lock because Geant's material
+    table, surface table and NIST manager are not thread safe. Once an
+    object is built, looking it up again does not take the lock.
    
     @author Zach Hartwig
     @author Kevin Lynch
@@ -27,146 +33,123 @@
 
 #include "artg4/material/Materials.hh"
 
-#include <tr1/functional>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 
 
+// The builders below construct each material or surface exactly once. They
+// are only ever called through the registry at the bottom of this file, which
+// serializes construction and caches the result.
+namespace {
+
+// Optical materials and surfaces fetch their properties table through this
+// rather than building it inline, so that a table loaded from the optical
+// cache (see OpticalCache.hh) is used when one was installed.
+G4MaterialPropertiesTable *propertiesTable(std::string const& ownerName);
+
 //====================================================================//
 //===========================   ELEMENTS  ============================//
 //====================================================================//
 
-G4Material *artg4Materials::Al()
+G4Material *buildAl()
 {
-  static G4Material *Al = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Al");
-  return Al;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Al");
 }
 
-G4Material *artg4Materials::Ar()
+G4Material *buildAr()
 {
-  static G4Material *Ar =
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Ar");
-  return Ar;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Ar");
 }
 
-G4Material *artg4Materials::Be()
+G4Material *buildBe()
 {
-  static G4Material *Be =
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Be");
-  return Be;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Be");
 }
 
-G4Material *artg4Materials::C()
+G4Material *buildC()
 {
-  static G4Material *C = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_C");
-  return C;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_C");
 }
 
-G4Material *artg4Materials::Cr()
+G4Material *buildCr()
 {
-  static G4Material *Cr = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Cr");
-  return Cr;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Cr");
 }
 
-G4Material *artg4Materials::Cu()
+G4Material *buildCu()
 {
-  static G4Material *Cu = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Cu");
-  return Cu;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Cu");
 }
 
-G4Material *artg4Materials::F()
+G4Material *buildF()
 {
-  static G4Material *F = 
-     G4NistManager::Instance()->FindOrBuildMaterial("G4_F");
-  return F;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_F");
 }
 
-G4Material *artg4Materials::Fe()
+G4Material *buildFe()
 {
-  static G4Material *Fe = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Fe");
-  return Fe;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Fe");
 }
 
-G4Material *artg4Materials::H()
+G4Material *buildH()
 {
-  static G4Material *H = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_H");
-  return H;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_H");
 }
 
-G4Material *artg4Materials::Mg()
+G4Material *buildMg()
 {
-  static G4Material *Mg = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Mg");
-  return Mg;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Mg");
 }
 
-G4Material *artg4Materials::N()
+G4Material *buildN()
 {
-  static G4Material *N = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_N");
-  return N;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_N");
 }
 
-G4Material *artg4Materials::Nb()
+G4Material *buildNb()
 {
-  static G4Material *Nb = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Nb");
-  return Nb;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Nb");
 }
 
-G4Material *artg4Materials::O()
+G4Material *buildO()
 {
-  static G4Material *O = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_O");
-  return O;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_O");
 }
 
-G4Material *artg4Materials::Pb()
+G4Material *buildPb()
 {
-  static G4Material *Pb = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Pb");
-  return Pb;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Pb");
 }
 
-G4Material *artg4Materials::Sb()
+G4Material *buildSb()
 {
-  static G4Material *Sb = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Sb");
-  return Sb;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Sb");
 }
 
-G4Material *artg4Materials::Si()
+G4Material *buildSi()
 {
-  static G4Material *Si = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Si");
-  return Si;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Si");
 }
 
-G4Material *artg4Materials::Ti()
+G4Material *buildTi()
 {
-  static G4Material* Ti = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Ti");
-  return Ti;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Ti");
 }
 
-G4Material *artg4Materials::W()
+G4Material *buildW()
 {
-  static G4Material *W = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_W");
-  return W;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_W");
 }
 
-G4Material *artg4Materials::Zn()
+G4Material *buildZn()
 {
-  static G4Material *Zn = 
-    G4NistManager::Instance()->FindOrBuildMaterial("G4_Zn");
-  return Zn;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_Zn");
 }
 
 
@@ -174,197 +157,153 @@ G4Material *artg4Materials::Zn()
 //===========================   COMPOUNDS   ==========================//
 //====================================================================//
 
-G4Material *artg4Materials::CO2()
+G4Material *buildCO2()
 {
-  static G4Material *CO2 = G4NistManager::Instance()->FindOrBuildMaterial("G4_CARBON_DIOXIDE");
-  return CO2;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_CARBON_DIOXIDE");
 }
 
-G4Material *artg4Materials::C2H4()
+G4Material *buildC2H4()
 {
-  static G4Material *C2H4 = G4NistManager::Instance()->FindOrBuildMaterial("G4_POLYETHYLENE");
-  return C2H4;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_POLYETHYLENE");
 }
 
-G4Material *artg4Materials::SiO2()
+G4Material *buildSiO2()
 {
-  static G4Material *SiO2 = G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE");
-  return SiO2;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE");
 }
 
-G4Material *artg4Materials::Air()
+G4Material *buildAir()
 {
-  static G4Material *Air = G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
-  return Air;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
 }
 
 
-G4Material *artg4Materials::Al5052() // quad inner/outer electordes
+G4Material *buildAl5052() // quad inner/outer electordes
 {
-  static G4Material *Al5052 = new G4Material( "AluminumAlloy5052-H34", 2.68*g/cm3, 3 );
-  static bool init = true;
-  if( init ){
-    Al5052->AddMaterial(artg4Materials::Mg(), 2.50*perCent); //z=12
-    Al5052->AddMaterial(artg4Materials::Al(),97.25*perCent); //z=13
-    Al5052->AddMaterial(artg4Materials::Si(), 0.25*perCent); //z=14
-    init = false;
-  }
+  G4Material *Al5052 = new G4Material( "AluminumAlloy5052-H34", 2.68*g/cm3, 3 );
+  Al5052->AddMaterial(artg4Materials::Mg(), 2.50*perCent); //z=12
+  Al5052->AddMaterial(artg4Materials::Al(),97.25*perCent); //z=13
+  Al5052->AddMaterial(artg4Materials::Si(), 0.25*perCent); //z=14
   return Al5052;
 }
 
 
-G4Material *artg4Materials::Al6061() // inflector mandrel, quad upper/lower electrodes, etc.
+G4Material *buildAl6061() // inflector mandrel, quad upper/lower electrodes, etc.
 {
-  static G4Material *Al6061 = new G4Material( "AluminumAlloy6061-T6", 2.70*g/cm3, 5 );
-  static bool init = true;
-  if( init ){
-    Al6061->AddMaterial(artg4Materials::Mg(), 1.00*perCent); // z=12
-    Al6061->AddMaterial(artg4Materials::Al(),97.92*perCent); // z=13
-    Al6061->AddMaterial(artg4Materials::Si(), 0.60*perCent); // z=14
-    Al6061->AddMaterial(artg4Materials::Cr(), 0.20*perCent); // z=24
-    Al6061->AddMaterial(artg4Materials::Cu(), 0.28*perCent); // z=29
-    init = false;
-  }    
+  G4Material *Al6061 = new G4Material( "AluminumAlloy6061-T6", 2.70*g/cm3, 5 );
+  Al6061->AddMaterial(artg4Materials::Mg(), 1.00*perCent); // z=12
+  Al6061->AddMaterial(artg4Materials::Al(),97.92*perCent); // z=13
+  Al6061->AddMaterial(artg4Materials::Si(), 0.60*perCent); // z=14
+  Al6061->AddMaterial(artg4Materials::Cr(), 0.20*perCent); // z=24
+  Al6061->AddMaterial(artg4Materials::Cu(), 0.28*perCent); // z=29
   return Al6061;
 }
 
-G4Material *artg4Materials::FakeStrawElectronics(){
-  static G4Material *FakeStrawElectronics = new G4Material("FakeStrawElectronics", 0.508 *g/cm3,4);
+G4Material *buildFakeStrawElectronics(){
+  G4Material *FakeStrawElectronics = new G4Material("FakeStrawElectronics", 0.508 *g/cm3,4);
 
-  static bool init = true;
-  if( init ){
   FakeStrawElectronics->AddMaterial(artg4Materials::Ar(), 75.1*perCent);
   FakeStrawElectronics->AddMaterial(artg4Materials::C(), 6.5*perCent);
   FakeStrawElectronics->AddMaterial(artg4Materials::C2H4(), 6.4*perCent);
   FakeStrawElectronics->AddMaterial(artg4Materials::SiO2(), 12.0*perCent);
 
-  init = false;
-  }
   return FakeStrawElectronics;
 
 }
 
-G4Material *artg4Materials::ArCO2(){
-  static G4Material *ArCO2 = new G4Material("ArgonCO2", 0.0018*g/cm3 ,2);
+G4Material *buildArCO2(){
+  G4Material *ArCO2 = new G4Material("ArgonCO2", 0.0018*g/cm3 ,2);
   
-  static bool init = true;
-  if (init){
-    ArCO2->AddMaterial(artg4Materials::Ar(), 80*perCent);
-    ArCO2->AddMaterial(artg4Materials::CO2(), 20*perCent);
-    init = false;
-  }
+  ArCO2->AddMaterial(artg4Materials::Ar(), 80*perCent);
+  ArCO2->AddMaterial(artg4Materials::CO2(), 20*perCent);
   
   return ArCO2;
 }
 
-namespace{ 
-  G4Material *Scintillator(G4String name, 
-			   G4double density, G4double HCratio){
-    G4Material *scint = new G4Material(name, density, 2);
-    
-    G4double const aH = artg4Materials::H()->GetA();
-    G4double const aC = artg4Materials::C()->GetA();
-    G4double const Hweight = HCratio*aH/(HCratio*aH + aC);
-    scint->AddMaterial(artg4Materials::H(), Hweight);
-    scint->AddMaterial(artg4Materials::C(), 1.-Hweight);
+G4Material *Scintillator(G4String name, 
+                         G4double density, G4double HCratio){
+  G4Material *scint = new G4Material(name, density, 2);
+  
+  G4double const aH = artg4Materials::H()->GetA();
+  G4double const aC = artg4Materials::C()->GetA();
+  G4double const Hweight = HCratio*aH/(HCratio*aH + aC);
+  scint->AddMaterial(artg4Materials::H(), Hweight);
+  scint->AddMaterial(artg4Materials::C(), 1.-Hweight);
 
-    return scint;
-  }
+  return scint;
+}
+ 
+G4Material *buildBC404Scintillator(){
+  return Scintillator("BC404Scintillator", 1.032*g/cm3, 1.1);
 }
  
-G4Material *artg4Materials::BC404Scintillator(){
-  static bool init = true;
-  static G4Material *BC404 = 0;
+G4Material *buildBC408Scintillator(){
+  return Scintillator("BC408Scintillator", 1.032*g/cm3, 1.104);
+}
 
-  if( init )
-    BC404 = Scintillator("BC404Scintillator", 1.032*g/cm3, 1.1);
+G4Material *buildBCF10ScintFiber(){
+  return Scintillator("BCF10ScintFiber", 1.05*g/cm3, 4.82/4.85);
+}
 
-  return BC404;
+
+G4MaterialPropertiesTable *buildBicronBC630Properties()
+{
+  // Material Properties table
+  const G4int nEntries = 5 ;
+
+  // Transmission coefficients from bicron datasheet: assume 100 micron thickness
+
+  // Order from low energy to high energy (required for Geant 4.9.5)
+  G4double wavelengths[ nEntries ] = { 950.*nm, 700.*nm, 280.*nm, 270.*nm, 200.*nm };
+  G4double transmission[ nEntries ] = { 0.95, 0.95, 0.95, 0., 0. } ;
+
+  G4double photonEnergy[ nEntries ] ;
+  G4double refractiveIndex[ nEntries ] ;
+  G4double absorptionLength[ nEntries ] ;
+
+  for( int i = 0 ; i < nEntries ; ++i )
+  {
+      photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
+      refractiveIndex[ i ] = 1.465 ; // actual index of Bicron BC630
+      absorptionLength[ i ] = -0.1*mm / log( transmission[ i ] ) ;
+  }
+
+  // Geant 4.9.5 Material properties table: photonEnergy must be in order
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries ) ;
+
+  return table;
 }
- 
-G4Material *artg4Materials::BC408Scintillator(){
-  static bool init = true;
-  static G4Material *BC408 = 0;
-
-  if( init )
-    BC408 = Scintillator("BC408Scintillator", 1.032*g/cm3, 1.104);
-
-  return BC408;
-}
-
-G4Material *artg4Materials::BCF10ScintFiber(){
-  static bool init = true;
-  static G4Material *BCF10 = 0;
-
-  if( init )
-    BCF10 = Scintillator("BCF10ScintFiber", 1.05*g/cm3, 4.82/4.85);
-
-  return BCF10;
-}
-
-
-G4Material* artg4Materials::BicronBC630()
-{
-   static bool init = true;
-   static G4Material *bicronBC630;
-
-   if( init ){
-
-      G4NistManager* nistMan = G4NistManager::Instance();
-      std::vector<G4int> natoms;
-      std::vector<G4double> fractionMass;
-      std::vector<G4String> elements;
-
-       //--------------------------------------------------
-       // Silicone (Template for Optical Grease)
-       //--------------------------------------------------
-       
-       elements.push_back("C");     natoms.push_back(2);
-       elements.push_back("H");     natoms.push_back(6);
-       double density = 1.060*g/cm3;
-       
-       bicronBC630 = nistMan->
-       ConstructNewMaterial("BicronBC630", elements, natoms, density);
-       
-       // Material Properties table
-       const G4int nEntries = 5 ;
-       
-       // Transmission coefficients from bicron datasheet: assume 100 micron thickness
-       
-       // Order from low energy to high energy (required for Geant 4.9.5)
-       G4double wavelengths[ nEntries ] = { 950.*nm, 700.*nm, 280.*nm, 270.*nm, 200.*nm };
-       G4double transmission[ nEntries ] = { 0.95, 0.95, 0.95, 0., 0. } ;
-       
-       G4double photonEnergy[ nEntries ] ;
-       G4double refractiveIndex[ nEntries ] ;
-       G4double absorptionLength[ nEntries ] ;
-       
-       for( int i = 0 ; i < nEntries ; ++i )
-       {
-           photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
-           refractiveIndex[ i ] = 1.465 ; // actual index of Bicron BC630
-           absorptionLength[ i ] = -0.1*mm / log( transmission[ i ] ) ;
-       }
-       
-       // Geant 4.9.5 Material properties table: photonEnergy must be in order
-       G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-       table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
-       table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries ) ;
-       
-       bicronBC630->SetMaterialPropertiesTable( table ) ;
-       
-       init = false;
-   }
-    
+
+
+G4Material *buildBicronBC630()
+{
+   G4Material *bicronBC630;
+
+   G4NistManager* nistMan = G4NistManager::Instance();
+   std::vector<G4int> natoms;
+   std::vector<G4double> fractionMass;
+   std::vector<G4String> elements;
+
+    //--------------------------------------------------
+    // Silicone (Template for Optical Grease)
+    //--------------------------------------------------
+
+    elements.push_back("C");     natoms.push_back(2);
+    elements.push_back("H");     natoms.push_back(6);
+    double density = 1.060*g/cm3;
+
+    bicronBC630 = nistMan->
+    ConstructNewMaterial("BicronBC630", elements, natoms, density);
+    bicronBC630->SetMaterialPropertiesTable( propertiesTable("BicronBC630") );
+
     return bicronBC630;
 }
 
 
-G4Material* artg4Materials::Borosilicate() // aka, pyrex
+G4MaterialPropertiesTable *buildBorosilicateProperties()
 {
-  static G4Material *pyrex = 
-     G4NistManager::Instance()->FindOrBuildMaterial("G4_Pyrex_Glass");
-
   // http://hypernews.slac.stanford.edu/HyperNews/geant4/get/opticalphotons/299.html
   const G4int num = 2 ;
   G4MaterialPropertiesTable* myPyrexWindow = new G4MaterialPropertiesTable();
@@ -376,186 +315,172 @@ G4Material* artg4Materials::Borosilicate() // aka, pyrex
   G4double pyrexPhotonRefractiveIndex[num] = {1.51 , 1.51};
   myPyrexWindow->AddProperty("RINDEX",pyrexPhotonRefractiveIndexNRG,
 			      pyrexPhotonRefractiveIndex,num);
-  pyrex->SetMaterialPropertiesTable(myPyrexWindow);
+
+  return myPyrexWindow;
+}
+
+
+G4Material *buildBorosilicate() // aka, pyrex
+{
+  G4Material *pyrex = 
+     G4NistManager::Instance()->FindOrBuildMaterial("G4_Pyrex_Glass");
+  pyrex->SetMaterialPropertiesTable( propertiesTable("Borosilicate") );
 
   return pyrex;
 }
 
 
-G4Material *artg4Materials::Brass() // E821 quad support bolts
+G4Material *buildBrass() // E821 quad support bolts
 {
   //  http://webmineral.com/data/Brass.shtml, http://www.engineeringtoolbox.com/metal-alloys-densities-d_50.html
-  static G4Material *Brass = new G4Material( "Brass", 8.52*g/cm3, 2 );
-  static bool init = true;
-  if( init ){
-    Brass->AddMaterial( artg4Materials::Cu(), 59.31*perCent ); //z=29
-    Brass->AddMaterial( artg4Materials::Zn(), 40.69*perCent ); //z=30
-    init = false;
-  }
+  G4Material *Brass = new G4Material( "Brass", 8.52*g/cm3, 2 );
+  Brass->AddMaterial( artg4Materials::Cu(), 59.31*perCent ); //z=29
+  Brass->AddMaterial( artg4Materials::Zn(), 40.69*perCent ); //z=30
   return Brass;
 }
 
 
-G4Material *artg4Materials::Conductor()
+G4Material *buildConductor()
 {
   //  NSF(3/13), Source: E821 inflector NIM paper, plus some simple calculations involving MASS fractions
-  static G4Material *Conductor = new G4Material( "Conductor", 4.394*g/cm3, 3 );
-  static bool init = true;
-  if( init ){
-    Conductor->AddMaterial(artg4Materials::NbTi(),30.95*perCent);
-    Conductor->AddMaterial(artg4Materials::Cu(),  25.15*perCent);
-    Conductor->AddMaterial(artg4Materials::Al(),  43.90*perCent);
-    init = false;
-  }
+  G4Material *Conductor = new G4Material( "Conductor", 4.394*g/cm3, 3 );
+  Conductor->AddMaterial(artg4Materials::NbTi(),30.95*perCent);
+  Conductor->AddMaterial(artg4Materials::Cu(),  25.15*perCent);
+  Conductor->AddMaterial(artg4Materials::Al(),  43.90*perCent);
   return Conductor;
 }
 
 
-G4Material* artg4Materials::Epoxy() // same as quartz, with different R and density
+G4MaterialPropertiesTable *buildEpoxyProperties()
+{
+  //  Material properties table
+  const G4int nEntries = 2;
+  G4double epoxyR = 1.5; //refractive index
+  G4double photonEnergy[ nEntries ]     = { 1.0*eV,  5.0*eV  };
+  G4double refractiveIndex[ nEntries ]  = { epoxyR,  epoxyR  };
+  G4double absorptionLength[ nEntries ] = { 500.*cm, 500.*cm };
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable();
+  table->AddProperty( "RINDEX",    photonEnergy, refractiveIndex,  nEntries );
+  table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries );
+
+  return table;
+}
+
+
+G4Material *buildEpoxy() // same as quartz, with different R and density
 {
   //  http://www.mt-berlin.com/frames_cryst/descriptions/quartz%20.htm
-  static G4Material *epoxy = new G4Material( "Epoxy", 1.02*g/cm3, 2 );
-  static bool init = true;
-  if( init ){
-    //  http://www.convertunits.com/molarmass/SiO2
-    epoxy->AddMaterial(artg4Materials::Si(),46.743*perCent);
-    epoxy->AddMaterial(artg4Materials::O(), 53.257*perCent);
-
-    //  Material properties table
-    const G4int nEntries = 2;
-    G4double epoxyR = 1.5; //refractive index
-    G4double photonEnergy[ nEntries ]     = { 1.0*eV,  5.0*eV  };
-    G4double refractiveIndex[ nEntries ]  = { epoxyR,  epoxyR  };
-    G4double absorptionLength[ nEntries ] = { 500.*cm, 500.*cm };
-
-    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable();
-    table->AddProperty( "RINDEX",    photonEnergy, refractiveIndex,  nEntries );
-    table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries );
-
-    epoxy->SetMaterialPropertiesTable( table ) ;
-    init = false;
-  }
+  G4Material *epoxy = new G4Material( "Epoxy", 1.02*g/cm3, 2 );
+  //  http://www.convertunits.com/molarmass/SiO2
+  epoxy->AddMaterial(artg4Materials::Si(),46.743*perCent);
+  epoxy->AddMaterial(artg4Materials::O(), 53.257*perCent);
+  epoxy->SetMaterialPropertiesTable( propertiesTable("Epoxy") );
   return epoxy;
 }
 
 
-G4Material *artg4Materials::H2O()
+G4Material *buildH2O()
 {
-  static G4Material *H2O = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
-  return H2O;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
 }
 
 
-G4Material *artg4Materials::Kapton()
+G4Material *buildKapton()
 {
-  static G4Material *Kapton = G4NistManager::Instance()->FindOrBuildMaterial("G4_KAPTON");
-  return Kapton;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_KAPTON");
 }
 
 
-G4Material *artg4Materials::MacorCeramic()
+G4Material *buildMacorCeramic()
 {
   //  http://www.azom.com/details.asp?ArticleID=1459
-  static G4Material *MacorCeramic = new G4Material( "MacorCeramic", 2.52*g/cm3, 6 );
-  static bool init = true;
-  if( init ){
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE"),46.*perCent);
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_ALUMINUM_OXIDE"), 16.*perCent);
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_POTASSIUM_OXIDE"),10.*perCent);
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_MAGNESIUM_OXIDE"),17.*perCent);
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_B"),4.4*perCent);
-    MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_O"),6.6*perCent);
-    init = false;
-  }
+  G4Material *MacorCeramic = new G4Material( "MacorCeramic", 2.52*g/cm3, 6 );
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE"),46.*perCent);
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_ALUMINUM_OXIDE"), 16.*perCent);
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_POTASSIUM_OXIDE"),10.*perCent);
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_MAGNESIUM_OXIDE"),17.*perCent);
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_B"),4.4*perCent);
+  MacorCeramic->AddMaterial(G4NistManager::Instance()->FindOrBuildMaterial("G4_O"),6.6*perCent);
   return MacorCeramic;
 }
 
 
-G4Material *artg4Materials::Mylar()
+G4Material *buildMylar()
 {
-  static G4Material *Mylar = G4NistManager::Instance()->FindOrBuildMaterial("G4_MYLAR");
-  return Mylar;
+  return G4NistManager::Instance()->FindOrBuildMaterial("G4_MYLAR");
 }
 
 
-G4Material *artg4Materials::NbTi()
+G4Material *buildNbTi()
 {
   //  NSF(3/13): E821 inflector NIM paper, plus some simple calculations involving MASS fractions
-  static G4Material *NbTi = new G4Material( "NbTi", 6.555*g/cm3, 2 );
-  static bool init = true;
-  if( init ){
-    NbTi->AddMaterial(artg4Materials::Nb(),66.00*perCent);
-    NbTi->AddMaterial(artg4Materials::Ti(),34.00*perCent); 
-    init = false;
-  }
+  G4Material *NbTi = new G4Material( "NbTi", 6.555*g/cm3, 2 );
+  NbTi->AddMaterial(artg4Materials::Nb(),66.00*perCent);
+  NbTi->AddMaterial(artg4Materials::Ti(),34.00*perCent); 
   return NbTi;
 }
 
 
-G4Material* artg4Materials::NusilLS5257()
+G4MaterialPropertiesTable *buildNusilLS5257Properties()
 {
-    static bool init = true;
-    static G4Material *nusilLS5257;
-    
-    if( init ){
-        
-        G4NistManager* nistMan = G4NistManager::Instance();
-        std::vector<G4int> natoms;
-        std::vector<G4double> fractionMass;
-        std::vector<G4String> elements;
-        
-        // use same elemental composition and density as Bicron BC-630 optical grease
-        elements.push_back("C");     natoms.push_back(2);
-        elements.push_back("H");     natoms.push_back(6);
-        double density = 1.060*g/cm3;
-        
-        nusilLS5257 = nistMan->
-        ConstructNewMaterial("NusilLS5257", elements, natoms, density);
-        
-        // Material Properties table
-        const G4int nEntries = 6 ;
-        
-        // Order from low energy to high energy (required for Geant 4.9.5)
-        G4double wavelengths[ nEntries ] = { 950.*nm, 833.*nm, 589.*nm, 411.*nm, 300.*nm, 250.*nm };
-        G4double photonEnergy[ nEntries ] ;
-        for( int i = 0 ; i < nEntries ; ++i )
-        {
-            photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
-        }
-        
-        // Refractive index from Nusil LS 5257 data sheet
-        G4double refractiveIndex[ nEntries ] = { 1.552, 1.5550, 1.5677, 1.6015, 1.755, 2.126 };
-
-        // Not including any absorption for now; much more transparent than Bicron grease
-        
-        // Geant 4.9.5 Material properties table: photonEnergy must be in order
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
-        
-        nusilLS5257->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
+  // Material Properties table
+  const G4int nEntries = 6 ;
+
+  // Order from low energy to high energy (required for Geant 4.9.5)
+  G4double wavelengths[ nEntries ] = { 950.*nm, 833.*nm, 589.*nm, 411.*nm, 300.*nm, 250.*nm };
+  G4double photonEnergy[ nEntries ] ;
+  for( int i = 0 ; i < nEntries ; ++i )
+  {
+      photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
+  }
+
+  // Refractive index from Nusil LS 5257 data sheet
+  G4double refractiveIndex[ nEntries ] = { 1.552, 1.5550, 1.5677, 1.6015, 1.755, 2.126 };
+
+  // Not including any absorption for now; much more transparent than Bicron grease
+
+  // Geant 4.9.5 Material properties table: photonEnergy must be in order
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
+
+  return table;
+}
+
+
+G4Material *buildNusilLS5257()
+{
+    G4Material *nusilLS5257;
+
+    G4NistManager* nistMan = G4NistManager::Instance();
+    std::vector<G4int> natoms;
+    std::vector<G4double> fractionMass;
+    std::vector<G4String> elements;
+
+    // use same elemental composition and density as Bicron BC-630 optical grease
+    elements.push_back("C");     natoms.push_back(2);
+    elements.push_back("H");     natoms.push_back(6);
+    double density = 1.060*g/cm3;
+
+    nusilLS5257 = nistMan->
+    ConstructNewMaterial("NusilLS5257", elements, natoms, density);
+    nusilLS5257->SetMaterialPropertiesTable( propertiesTable("NusilLS5257") );
+
     return nusilLS5257;
 }
 
 
-G4Material* artg4Materials::PbSb()
+G4Material *buildPbSb()
 {
-  static G4Material *PbSb = new G4Material( "PbSb", 11.19*g/cm3, 2 ); // NSF(3/13): density calculated from mass fractions below
-  static bool init = true;
-  if( init ){
-    PbSb->AddMaterial(artg4Materials::Pb(),94.*perCent); //assume correct
-    PbSb->AddMaterial(artg4Materials::Sb(), 6.*perCent); //assume correct
-    init = false;
-  }
+  G4Material *PbSb = new G4Material( "PbSb", 11.19*g/cm3, 2 ); // NSF(3/13): density calculated from mass fractions below
+  PbSb->AddMaterial(artg4Materials::Pb(),94.*perCent); //assume correct
+  PbSb->AddMaterial(artg4Materials::Sb(), 6.*perCent); //assume correct
   return PbSb;
 }
 
-G4Material *artg4Materials::Vacuum()
+G4Material *buildVacuum()
 {
-  static G4Material *Vacuum = new G4Material("Vacuum", 
+  G4Material *Vacuum = new G4Material("Vacuum", 
 					     1., 
 					     1.01*g/mole,
 					     universe_mean_density,
@@ -567,124 +492,120 @@ G4Material *artg4Materials::Vacuum()
 }  
 
 
-G4Material *artg4Materials::Vacuum1()
+G4MaterialPropertiesTable *buildVacuum1Properties()
+{
+  // Material Properties table
+  const G4int nEntries = 2 ;
+  G4double photonEnergy[ nEntries ] = { 1.0*eV, 5.0*eV } ;
+  G4double refractiveIndex[ nEntries ] = { 1.0, 1.0 } ;
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
+
+  return table;
+}
+
+
+G4Material *buildVacuum1()
 // vacuum with index of refraction = 1; needed for optical processes
 {
-  static bool init = true;
-  static G4Material *Vacuum1 = new G4Material("Vacuum1", 
+  G4Material *Vacuum1 = new G4Material("Vacuum1", 
 					     1., 
 					     1.01*g/mole,
 					     universe_mean_density,
 					     kStateGas, 
 					     3.e-18*pascal, 
 					     2.73*kelvin);
+   Vacuum1->SetMaterialPropertiesTable( propertiesTable("Vacuum1") );
 
-   if( init ){
-      // Material Properties table
-      const G4int nEntries = 2 ;
-      G4double photonEnergy[ nEntries ] = { 1.0*eV, 5.0*eV } ;
-      G4double refractiveIndex[ nEntries ] = { 1.0, 1.0 } ;
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
-
-      Vacuum1->SetMaterialPropertiesTable( table ) ;
-
-      init = false;
-   }
-  
   return Vacuum1;
 }  
 
 
-G4Material* artg4Materials::PbF2()
+G4MaterialPropertiesTable *buildPbF2Properties()
+{
+  // Material Properties table
+  const G4int nEntries = 8 ;
+
+  // Order from low energy to high energy (required for Geant 4.9.5)
+  G4double wavelengths[ nEntries ] =
+    { 950.*nm,
+        800.*nm,
+        600.*nm,
+        400.*nm,
+        350.*nm,
+        300.*nm,
+        275.*nm,
+        250.*nm } ;
+
+  // Transmission coefficients measured for 186mm long crystal
+  G4double transmission[ nEntries ] =
+    { 0.84, // 950 nm
+        0.83, // 800 nm
+        0.81, // 600 nm
+        0.75, // 400 nm
+        0.71, // 350 nm
+        0.48, // 300 nm
+        0.18,   // 275 nm
+        0. } ; // 250 nm
+
+  // refractive index data from http://refractiveindex.info/?group=CRYSTALS&material=PbF2
+  G4double refractiveIndex[ nEntries ] =
+    { 1.74, // 950 nm
+        1.75, // 800 nm
+        1.76, // 600 nm
+        1.82, // 400 nm
+        1.85, // 350 nm
+        1.94, // 300 nm
+        1.98, // 275 nm
+        2.02 } ; // 250 nm
+
+  G4double photonEnergy[ nEntries ] ;
+  // G4double rayleighLength[ nEntries ];
+  G4double transCorrectionFactor[ nEntries ] ;
+  G4double absorptionLength[ nEntries ] ;
+
+  for( int i = 0 ; i < nEntries ; ++i )
+  {
+     photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
+      // rayleighLength[ i ] = 1.*cm ;
+
+      // correction for surface reflections:
+      // Transmission_internal = Transmission_total * (1+n)^4 / (4n)^2
+      // See simulation elog 217 https://muon.npl.washington.edu/elog/g2/Simulation/217
+      G4double n = refractiveIndex[ i ];
+      G4double sqrtCorrection = (1+n)*(1+n)/(4*n);
+      transCorrectionFactor[ i ] = sqrtCorrection*sqrtCorrection;
+
+      absorptionLength[ i ] = -186.*mm / log( transmission[ i ]*transCorrectionFactor[ i ] ) ;
+  }
+
+  // Geant 4.9.5 Material properties table: photonEnergy must be in order
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries ) ;
+  // table->AddProperty( "RAYLEIGH", photonEnergy, rayleighLength, nEntries ) ;
+
+  return table;
+}
+
+
+G4Material *buildPbF2()
 {
-   static bool init = true;
    // http://www.crystran.co.uk/lead-fluoride-pbf2.htm
-   static G4Material *PbF2 = new G4Material("PbF2",
+   G4Material *PbF2 = new G4Material("PbF2",
 					    7.77*g/cm3,
 					    2);
-   if( init ){
-      // http://www.convertunits.com/molarmass/PbF2
-      PbF2 -> AddMaterial(artg4Materials::Pb(), 84.504*perCent);
-      PbF2 -> AddMaterial(artg4Materials::F(), 15.496*perCent);
-
-      // Material Properties table
-      const G4int nEntries = 8 ;
-
-       // Order from low energy to high energy (required for Geant 4.9.5)
-       G4double wavelengths[ nEntries ] =
-         { 950.*nm,
-             800.*nm,
-             600.*nm,
-             400.*nm,
-             350.*nm,
-             300.*nm,
-             275.*nm,
-             250.*nm } ;
-       
-       // Transmission coefficients measured for 186mm long crystal
-       G4double transmission[ nEntries ] =
-         { 0.84, // 950 nm
-             0.83, // 800 nm
-             0.81, // 600 nm
-             0.75, // 400 nm
-             0.71, // 350 nm
-             0.48, // 300 nm
-             0.18,   // 275 nm
-             0. } ; // 250 nm
-       
-       // refractive index data from http://refractiveindex.info/?group=CRYSTALS&material=PbF2
-       G4double refractiveIndex[ nEntries ] =
-         { 1.74, // 950 nm
-             1.75, // 800 nm
-             1.76, // 600 nm
-             1.82, // 400 nm
-             1.85, // 350 nm
-             1.94, // 300 nm
-             1.98, // 275 nm
-             2.02 } ; // 250 nm
-
-       
-    G4double photonEnergy[ nEntries ] ;
-    // G4double rayleighLength[ nEntries ];
-    G4double transCorrectionFactor[ nEntries ] ;
-    G4double absorptionLength[ nEntries ] ;
-
-    for( int i = 0 ; i < nEntries ; ++i )
-    {
-       photonEnergy[ i ] = 0.001240 * MeV * nm / wavelengths[ i ] ;
-        // rayleighLength[ i ] = 1.*cm ;
-        
-        // correction for surface reflections:
-        // Transmission_internal = Transmission_total * (1+n)^4 / (4n)^2
-        // See simulation elog 217 https://muon.npl.washington.edu/elog/g2/Simulation/217
-        G4double n = refractiveIndex[ i ];
-        G4double sqrtCorrection = (1+n)*(1+n)/(4*n);
-        transCorrectionFactor[ i ] = sqrtCorrection*sqrtCorrection;
-        
-        absorptionLength[ i ] = -186.*mm / log( transmission[ i ]*transCorrectionFactor[ i ] ) ;
-    }
-
-    // Geant 4.9.5 Material properties table: photonEnergy must be in order
-    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-    table->AddProperty( "RINDEX", photonEnergy, refractiveIndex, nEntries ) ;
-    table->AddProperty( "ABSLENGTH", photonEnergy, absorptionLength, nEntries ) ;
-    // table->AddProperty( "RAYLEIGH", photonEnergy, rayleighLength, nEntries ) ;
-
-    PbF2->SetMaterialPropertiesTable( table ) ;
+   // http://www.convertunits.com/molarmass/PbF2
+   PbF2 -> AddMaterial(artg4Materials::Pb(), 84.504*perCent);
+   PbF2 -> AddMaterial(artg4Materials::F(), 15.496*perCent);
+   PbF2->SetMaterialPropertiesTable( propertiesTable("PbF2") );
 
-    init = false;
-   }
-  
    return PbF2;
 }
 
 
-G4Material* artg4Materials::Quartz() // SiO2
+G4MaterialPropertiesTable *buildQuartzProperties()
 {
-  static G4Material *quartz = 
-     G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE");
-
   // http://hypernews.slac.stanford.edu/HyperNews/geant4/get/opticalphotons/299.html
   const G4int num = 2 ;
   G4MaterialPropertiesTable* myQuartzWindow = new G4MaterialPropertiesTable();
@@ -696,26 +617,38 @@ G4Material* artg4Materials::Quartz() // SiO2
   G4double quartzPhotonRefractiveIndex[num] = {1.458 , 1.458};
   myQuartzWindow->AddProperty("RINDEX",quartzPhotonRefractiveIndexNRG,
 			      quartzPhotonRefractiveIndex,num);
-  quartz->SetMaterialPropertiesTable(myQuartzWindow);
+
+  return myQuartzWindow;
+}
+
+
+G4Material *buildQuartz() // SiO2
+{
+  G4Material *quartz = 
+     G4NistManager::Instance()->FindOrBuildMaterial("G4_SILICON_DIOXIDE");
+  quartz->SetMaterialPropertiesTable( propertiesTable("Quartz") );
 
   return quartz;
 }
 
-G4Material* artg4Materials::SiPMSurfaceResin()
+G4MaterialPropertiesTable *buildSiPMSurfaceResinProperties()
+{
+  const G4int nEntries = 2 ;
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable();
+  G4double photonEnergy[nEntries] = { 1.0*eV, 5.0*eV } ;
+  G4double refractiveIndex[nEntries] = {1.55 , 1.55};
+  table->AddProperty("RINDEX", photonEnergy, refractiveIndex, nEntries);
+
+  return table;
+}
+
+
+G4Material *buildSiPMSurfaceResin()
 /* With the correct index of refraction (n = 1.55). Other bulk properties don't matter for the simulation, because particle tracks are killed when they enter the photodetector volume.
  */
 {
-    static bool init = true;
-    static G4Material *sipmresin = G4NistManager::Instance()->FindOrBuildMaterial("G4_Si");
-    
-    if( init ){
-    const G4int nEntries = 2 ;
-    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable();
-    G4double photonEnergy[nEntries] = { 1.0*eV, 5.0*eV } ;
-    G4double refractiveIndex[nEntries] = {1.55 , 1.55};
-    table->AddProperty("RINDEX", photonEnergy, refractiveIndex, nEntries);
-    sipmresin->SetMaterialPropertiesTable(table);
-    }
+    G4Material *sipmresin = G4NistManager::Instance()->FindOrBuildMaterial("G4_Si");
+    sipmresin->SetMaterialPropertiesTable( propertiesTable("SiPMSurfaceResin") );
     return sipmresin;
 }
 
@@ -725,60 +658,36 @@ G4Material* artg4Materials::SiPMSurfaceResin()
 //=======================   OPTICAL SURFACES   =======================//
 //====================================================================//
 
-G4OpticalSurface* artg4Materials::PolishedMetal()
+G4OpticalSurface *buildPolishedMetal()
 {
-   static bool init = true;
-   static G4OpticalSurface *polishedMetal = new G4OpticalSurface("PolishedMetal");
-
-   if( init ){
-      polishedMetal->SetType( dielectric_metal ) ;
-      polishedMetal->SetFinish( polished ) ;
-      polishedMetal->SetModel( unified ) ;
+   G4OpticalSurface *polishedMetal = new G4OpticalSurface("PolishedMetal");
 
-      init = false;
-   }
+   polishedMetal->SetType( dielectric_metal ) ;
+   polishedMetal->SetFinish( polished ) ;
+   polishedMetal->SetModel( unified ) ;
 
    return polishedMetal;
 }
 
-G4OpticalSurface* artg4Materials::PolishedMetalReverse()
+G4OpticalSurface *buildPolishedMetalReverse()
 // same as PolishedMetal (back side same as front)
 {
-    static bool init = true;
-    static G4OpticalSurface *polishedMetalReverse = new G4OpticalSurface("PolishedMetalReverse");
-    
-    if( init ){
-        polishedMetalReverse->SetType( dielectric_metal ) ;
-        polishedMetalReverse->SetFinish( polished ) ;
-        polishedMetalReverse->SetModel( unified ) ;
-        
-        init = false;
-    }
+    G4OpticalSurface *polishedMetalReverse = new G4OpticalSurface("PolishedMetalReverse");
     
+    polishedMetalReverse->SetType( dielectric_metal ) ;
+    polishedMetalReverse->SetFinish( polished ) ;
+    polishedMetalReverse->SetModel( unified ) ;
+
     return polishedMetalReverse;
 }
 
-G4OpticalSurface* artg4Materials::Specular()
-// PbF2 crystal surface with specular wrapping material
-// reflectivity = 1, pure specular reflection, with air gap
+G4MaterialPropertiesTable *buildSpecularProperties()
 {
-   static bool init = true;
-   static G4OpticalSurface *specular = new G4OpticalSurface("Specular");
+  // Material Properties table
 
-   if( init ){
+  const G4int nEntries = 12 ;
 
-      // type of optical surface
-      specular->SetType(dielectric_dielectric);
-      specular->SetModel(unified);
-      specular->SetFinish(polishedbackpainted); // "polished" means wrapping does specular reflection
-      double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
-      specular->SetSigmaAlpha(facetAngleDistributionSigma);
-
-      // Material Properties table
-
-      const G4int nEntries = 12 ;
-
-      G4double photonEnergy[ nEntries ] = 
+  G4double photonEnergy[ nEntries ] = 
 	 { 1.0*eV,
 	   1.55*eV,
 	   2.7*eV,
@@ -793,113 +702,110 @@ G4OpticalSurface* artg4Materials::Specular()
 	   6.21*eV
 	 };
 
-      G4double reflectivityValue = 1.0;
-      G4double reflectivity[nEntries];
-      std::fill_n(reflectivity, nEntries, reflectivityValue);
-
-      // refractive index for air gap
-      G4double effectiveRefractiveIndex = 1.0;
-      G4double refractiveIndex[nEntries];
-      std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
-
-      // xtal surface is faceted; all reflections are specular using surface normal from distribution
-      G4double specularSpikeValue = 0.0;
-      G4double specularLobeValue = 1.0;
-      G4double backscatterValue = 0;
-      G4double specularSpike[nEntries];
-      G4double specularLobe[nEntries];
-      G4double backscatter[nEntries];
-
-      std::fill_n(specularSpike, nEntries, specularSpikeValue);
-      std::fill_n(specularLobe, nEntries, specularLobeValue);
-      std::fill_n(backscatter, nEntries, backscatterValue);
-      
-
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
-      table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-      table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-      table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-      table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-
-      specular->SetMaterialPropertiesTable( table ) ;
-
-      init = false;
-   }
-  
+  G4double reflectivityValue = 1.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
+
+  // refractive index for air gap
+  G4double effectiveRefractiveIndex = 1.0;
+  G4double refractiveIndex[nEntries];
+  std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
+
+  // xtal surface is faceted; all reflections are specular using surface normal from distribution
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
+
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildSpecular()
+// PbF2 crystal surface with specular wrapping material
+// reflectivity = 1, pure specular reflection, with air gap
+{
+   G4OpticalSurface *specular = new G4OpticalSurface("Specular");
+
+   // type of optical surface
+   specular->SetType(dielectric_dielectric);
+   specular->SetModel(unified);
+   specular->SetFinish(polishedbackpainted); // "polished" means wrapping does specular reflection
+   double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
+   specular->SetSigmaAlpha(facetAngleDistributionSigma);
+   specular->SetMaterialPropertiesTable( propertiesTable("Specular") );
+
    return specular;
 }
 
-G4OpticalSurface* artg4Materials::SpecularReverse()
+G4MaterialPropertiesTable *buildSpecularReverseProperties()
+{
+  // Material Properties table
+
+  const G4int nEntries = 12 ;
+
+  G4double photonEnergy[ nEntries ] =
+  { 1.0*eV,
+      1.55*eV,
+      2.7*eV,
+      2.97*eV,
+      3.31*eV,
+      3.55*eV,
+      3.82*eV,
+      4.46*eV,
+      4.92*eV,
+      5.5*eV,
+      5.82*eV,
+      6.21*eV
+  };
+
+  G4double reflectivityValue = 1.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildSpecularReverse()
 // Optical surface for photons hitting the other side of the specular wrapping
 //     (i.e., the photons would enter the PbF2 crystal if the wrapping weren't there to stop them)
 // reflectivity = 1, pure specular reflection
 {
-    static bool init = true;
-    static G4OpticalSurface *specularReverse = new G4OpticalSurface("SpecularReverse");
-    
-    if( init ){
-        
-        // type of optical surface
-        specularReverse->SetType(dielectric_dielectric);
-        specularReverse->SetModel(unified);
-        specularReverse->SetFinish(polishedfrontpainted); // "polished" means wrapping does specular reflection
-        
-        // Material Properties table
-        
-        const G4int nEntries = 12 ;
-        
-        G4double photonEnergy[ nEntries ] =
-        { 1.0*eV,
-            1.55*eV,
-            2.7*eV,
-            2.97*eV,
-            3.31*eV,
-            3.55*eV,
-            3.82*eV,
-            4.46*eV,
-            4.92*eV,
-            5.5*eV,
-            5.82*eV,
-            6.21*eV
-        };
-        
-        G4double reflectivityValue = 1.0;
-        G4double reflectivity[nEntries];
-        std::fill_n(reflectivity, nEntries, reflectivityValue);
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-        
-        specularReverse->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
+    G4OpticalSurface *specularReverse = new G4OpticalSurface("SpecularReverse");
+
+    // type of optical surface
+    specularReverse->SetType(dielectric_dielectric);
+    specularReverse->SetModel(unified);
+    specularReverse->SetFinish(polishedfrontpainted); // "polished" means wrapping does specular reflection
+    specularReverse->SetMaterialPropertiesTable( propertiesTable("SpecularReverse") );
+
     return specularReverse;
 }
 
-G4OpticalSurface* artg4Materials::Diffuse()
-// PbF2 crystal surface with diffuse white wrapping material
-// reflectivity = 1, pure diffuse reflection, with air gap; specular reflection at xtal surface
+G4MaterialPropertiesTable *buildDiffuseProperties()
 {
-   static bool init = true;
-   static G4OpticalSurface *diffuse = new G4OpticalSurface("Diffuse");
-
-   if( init ){
+  // Material Properties table
 
-      // type of optical surface
-      diffuse->SetType(dielectric_dielectric);
-      diffuse->SetModel(unified);
-      diffuse->SetFinish(groundbackpainted); // "ground" means wrapping does diffuse reflection
-      double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
-      diffuse->SetSigmaAlpha(facetAngleDistributionSigma);
-
-      // Material Properties table
-
-      const G4int nEntries = 12 ;
+  const G4int nEntries = 12 ;
 
-      G4double photonEnergy[ nEntries ] = 
+  G4double photonEnergy[ nEntries ] = 
 	 { 1.0*eV,
 	   1.55*eV,
 	   2.7*eV,
@@ -914,115 +820,112 @@ G4OpticalSurface* artg4Materials::Diffuse()
 	   6.21*eV
 	 };
 
-      G4double reflectivityValue = 1.0;
-      G4double reflectivity[nEntries];
-      std::fill_n(reflectivity, nEntries, reflectivityValue);
-
-      // refractive index for air gap
-      G4double effectiveRefractiveIndex = 1.0;
-      G4double refractiveIndex[nEntries];
-      std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
-
-      // xtal surface is faceted; all reflections are specular using surface normal from distribution
-      G4double specularSpikeValue = 0.0;
-      G4double specularLobeValue = 1.0;
-      G4double backscatterValue = 0;
-      G4double specularSpike[nEntries];
-      G4double specularLobe[nEntries];
-      G4double backscatter[nEntries];
-
-      std::fill_n(specularSpike, nEntries, specularSpikeValue);
-      std::fill_n(specularLobe, nEntries, specularLobeValue);
-      std::fill_n(backscatter, nEntries, backscatterValue);
-      
-
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
-      table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-      table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-      table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-      table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-
-      diffuse->SetMaterialPropertiesTable( table ) ;
-
-      init = false;
-   }
-  
+  G4double reflectivityValue = 1.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
+
+  // refractive index for air gap
+  G4double effectiveRefractiveIndex = 1.0;
+  G4double refractiveIndex[nEntries];
+  std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
+
+  // xtal surface is faceted; all reflections are specular using surface normal from distribution
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
+
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildDiffuse()
+// PbF2 crystal surface with diffuse white wrapping material
+// reflectivity = 1, pure diffuse reflection, with air gap; specular reflection at xtal surface
+{
+   G4OpticalSurface *diffuse = new G4OpticalSurface("Diffuse");
+
+   // type of optical surface
+   diffuse->SetType(dielectric_dielectric);
+   diffuse->SetModel(unified);
+   diffuse->SetFinish(groundbackpainted); // "ground" means wrapping does diffuse reflection
+   double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
+   diffuse->SetSigmaAlpha(facetAngleDistributionSigma);
+   diffuse->SetMaterialPropertiesTable( propertiesTable("Diffuse") );
+
    return diffuse;
 }
 
 
-G4OpticalSurface* artg4Materials::DiffuseReverse()
+G4MaterialPropertiesTable *buildDiffuseReverseProperties()
+{
+  // Material Properties table
+
+  const G4int nEntries = 12 ;
+
+  G4double photonEnergy[ nEntries ] =
+  { 1.0*eV,
+      1.55*eV,
+      2.7*eV,
+      2.97*eV,
+      3.31*eV,
+      3.55*eV,
+      3.82*eV,
+      4.46*eV,
+      4.92*eV,
+      5.5*eV,
+      5.82*eV,
+      6.21*eV
+  };
+
+  G4double reflectivityValue = 1.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildDiffuseReverse()
 // Optical surface for photons hitting the other side of the diffuse wrapping
 //     (i.e., the photons would enter the PbF2 crystal if the wrapping weren't there to stop them)
 // reflectivity = 1, pure diffuse reflection
 {
-    static bool init = true;
-    static G4OpticalSurface *diffuseReverse = new G4OpticalSurface("DiffuseReverse");
-    
-    if( init ){
-        
-        // type of optical surface
-        diffuseReverse->SetType(dielectric_dielectric);
-        diffuseReverse->SetModel(unified);
-        diffuseReverse->SetFinish(groundfrontpainted); // "ground" means wrapping does diffuse reflection
-        
-        // Material Properties table
-        
-        const G4int nEntries = 12 ;
-        
-        G4double photonEnergy[ nEntries ] =
-        { 1.0*eV,
-            1.55*eV,
-            2.7*eV,
-            2.97*eV,
-            3.31*eV,
-            3.55*eV,
-            3.82*eV,
-            4.46*eV,
-            4.92*eV,
-            5.5*eV,
-            5.82*eV,
-            6.21*eV
-        };
-        
-        G4double reflectivityValue = 1.0;
-        G4double reflectivity[nEntries];
-        std::fill_n(reflectivity, nEntries, reflectivityValue);
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-        
-        diffuseReverse->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
+    G4OpticalSurface *diffuseReverse = new G4OpticalSurface("DiffuseReverse");
+
+    // type of optical surface
+    diffuseReverse->SetType(dielectric_dielectric);
+    diffuseReverse->SetModel(unified);
+    diffuseReverse->SetFinish(groundfrontpainted); // "ground" means wrapping does diffuse reflection
+    diffuseReverse->SetMaterialPropertiesTable( propertiesTable("DiffuseReverse") );
+
     return diffuseReverse;
 }
 
 
-G4OpticalSurface* artg4Materials::Black()
-// PbF2 crystal surface with black wrapping material
-// reflectivity = 0, with air gap; specualar spike reflections at xtal surface
+G4MaterialPropertiesTable *buildBlackProperties()
 {
-   static bool init = true;
-   static G4OpticalSurface *black = new G4OpticalSurface("Black");
-
-   if( init ){
+  // Material Properties table
 
-      // type of optical surface
-      black->SetType(dielectric_dielectric);
-      black->SetModel(unified);
-      black->SetFinish(polishedbackpainted);
-      double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
-      black->SetSigmaAlpha(facetAngleDistributionSigma);
+  const G4int nEntries = 12 ;
 
-      // Material Properties table
-
-      const G4int nEntries = 12 ;
-
-      G4double photonEnergy[ nEntries ] = 
+  G4double photonEnergy[ nEntries ] = 
 	 { 1.0*eV,
 	   1.55*eV,
 	   2.7*eV,
@@ -1037,113 +940,111 @@ G4OpticalSurface* artg4Materials::Black()
 	   6.21*eV
 	 };
 
-      G4double reflectivityValue = 0.0;
-      G4double reflectivity[nEntries];
-      std::fill_n(reflectivity, nEntries, reflectivityValue);
+  G4double reflectivityValue = 0.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
 
-      // refractive index for air gap
-      G4double effectiveRefractiveIndex = 1.0;
-      G4double refractiveIndex[nEntries];
-      std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
+  // refractive index for air gap
+  G4double effectiveRefractiveIndex = 1.0;
+  G4double refractiveIndex[nEntries];
+  std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
 
-      // xtal surface is faceted; all reflections are specular using surface normal from distribution      
-      G4double specularSpikeValue = 0.0;
-      G4double specularLobeValue = 1.0;
-      G4double backscatterValue = 0;
-      G4double specularSpike[nEntries];
-      G4double specularLobe[nEntries];
-      G4double backscatter[nEntries];
+  // xtal surface is faceted; all reflections are specular using surface normal from distribution      
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
 
-      std::fill_n(specularSpike, nEntries, specularSpikeValue);
-      std::fill_n(specularLobe, nEntries, specularLobeValue);
-      std::fill_n(backscatter, nEntries, backscatterValue);
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
 
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
-      table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-      table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-      table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-      table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
 
+  return table;
+}
 
-      black->SetMaterialPropertiesTable( table ) ;
 
-      init = false;
-   }
-  
+G4OpticalSurface *buildBlack()
+// PbF2 crystal surface with black wrapping material
+// reflectivity = 0, with air gap; specualar spike reflections at xtal surface
+{
+   G4OpticalSurface *black = new G4OpticalSurface("Black");
+
+   // type of optical surface
+   black->SetType(dielectric_dielectric);
+   black->SetModel(unified);
+   black->SetFinish(polishedbackpainted);
+   double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
+   black->SetSigmaAlpha(facetAngleDistributionSigma);
+   black->SetMaterialPropertiesTable( propertiesTable("Black") );
+
    return black;
 }
 
 
-G4OpticalSurface* artg4Materials::BlackReverse()
+G4MaterialPropertiesTable *buildBlackReverseProperties()
+{
+  // Material Properties table
+
+  const G4int nEntries = 12 ;
+
+  G4double photonEnergy[ nEntries ] =
+  { 1.0*eV,
+      1.55*eV,
+      2.7*eV,
+      2.97*eV,
+      3.31*eV,
+      3.55*eV,
+      3.82*eV,
+      4.46*eV,
+      4.92*eV,
+      5.5*eV,
+      5.82*eV,
+      6.21*eV
+  };
+
+  G4double reflectivityValue = 0.0;
+  G4double reflectivity[nEntries];
+  std::fill_n(reflectivity, nEntries, reflectivityValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildBlackReverse()
 // Optical surface for photons hitting the other side of the black wrapping
 //     (i.e., the photons would enter the PbF2 crystal if the wrapping weren't there to stop them)
 // reflectivity = 0
 {
-    static bool init = true;
-    static G4OpticalSurface *blackReverse = new G4OpticalSurface("BlackReverse");
-    
-    if( init ){
-        
-        // type of optical surface
-        blackReverse->SetType(dielectric_dielectric);
-        blackReverse->SetModel(unified);
-        blackReverse->SetFinish(polishedfrontpainted);
-        
-        // Material Properties table
-        
-        const G4int nEntries = 12 ;
-        
-        G4double photonEnergy[ nEntries ] =
-        { 1.0*eV,
-            1.55*eV,
-            2.7*eV,
-            2.97*eV,
-            3.31*eV,
-            3.55*eV,
-            3.82*eV,
-            4.46*eV,
-            4.92*eV,
-            5.5*eV,
-            5.82*eV,
-            6.21*eV
-        };
-        
-        G4double reflectivityValue = 0.0;
-        G4double reflectivity[nEntries];
-        std::fill_n(reflectivity, nEntries, reflectivityValue);
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-        
-        blackReverse->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
+    G4OpticalSurface *blackReverse = new G4OpticalSurface("BlackReverse");
+
+    // type of optical surface
+    blackReverse->SetType(dielectric_dielectric);
+    blackReverse->SetModel(unified);
+    blackReverse->SetFinish(polishedfrontpainted);
+    blackReverse->SetMaterialPropertiesTable( propertiesTable("BlackReverse") );
+
     return blackReverse;
 }
 
-G4OpticalSurface* artg4Materials::Tedlar()
-// Diffuse reflection based on reflectivity measurements made on Tedlar paper
+G4MaterialPropertiesTable *buildTedlarProperties()
 {
-   static bool init = true;
-   static G4OpticalSurface *tedlar = new G4OpticalSurface("Tedlar");
+  // Material Properties table
 
-   if( init ){
+  const G4int nEntries = 24 ;
 
-      // type of optical surface
-      tedlar->SetType(dielectric_dielectric);
-      tedlar->SetModel(unified);
-      tedlar->SetFinish(groundbackpainted);
-      double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
-      tedlar->SetSigmaAlpha(facetAngleDistributionSigma);
-
-      // Material Properties table
-
-      const G4int nEntries = 24 ;
-
-      G4double photonEnergy[ nEntries ] = 
+  G4double photonEnergy[ nEntries ] = 
 	{ 1.38*eV,
 	  1.55*eV,
 	  1.77*eV,
@@ -1170,8 +1071,8 @@ G4OpticalSurface* artg4Materials::Tedlar()
 	  4.96*eV
 	 };
 
-      // From Detector Elog 584
-      G4double reflectivity[nEntries] = 
+  // From Detector Elog 584
+  G4double reflectivity[nEntries] = 
 	{
 	  0.0669,
 	  0.0741,
@@ -1198,58 +1099,58 @@ G4OpticalSurface* artg4Materials::Tedlar()
 	  0.0635,
 	  0.0637
 	};
-      
-      // refractive index for air gap
-      G4double effectiveRefractiveIndex = 1.0;
-      G4double refractiveIndex[nEntries];
-      std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
-
-      // xtal surface is faceted; all reflections are specular using surface normal from distribution      
-      G4double specularSpikeValue = 0.0;
-      G4double specularLobeValue = 1.0;
-      G4double backscatterValue = 0;
-      G4double specularSpike[nEntries];
-      G4double specularLobe[nEntries];
-      G4double backscatter[nEntries];
-
-      std::fill_n(specularSpike, nEntries, specularSpikeValue);
-      std::fill_n(specularLobe, nEntries, specularLobeValue);
-      std::fill_n(backscatter, nEntries, backscatterValue);
-
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
-      table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-      table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-      table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-      table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-
-
-      tedlar->SetMaterialPropertiesTable( table ) ;
-
-      init = false;
-   }
-  
+
+  // refractive index for air gap
+  G4double effectiveRefractiveIndex = 1.0;
+  G4double refractiveIndex[nEntries];
+  std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
+
+  // xtal surface is faceted; all reflections are specular using surface normal from distribution      
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
+
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildTedlar()
+// Diffuse reflection based on reflectivity measurements made on Tedlar paper
+{
+   G4OpticalSurface *tedlar = new G4OpticalSurface("Tedlar");
+
+   // type of optical surface
+   tedlar->SetType(dielectric_dielectric);
+   tedlar->SetModel(unified);
+   tedlar->SetFinish(groundbackpainted);
+   double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
+   tedlar->SetSigmaAlpha(facetAngleDistributionSigma);
+   tedlar->SetMaterialPropertiesTable( propertiesTable("Tedlar") );
+
    return tedlar;
 }
 
-G4OpticalSurface* artg4Materials::TedlarReverse()
-// Optical surface for photons that would be entering the xtal
+G4MaterialPropertiesTable *buildTedlarReverseProperties()
 {
-    static bool init = true;
-    static G4OpticalSurface *tedlarReverse = new G4OpticalSurface("TedlarReverse");
-    
-    if( init ){
-        
-        // type of optical surface
-        tedlarReverse->SetType(dielectric_dielectric);
-        tedlarReverse->SetModel(unified);
-        tedlarReverse->SetFinish(groundfrontpainted);
-        
-        // Material Properties table
-        
-        const G4int nEntries = 24 ;
-        
-       G4double photonEnergy[ nEntries ] = 
+    // Material Properties table
+
+    const G4int nEntries = 24 ;
+
+   G4double photonEnergy[ nEntries ] = 
 	{ 1.38*eV,
 	  1.55*eV,
 	  1.77*eV,
@@ -1276,8 +1177,8 @@ G4OpticalSurface* artg4Materials::TedlarReverse()
 	  4.96*eV
 	 };
 
-      // From Detector Elog 584
-      G4double reflectivity[nEntries] = 
+  // From Detector Elog 584
+  G4double reflectivity[nEntries] = 
 	{
 	  0.0669,
 	  0.0741,
@@ -1304,39 +1205,35 @@ G4OpticalSurface* artg4Materials::TedlarReverse()
 	  0.0635,
 	  0.0637
 	};
-	               
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-        
-        tedlarReverse->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
-    return tedlarReverse;
+
+    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+    table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
 }
 
-G4OpticalSurface* artg4Materials::Millipore()
-// Diffuse reflection based on reflectivity measurements made on Millipore paper
-{
-   static bool init = true;
-   static G4OpticalSurface *millipore = new G4OpticalSurface("Millipore");
 
-   if( init ){
+G4OpticalSurface *buildTedlarReverse()
+// Optical surface for photons that would be entering the xtal
+{
+    G4OpticalSurface *tedlarReverse = new G4OpticalSurface("TedlarReverse");
 
       // type of optical surface
-      millipore->SetType(dielectric_dielectric);
-      millipore->SetModel(unified);
-      millipore->SetFinish(groundbackpainted);
-      double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
-      millipore->SetSigmaAlpha(facetAngleDistributionSigma);
+      tedlarReverse->SetType(dielectric_dielectric);
+      tedlarReverse->SetModel(unified);
+      tedlarReverse->SetFinish(groundfrontpainted);
+      tedlarReverse->SetMaterialPropertiesTable( propertiesTable("TedlarReverse") );
+
+    return tedlarReverse;
+}
 
-      // Material Properties table
+G4MaterialPropertiesTable *buildMilliporeProperties()
+{
+  // Material Properties table
 
-      const G4int nEntries = 24 ;
+  const G4int nEntries = 24 ;
 
-      G4double photonEnergy[ nEntries ] = 
+  G4double photonEnergy[ nEntries ] = 
 	{ 1.38*eV,
 	  1.55*eV,
 	  1.77*eV,
@@ -1363,8 +1260,8 @@ G4OpticalSurface* artg4Materials::Millipore()
 	  4.96*eV
 	 };
 
-      // From Detector Elog 584
-      G4double reflectivity[nEntries] = 
+  // From Detector Elog 584
+  G4double reflectivity[nEntries] = 
 	{
 	  0.972,
 	  0.982,
@@ -1392,58 +1289,57 @@ G4OpticalSurface* artg4Materials::Millipore()
 	  0.893
 	};
 
-      
-      // refractive index for air gap
-      G4double effectiveRefractiveIndex = 1.0;
-      G4double refractiveIndex[nEntries];
-      std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
+  // refractive index for air gap
+  G4double effectiveRefractiveIndex = 1.0;
+  G4double refractiveIndex[nEntries];
+  std::fill_n(refractiveIndex, nEntries, effectiveRefractiveIndex);
 
-      // xtal surface is faceted; all reflections are specular using surface normal from distribution      
-      G4double specularSpikeValue = 0.0;
-      G4double specularLobeValue = 1.0;
-      G4double backscatterValue = 0;
-      G4double specularSpike[nEntries];
-      G4double specularLobe[nEntries];
-      G4double backscatter[nEntries];
+  // xtal surface is faceted; all reflections are specular using surface normal from distribution      
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
 
-      std::fill_n(specularSpike, nEntries, specularSpikeValue);
-      std::fill_n(specularLobe, nEntries, specularLobeValue);
-      std::fill_n(backscatter, nEntries, backscatterValue);
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
 
-      G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-      table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
-      table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-      table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-      table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-      table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("RINDEX",                photonEnergy, refractiveIndex, nEntries ) ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+  table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
 
+  return table;
+}
 
-      millipore->SetMaterialPropertiesTable( table ) ;
 
-      init = false;
-   }
-  
+G4OpticalSurface *buildMillipore()
+// Diffuse reflection based on reflectivity measurements made on Millipore paper
+{
+   G4OpticalSurface *millipore = new G4OpticalSurface("Millipore");
+
+   // type of optical surface
+   millipore->SetType(dielectric_dielectric);
+   millipore->SetModel(unified);
+   millipore->SetFinish(groundbackpainted);
+   double facetAngleDistributionSigma = 0.07379; // based on slope calculations for PbF2 surface
+   millipore->SetSigmaAlpha(facetAngleDistributionSigma);
+   millipore->SetMaterialPropertiesTable( propertiesTable("Millipore") );
+
    return millipore;
 }
 
-G4OpticalSurface* artg4Materials::MilliporeReverse()
-// Optical surface for photons that would be entering the xtal
+G4MaterialPropertiesTable *buildMilliporeReverseProperties()
 {
-    static bool init = true;
-    static G4OpticalSurface *milliporeReverse = new G4OpticalSurface("MilliporeReverse");
-    
-    if( init ){
-        
-        // type of optical surface
-        milliporeReverse->SetType(dielectric_dielectric);
-        milliporeReverse->SetModel(unified);
-        milliporeReverse->SetFinish(groundfrontpainted);
-        
-        // Material Properties table
-        
-        const G4int nEntries = 24 ;
-        
-      G4double photonEnergy[ nEntries ] = 
+    // Material Properties table
+
+    const G4int nEntries = 24 ;
+
+  G4double photonEnergy[ nEntries ] = 
 	{ 1.38*eV,
 	  1.55*eV,
 	  1.77*eV,
@@ -1470,8 +1366,8 @@ G4OpticalSurface* artg4Materials::MilliporeReverse()
 	  4.96*eV
 	 };
 
-      // From Detector Elog 584
-      G4double reflectivity[nEntries] = 
+  // From Detector Elog 584
+  G4double reflectivity[nEntries] = 
 	{
 	  0.972,
 	  0.982,
@@ -1498,255 +1394,412 @@ G4OpticalSurface* artg4Materials::MilliporeReverse()
 	  0.951,
 	  0.893
 	};	               
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
-        
-        milliporeReverse->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
-    
+
+    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+    table->AddProperty("REFLECTIVITY",          photonEnergy, reflectivity,    nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildMilliporeReverse()
+// Optical surface for photons that would be entering the xtal
+{
+    G4OpticalSurface *milliporeReverse = new G4OpticalSurface("MilliporeReverse");
+
+      // type of optical surface
+      milliporeReverse->SetType(dielectric_dielectric);
+      milliporeReverse->SetModel(unified);
+      milliporeReverse->SetFinish(groundfrontpainted);
+      milliporeReverse->SetMaterialPropertiesTable( propertiesTable("MilliporeReverse") );
+
     return milliporeReverse;
 }
 
-G4OpticalSurface* artg4Materials::Open()
+G4OpticalSurface *buildOpen()
 // Optical surface for unwrapped PbF2 surface
 // Specular lobe reflections at xtal surface (finish type = ground)
 {
-  static bool init = true;
-  static G4OpticalSurface *open = new G4OpticalSurface("Open");
-
-  if( init ){
-    //type of optical surface
-    open->SetType(dielectric_dielectric);
-    open->SetModel(unified);
-    open->SetFinish(ground);
-    double facetAngleDistributionSigma = 0.07379; // based on slope calculations
-    open->SetSigmaAlpha(facetAngleDistributionSigma);
+  G4OpticalSurface *open = new G4OpticalSurface("Open");
 
-    init = false;
-  }
+  //type of optical surface
+  open->SetType(dielectric_dielectric);
+  open->SetModel(unified);
+  open->SetFinish(ground);
+  double facetAngleDistributionSigma = 0.07379; // based on slope calculations
+  open->SetSigmaAlpha(facetAngleDistributionSigma);
 
   return open;
 }
 
-G4OpticalSurface* artg4Materials::OpenReverse()
+G4OpticalSurface *buildOpenReverse()
 // Same as "Open" -- surface is the same no matter which way the photons pass through
 {
-    static bool init = true;
-    static G4OpticalSurface *openReverse = new G4OpticalSurface("OpenReverse");
-    
-    if( init ){
-        //type of optical surface
-        openReverse->SetType(dielectric_dielectric);
-        openReverse->SetModel(unified);
-        openReverse->SetFinish(ground);
-        double facetAngleDistributionSigma = 0.07379; // based on slope calculations
-        openReverse->SetSigmaAlpha(facetAngleDistributionSigma);
-        
-        init = false;
-    }
+    G4OpticalSurface *openReverse = new G4OpticalSurface("OpenReverse");
     
+    //type of optical surface
+    openReverse->SetType(dielectric_dielectric);
+    openReverse->SetModel(unified);
+    openReverse->SetFinish(ground);
+    double facetAngleDistributionSigma = 0.07379; // based on slope calculations
+    openReverse->SetSigmaAlpha(facetAngleDistributionSigma);
+
     return openReverse;
 }
 
-G4OpticalSurface* artg4Materials::GroundGlass()
+G4MaterialPropertiesTable *buildGroundGlassProperties()
+{
+  // Material Properties table
+
+  const G4int nEntries = 2 ;
+  G4double photonEnergy[ nEntries ] = { 1.0*eV, 6.0*eV };
+
+  // diffuse reflection probability is implicit:
+  //         diffuse = 1 - specularSpike - specularLobe - backscatter
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
+
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildGroundGlass()
 // Rough surface for diffuser
 {
-    static bool init = true;
-    static G4OpticalSurface *groundGlass = new G4OpticalSurface("GroundGlass");
+    G4OpticalSurface *groundGlass = new G4OpticalSurface("GroundGlass");
     
-    if( init ){
-        //type of optical surface
-        groundGlass->SetType(dielectric_dielectric);
-        groundGlass->SetModel(unified);
-        groundGlass->SetFinish(ground);
-        double facetAngleDistributionSigma = 12 * deg;
-           // sigma_alpha value for ground glass from Janecek and Williams,
-           // IEEE Transactions on Nuclear Science 57, 964 (2010)
-        groundGlass->SetSigmaAlpha(facetAngleDistributionSigma);
-        
-        
-        // Material Properties table
-        
-        const G4int nEntries = 2 ;
-        G4double photonEnergy[ nEntries ] = { 1.0*eV, 6.0*eV };
-
-        // diffuse reflection probability is implicit:
-        //         diffuse = 1 - specularSpike - specularLobe - backscatter
-        G4double specularSpikeValue = 0.0;
-        G4double specularLobeValue = 1.0;
-        G4double backscatterValue = 0;
-        G4double specularSpike[nEntries];
-        G4double specularLobe[nEntries];
-        G4double backscatter[nEntries];
-        
-        std::fill_n(specularSpike, nEntries, specularSpikeValue);
-        std::fill_n(specularLobe, nEntries, specularLobeValue);
-        std::fill_n(backscatter, nEntries, backscatterValue);
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-        table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-        table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-        
-        groundGlass->SetMaterialPropertiesTable( table ) ;
-
-        init = false;
-    }    
+    //type of optical surface
+    groundGlass->SetType(dielectric_dielectric);
+    groundGlass->SetModel(unified);
+    groundGlass->SetFinish(ground);
+    double facetAngleDistributionSigma = 12 * deg;
+       // sigma_alpha value for ground glass from Janecek and Williams,
+       // IEEE Transactions on Nuclear Science 57, 964 (2010)
+    groundGlass->SetSigmaAlpha(facetAngleDistributionSigma);
+    groundGlass->SetMaterialPropertiesTable( propertiesTable("GroundGlass") );
+
     return groundGlass;
 }
 
-G4OpticalSurface* artg4Materials::EtchedGlass()
+G4MaterialPropertiesTable *buildEtchedGlassProperties()
+{
+  // Material Properties table
+
+  const G4int nEntries = 2 ;
+  G4double photonEnergy[ nEntries ] = { 1.0*eV, 6.0*eV };
+
+  // diffuse reflection probability is implicit:
+  //         diffuse = 1 - specularSpike - specularLobe - backscatter
+  G4double specularSpikeValue = 0.0;
+  G4double specularLobeValue = 1.0;
+  G4double backscatterValue = 0;
+  G4double specularSpike[nEntries];
+  G4double specularLobe[nEntries];
+  G4double backscatter[nEntries];
+
+  std::fill_n(specularSpike, nEntries, specularSpikeValue);
+  std::fill_n(specularLobe, nEntries, specularLobeValue);
+  std::fill_n(backscatter, nEntries, backscatterValue);
+
+  G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
+  table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
+  table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
+  table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
+
+  return table;
+}
+
+
+G4OpticalSurface *buildEtchedGlass()
 // smooth surface for back of diffuser
 {
-    static bool init = true;
-    static G4OpticalSurface *etchedGlass = new G4OpticalSurface("EtchedGlass");
+    G4OpticalSurface *etchedGlass = new G4OpticalSurface("EtchedGlass");
     
-    if( init ){
-        //type of optical surface
-        etchedGlass->SetType(dielectric_dielectric);
-        etchedGlass->SetModel(unified);
-        etchedGlass->SetFinish(ground);
-        double facetAngleDistributionSigma = 4 * deg;
-          // sigma_alpha value for etched glass from Janecek and Williams,
-          // IEEE Transactions on Nuclear Science 57, 964 (2010)
-          // chose etched glass because similar to our measured PbF2 sigma_alpha
-        etchedGlass->SetSigmaAlpha(facetAngleDistributionSigma);
-        
-        
-        // Material Properties table
-        
-        const G4int nEntries = 2 ;
-        G4double photonEnergy[ nEntries ] = { 1.0*eV, 6.0*eV };
-        
-        // diffuse reflection probability is implicit:
-        //         diffuse = 1 - specularSpike - specularLobe - backscatter
-        G4double specularSpikeValue = 0.0;
-        G4double specularLobeValue = 1.0;
-        G4double backscatterValue = 0;
-        G4double specularSpike[nEntries];
-        G4double specularLobe[nEntries];
-        G4double backscatter[nEntries];
-        
-        std::fill_n(specularSpike, nEntries, specularSpikeValue);
-        std::fill_n(specularLobe, nEntries, specularLobeValue);
-        std::fill_n(backscatter, nEntries, backscatterValue);
-        
-        G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable() ;
-        table->AddProperty("SPECULARSPIKECONSTANT", photonEnergy, specularSpike,   nEntries );
-        table->AddProperty("SPECULARLOBECONSTANT",  photonEnergy, specularLobe,    nEntries );
-        table->AddProperty("BACKSCATTERCONSTANT",   photonEnergy, backscatter,     nEntries );
-        
-        etchedGlass->SetMaterialPropertiesTable( table ) ;
-        
-        init = false;
-    }
+    //type of optical surface
+    etchedGlass->SetType(dielectric_dielectric);
+    etchedGlass->SetModel(unified);
+    etchedGlass->SetFinish(ground);
+    double facetAngleDistributionSigma = 4 * deg;
+      // sigma_alpha value for etched glass from Janecek and Williams,
+      // IEEE Transactions on Nuclear Science 57, 964 (2010)
+      // chose etched glass because similar to our measured PbF2 sigma_alpha
+    etchedGlass->SetSigmaAlpha(facetAngleDistributionSigma);
+    etchedGlass->SetMaterialPropertiesTable( propertiesTable("EtchedGlass") );
+
     return etchedGlass;
 }
 
+} // end anonymous namespace
+
+
+//====================================================================//
+//=========================   THE REGISTRY   =========================//
+//====================================================================//
+
+// Every material and surface declared in Materials.hh appears exactly once
+// in these lists. They generate both the name lookup tables and the public
+// getters, so adding a material means writing its builder above and adding
+// one entry here.
+
+#define ARTG4_MATERIALS(X)                                              \
+  /*  Elements */                                                       \
+  X(Al) X(Ar) X(Be) X(C) X(Cr) X(Cu) X(F) X(Fe) X(H) X(Mg) X(N) X(Nb)    \
+  X(O) X(Pb) X(Sb) X(Si) X(Ti) X(W) X(Zn)                               \
+  /*  Compounds */                                                      \
+  X(CO2) X(C2H4) X(SiO2) X(Air) X(Al5052) X(Al6061) X(ArCO2)            \
+  X(FakeStrawElectronics) X(BC404Scintillator) X(BC408Scintillator)     \
+  X(BCF10ScintFiber) X(BicronBC630) X(Borosilicate) X(Brass)            \
+  X(Conductor) X(Epoxy) X(H2O) X(Kapton) X(MacorCeramic) X(Mylar)       \
+  X(NbTi) X(NusilLS5257) X(PbSb) X(Vacuum) X(Vacuum1) X(PbF2)           \
+  X(Quartz) X(SiPMSurfaceResin)
+
+#define ARTG4_OPTICAL_SURFACES(X)                                       \
+  X(PolishedMetal) X(PolishedMetalReverse) X(Specular)                  \
+  X(SpecularReverse) X(Diffuse) X(DiffuseReverse) X(Black)              \
+  X(BlackReverse) X(Tedlar) X(TedlarReverse) X(Millipore)               \
+  X(MilliporeReverse) X(Open) X(OpenReverse) X(GroundGlass)             \
+  X(EtchedGlass)
+
+// The materials and surfaces above that carry a properties table. The table
+// is registered under the name of its owner.
+#define ARTG4_PROPERTIES_TABLES(X)                                      \
+  X(BicronBC630) X(Borosilicate) X(Epoxy) X(NusilLS5257) X(Vacuum1)     \
+  X(PbF2) X(Quartz) X(SiPMSurfaceResin) X(Specular) X(SpecularReverse)  \
+  X(Diffuse) X(DiffuseReverse) X(Black) X(BlackReverse) X(Tedlar)       \
+  X(TedlarReverse) X(Millipore) X(MilliporeReverse) X(GroundGlass)      \
+  X(EtchedGlass)
 
 namespace{
 
-  struct map_t { G4String name; std::tr1::function<G4Material*()> func;};
-  struct opticalmap_t { G4String name; std::tr1::function<G4OpticalSurface*()> func;};
-
-#define MAKE_MAP_T(NAME) {""#NAME, artg4Materials::NAME}
-
-  map_t namemap_[] = {
-    //  Elements
-    MAKE_MAP_T(Al),
-    MAKE_MAP_T(Ar),
-    MAKE_MAP_T(Be),
-    MAKE_MAP_T(C),
-    MAKE_MAP_T(Cr),
-    MAKE_MAP_T(Cu),
-    MAKE_MAP_T(F),
-    MAKE_MAP_T(Fe),
-    MAKE_MAP_T(H),
-    MAKE_MAP_T(Mg),
-    MAKE_MAP_T(N),
-    MAKE_MAP_T(Nb),
-    MAKE_MAP_T(O),
-    MAKE_MAP_T(Pb),
-    MAKE_MAP_T(Sb),
-    MAKE_MAP_T(Si),
-    MAKE_MAP_T(Ti),
-    MAKE_MAP_T(W),
-    MAKE_MAP_T(Zn),
-    //  Compounds
-    MAKE_MAP_T(Air),
-    MAKE_MAP_T(Al5052),
-    MAKE_MAP_T(Al6061),
-    MAKE_MAP_T(BC404Scintillator),
-    MAKE_MAP_T(BC408Scintillator),
-    MAKE_MAP_T(BCF10ScintFiber),
-    MAKE_MAP_T(BicronBC630),
-    MAKE_MAP_T(Borosilicate),
-    MAKE_MAP_T(Brass),
-    MAKE_MAP_T(Conductor),
-    MAKE_MAP_T(Epoxy),
-    MAKE_MAP_T(H2O),
-    MAKE_MAP_T(Kapton),
-    MAKE_MAP_T(MacorCeramic),
-    MAKE_MAP_T(Mylar),
-    MAKE_MAP_T(NbTi),
-    MAKE_MAP_T(NusilLS5257),
-    MAKE_MAP_T(PbSb),
-    MAKE_MAP_T(Vacuum),
-    MAKE_MAP_T(Vacuum1),
-    MAKE_MAP_T(PbF2),
-    MAKE_MAP_T(Quartz),
-    MAKE_MAP_T(SiPMSurfaceResin),
+  // One lock for all construction. It is recursive because builders call
+  // other getters (Al6061 needs Mg, the scintillators need H and C, ...).
+  std::recursive_mutex& buildMutex() {
+    static std::recursive_mutex m;
+    return m;
+  }
+
+  // Lookups by name are case insensitive
+  std::string lookupKey(std::string const& name) {
+    return boost::algorithm::to_lower_copy(name);
+  }
+
+  // A hashed name -> object table where each object is built on first
+  // request. Entries are only added while the registry is being constructed,
+  // so after that the table itself is read-only and can be searched without
+  // locking.
+  template <typename T>
+  class Registry {
+  public:
+    typedef std::function<T*()> Builder;
+
+    // Register a builder under the given name
+    void add(std::string const& name, Builder build) {
+      std::unique_ptr<Entry> entry( new Entry(name, build) );
+      order_.push_back( entry.get() );
+      entries_[ lookupKey(name) ] = std::move(entry);
+    }
+
+    // Return the named object, building it if necessary. Returns 0 if
+    // nothing with that name was registered.
+    T* get(std::string const& name) {
+      auto entryIter = entries_.find( lookupKey(name) );
+      if ( entryIter == entries_.end() ) return 0;
+      return build( *(entryIter->second) );
+    }
+
+    // Build everything in registration order, timing each entry. Entries
+    // that were already built (possibly as a dependency of an earlier one)
+    // show up with essentially zero time.
+    void prebuild(std::vector<artg4Materials::BuildTiming> & timings) {
+      for ( auto entry : order_ ) {
+        auto start = std::chrono::steady_clock::now();
+        build(*entry);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        artg4Materials::BuildTiming timing = { entry->name, elapsed.count() };
+        timings.push_back(timing);
+      }
+    }
+
+    // Build the object with make instead of the registered builder. Returns
+    // false without calling make if nothing with that name was registered or
+    // the object has already been built, so a caller never ends up holding an
+    // object it has to throw away.
+    bool install(std::string const& name, Builder make) {
+      auto entryIter = entries_.find( lookupKey(name) );
+      if ( entryIter == entries_.end() ) return false;
+
+      Entry & entry = *(entryIter->second);
+      std::lock_guard<std::recursive_mutex> lock( buildMutex() );
+      if ( entry.built.load(std::memory_order_relaxed) ) return false;
+      T* obj = make();
+      if ( ! obj ) return false;
+      entry.built.store(obj, std::memory_order_release);
+      return true;
+    }
+
+    // The registered names, in registration order
+    std::vector<std::string> names() const {
+      std::vector<std::string> n;
+      for ( auto entry : order_ ) n.push_back(entry->name);
+      return n;
+    }
+
+  private:
+
+    struct Entry {
+      Entry(std::string const& n, Builder const& b) : name(n), builder(b), built(0) {}
+      std::string name;
+      Builder builder;
+      std::atomic<T*> built;
+    };
+
+    // Double-checked build: the common case (already built) is a single
+    // atomic load
+    T* build(Entry & entry) {
+      T* obj = entry.built.load(std::memory_order_acquire);
+      if ( obj ) return obj;
+
+      std::lock_guard<std::recursive_mutex> lock( buildMutex() );
+      obj = entry.built.load(std::memory_order_relaxed);
+      if ( ! obj ) {
+        obj = entry.builder();
+        entry.built.store(obj, std::memory_order_release);
+      }
+      return obj;
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<Entry> > entries_;
+    std::vector<Entry*> order_;
   };
 
-  opticalmap_t opticalmap_[] = {
-    MAKE_MAP_T(PolishedMetal),
-    MAKE_MAP_T(PolishedMetalReverse),
-    MAKE_MAP_T(Specular),
-    MAKE_MAP_T(SpecularReverse),
-    MAKE_MAP_T(Diffuse),
-    MAKE_MAP_T(DiffuseReverse),
-    MAKE_MAP_T(Black),
-    MAKE_MAP_T(BlackReverse),
-    MAKE_MAP_T(Tedlar),
-    MAKE_MAP_T(TedlarReverse),
-    MAKE_MAP_T(Millipore),
-    MAKE_MAP_T(MilliporeReverse),
-    MAKE_MAP_T(Open),
-    MAKE_MAP_T(OpenReverse),
-    MAKE_MAP_T(GroundGlass),
-    MAKE_MAP_T(EtchedGlass),
+#define ADD_TO_REGISTRY(NAME) add(#NAME, build##NAME);
+
+  struct MaterialRegistry : public Registry<G4Material> {
+    MaterialRegistry() { ARTG4_MATERIALS(ADD_TO_REGISTRY) }
+  };
+
+  struct OpticalSurfaceRegistry : public Registry<G4OpticalSurface> {
+    OpticalSurfaceRegistry() { ARTG4_OPTICAL_SURFACES(ADD_TO_REGISTRY) }
+  };
+
+#define ADD_PROPERTIES_TO_REGISTRY(NAME) add(#NAME, build##NAME##Properties);
+
+  struct PropertiesTableRegistry : public Registry<G4MaterialPropertiesTable> {
+    PropertiesTableRegistry() { ARTG4_PROPERTIES_TABLES(ADD_PROPERTIES_TO_REGISTRY) }
   };
+
+#undef ADD_TO_REGISTRY
+#undef ADD_PROPERTIES_TO_REGISTRY
+
+  // C++11 guarantees these are constructed exactly once, even if the first
+  // calls come from several threads at the same time.
+  MaterialRegistry& materialRegistry() {
+    static MaterialRegistry r;
+    return r;
+  }
+
+  OpticalSurfaceRegistry& opticalRegistry() {
+    static OpticalSurfaceRegistry r;
+    return r;
+  }
+
+  PropertiesTableRegistry& propertiesRegistry() {
+    static PropertiesTableRegistry r;
+    return r;
+  }
+
+  G4MaterialPropertiesTable *propertiesTable(std::string const& ownerName) {
+    return propertiesRegistry().get(ownerName);
+  }
 }
 
 
+//====================================================================//
+//=========================   PUBLIC GETTERS   =======================//
+//====================================================================//
+
+#define DEFINE_MATERIAL_GETTER(NAME)                                    \
+  G4Material *artg4Materials::NAME() { return materialRegistry().get(#NAME); }
+
+#define DEFINE_OPTICAL_GETTER(NAME)                                     \
+  G4OpticalSurface *artg4Materials::NAME() { return opticalRegistry().get(#NAME); }
+
+ARTG4_MATERIALS(DEFINE_MATERIAL_GETTER)
+ARTG4_OPTICAL_SURFACES(DEFINE_OPTICAL_GETTER)
+
+#undef DEFINE_MATERIAL_GETTER
+#undef DEFINE_OPTICAL_GETTER
+
+
 G4Material *artg4Materials::findByName(G4String name){
-  std::string sname(name);
-  for(int i=0; i!=sizeof(namemap_)/sizeof(namemap_[0]); ++i){
-    std::string mname(namemap_[i].name);
-    if( boost::algorithm::to_lower_copy(sname) ==
-	boost::algorithm::to_lower_copy(mname) ){
-      return (namemap_[i].func)();
-    }
-  }
-  throw artg4Materials::material_not_found(name);
-  return 0;
+  G4Material *material = materialRegistry().get(name);
+  if( ! material ) throw artg4Materials::material_not_found(name);
+  return material;
 }
 
 
 G4OpticalSurface *artg4Materials::findOpticalByName(G4String name){
-  std::string sname(name);
-  for(int i=0; i!=sizeof(opticalmap_)/sizeof(opticalmap_[0]); ++i){
-    std::string mname(opticalmap_[i].name);
-    if( boost::algorithm::to_lower_copy(sname) ==
-	boost::algorithm::to_lower_copy(mname) ){
-      return (opticalmap_[i].func)();
-    }
-  }
-  throw artg4Materials::material_not_found(name);
-  return 0;
+  G4OpticalSurface *surface = opticalRegistry().get(name);
+  if( ! surface ) throw artg4Materials::material_not_found(name);
+  return surface;
+}
+
+
+G4MaterialPropertiesTable *artg4Materials::findPropertiesTableByName(G4String name){
+  G4MaterialPropertiesTable *table = propertiesRegistry().get(name);
+  if( ! table ) throw artg4Materials::material_not_found(name);
+  return table;
+}
+
+
+bool artg4Materials::installPropertiesTable(G4String name, std::function<G4MaterialPropertiesTable*()> make){
+  return propertiesRegistry().install(name, make);
+}
+
+
+bool artg4Materials::installOpticalSurface(G4String name, std::function<G4OpticalSurface*()> make){
+  return opticalRegistry().install(name, make);
+}
+
+
+std::vector<std::string> artg4Materials::materialNames(){
+  return materialRegistry().names();
+}
+
+
+std::vector<std::string> artg4Materials::opticalSurfaceNames(){
+  return opticalRegistry().names();
+}
+
+
+std::vector<std::string> artg4Materials::propertiesTableNames(){
+  return propertiesRegistry().names();
+}
+
+
+artg4Materials::PrebuildReport artg4Materials::prebuildAll(){
+  PrebuildReport report;
+  auto start = std::chrono::steady_clock::now();
+
+  materialRegistry().prebuild(report.materials);
+  opticalRegistry().prebuild(report.surfaces);
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  report.totalSeconds = elapsed.count();
+  return report;
 }
 
 #include <sstream>
@@ -1757,4 +1810,3 @@ const char* artg4Materials::material_not_found::what() const throw() {
   message_ = o.str();
   return message_.c_str();
 }
-
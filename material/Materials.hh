@@ -16,6 +16,10 @@
 #include "Geant4/G4Material.hh"
 #include "Geant4/G4OpticalSurface.hh"
 
+#include <functional>
+#include <string>
+#include <vector>
+
 /** The namespace constructionMaterials contains getter functions
     provide material properties. 
 
@@ -24,8 +28,15 @@
     materials that the construction files can easily access during the
     creation of logical volumes.
 
-    If you add materials here, be sure to update the name->function
-    map at the bottom of constructionMaterials.cc
+    If you add materials here, be sure to add them to the
+    ARTG4_MATERIALS or ARTG4_OPTICAL_SURFACES lists at the bottom of
+    Materials.cc; those lists define the getters and the name lookup.
+    Optical properties tables are built separately and also need an
+    entry in ARTG4_PROPERTIES_TABLES.
+
+    Every getter builds its material on the first call and returns the
+    same pointer afterwards. All getters, the lookups by name and
+    prebuildAll() may be called concurrently from several threads.
 */
 
 namespace artg4Materials
@@ -99,10 +110,51 @@ namespace artg4Materials
   G4OpticalSurface *GroundGlass();
   G4OpticalSurface *EtchedGlass();
 
-  //  A lookup by name!
+  //  A lookup by name! (case insensitive, throws material_not_found)
   G4Material *findByName(G4String);
   G4OpticalSurface *findOpticalByName(G4String);
 
+  //  The names known to findByName and findOpticalByName
+  std::vector<std::string> materialNames();
+  std::vector<std::string> opticalSurfaceNames();
+
+  //  OPTICAL PROPERTIES TABLES
+  //  The tables attached to the optical materials and surfaces above,
+  //  looked up by the name of the material or surface that owns them.
+  G4MaterialPropertiesTable *findPropertiesTableByName(G4String);
+  std::vector<std::string> propertiesTableNames();
+
+  /** Build a table or surface with the given function (e.g. from data
+      read back by loadOpticalCache) instead of the usual builder. Must
+      be called before anything asks for it. Returns false, without
+      calling the function, if the name is unknown or the object has
+      already been built. G4OpticalSurfaces register themselves in a
+      global table on construction, so one must never be made unless
+      it is going to be kept. */
+  bool installPropertiesTable(G4String, std::function<G4MaterialPropertiesTable*()>);
+  bool installOpticalSurface(G4String, std::function<G4OpticalSurface*()>);
+
+  //  BULK CONSTRUCTION
+
+  /** How long it took to build one material or surface. */
+  struct BuildTiming {
+    std::string name;
+    double seconds;
+  };
+
+  /** The result of prebuildAll(). Materials built as ingredients of
+      an earlier entry show up in the list with (nearly) zero time. */
+  struct PrebuildReport {
+    std::vector<BuildTiming> materials;
+    std::vector<BuildTiming> surfaces;
+    double totalSeconds;
+  };
+
+  /** Build every material and optical surface now rather than on
+      first use, so the construction cost is paid (and can be
+      measured) once at startup. Calling it again is cheap. */
+  PrebuildReport prebuildAll();
+
 }
 
 #include <exception>
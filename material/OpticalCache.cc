@@ -0,0 +1,378 @@
+// Implementation of the artg4Materials optical cache. See OpticalCache.hh.
+//
+// File layout (host byte order):
+//
+//   char[8]   magic "ARTG4OPT"
+//   uint32    format version
+//   uint64    key            (opticalCacheKey())
+//   uint64    payload size in bytes
+//   uint64    payload checksum (artg4::Fingerprint of the payload)
+//   payload:
+//     uint32  number of tables
+//       string  owner name
+//       uint32  number of vector properties
+//         string name, uint32 n, double energies[n], double values[n]
+//       uint32  number of constant properties
+//         string name, double value
+//     uint32  number of surfaces
+//       string  name
+//       int32   type, model, finish
+//       double  sigmaAlpha, polish
+//       uint8   has properties table (the one stored under the same name)
+//
+// Strings are a uint32 length followed by the characters.
+
+#include "artg4/material/OpticalCache.hh"
+#include "artg4/material/Materials.hh"
+#include "artg4/util/Fingerprint.hh"
+
+#include "Geant4/G4MaterialPropertiesTable.hh"
+#include "Geant4/G4OpticalSurface.hh"
+#include "Geant4/G4Version.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Set by material/CMakeLists.txt to the MD5 of Materials.cc, so editing any
+// optical definition invalidates caches written by the previous build
+#ifdef ARTG4_MATERIALS_MD5
+#define ARTG4_STRINGIFY_(x) #x
+#define ARTG4_STRINGIFY(x) ARTG4_STRINGIFY_(x)
+#define ARTG4_MATERIALS_MD5_STRING ARTG4_STRINGIFY(ARTG4_MATERIALS_MD5)
+#else
+#define ARTG4_MATERIALS_MD5_STRING "unknown"
+#endif
+
+namespace {
+
+  const char magic[8] = { 'A','R','T','G','4','O','P','T' };
+  const std::uint32_t formatVersion = 1;
+
+  // Append plain values to a byte buffer
+  class Writer {
+  public:
+    template <typename T>
+    void put(T const& v) { buf_.append( reinterpret_cast<const char*>(&v), sizeof(T) ); }
+
+    void putString(std::string const& s) {
+      put( static_cast<std::uint32_t>(s.size()) );
+      buf_.append(s);
+    }
+
+    std::string const& buffer() const { return buf_; }
+
+  private:
+    std::string buf_;
+  };
+
+  // Read plain values back out of a byte buffer. Any read past the end
+  // sets the failed flag and returns zeros, so callers only need to check
+  // ok() once at the end.
+  class Reader {
+  public:
+    Reader(const char* data, std::size_t size) : data_(data), size_(size), pos_(0), failed_(false) {}
+
+    template <typename T>
+    T get() {
+      T v = T();
+      if ( failed_ || size_ - pos_ < sizeof(T) ) { failed_ = true; return v; }
+      std::memcpy(&v, data_ + pos_, sizeof(T));
+      pos_ += sizeof(T);
+      return v;
+    }
+
+    std::string getString() {
+      std::uint32_t n = get<std::uint32_t>();
+      if ( failed_ || size_ - pos_ < n ) { failed_ = true; return std::string(); }
+      std::string s(data_ + pos_, n);
+      pos_ += n;
+      return s;
+    }
+
+    bool ok() const { return ! failed_; }
+    bool atEnd() const { return pos_ == size_; }
+
+  private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_;
+    bool failed_;
+  };
+
+  void writeTable(Writer & w, std::string const& owner, G4MaterialPropertiesTable* table) {
+    w.putString(owner);
+
+    auto props = table->GetPropertiesMap();
+    w.put( static_cast<std::uint32_t>(props->size()) );
+    for ( auto const& prop : *props ) {
+      G4MaterialPropertyVector* vec = prop.second;
+      std::uint32_t n = vec->GetVectorLength();
+      w.putString(prop.first);
+      w.put(n);
+      for ( std::uint32_t i = 0; i < n; ++i ) w.put( static_cast<double>( vec->Energy(i) ) );
+      for ( std::uint32_t i = 0; i < n; ++i ) w.put( static_cast<double>( (*vec)[i] ) );
+    }
+
+    auto constProps = table->GetPropertiesCMap();
+    w.put( static_cast<std::uint32_t>(constProps->size()) );
+    for ( auto const& prop : *constProps ) {
+      w.putString(prop.first);
+      w.put( static_cast<double>(prop.second) );
+    }
+  }
+
+  // What a cache file holds, as plain data. The whole file is parsed into
+  // these before any Geant object is made, so a corrupt file installs
+  // nothing and no G4OpticalSurface (which registers itself in a global
+  // table) is ever constructed and then thrown away.
+  struct PropertyData {
+    std::string name;
+    std::vector<G4double> energies;
+    std::vector<G4double> values;
+  };
+
+  struct TableData {
+    std::string name;
+    std::vector<PropertyData> properties;
+    std::vector<std::pair<std::string, double> > constProperties;
+  };
+
+  struct SurfaceData {
+    std::string name;
+    std::int32_t type, model, finish;
+    double sigmaAlpha, polish;
+    bool hasTable;
+  };
+
+  void readTable(Reader & r, TableData & table) {
+    std::uint32_t nProps = r.get<std::uint32_t>();
+    for ( std::uint32_t p = 0; p < nProps && r.ok(); ++p ) {
+      PropertyData prop;
+      prop.name = r.getString();
+      std::uint32_t n = r.get<std::uint32_t>();
+      for ( std::uint32_t i = 0; i < n && r.ok(); ++i ) prop.energies.push_back( r.get<double>() );
+      for ( std::uint32_t i = 0; i < n && r.ok(); ++i ) prop.values.push_back( r.get<double>() );
+      if ( r.ok() ) table.properties.push_back( std::move(prop) );
+    }
+
+    std::uint32_t nConst = r.get<std::uint32_t>();
+    for ( std::uint32_t p = 0; p < nConst && r.ok(); ++p ) {
+      std::string name = r.getString();
+      double value = r.get<double>();
+      if ( r.ok() ) table.constProperties.push_back( std::make_pair(name, value) );
+    }
+  }
+
+  G4MaterialPropertiesTable* makeTable(TableData const& data) {
+    G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable();
+    for ( auto const& prop : data.properties ) {
+      // AddProperty copies the arrays, so it can take non-const pointers
+      // into our own copies
+      std::vector<G4double> energies( prop.energies ), values( prop.values );
+      table->AddProperty( prop.name.c_str(), energies.data(), values.data(), energies.size() );
+    }
+    for ( auto const& prop : data.constProperties ) {
+      table->AddConstProperty( prop.first.c_str(), prop.second );
+    }
+    return table;
+  }
+
+  G4OpticalSurface* makeSurface(SurfaceData const& data) {
+    G4OpticalSurface* surface = new G4OpticalSurface(data.name);
+    surface->SetType( static_cast<G4SurfaceType>(data.type) );
+    surface->SetModel( static_cast<G4OpticalSurfaceModel>(data.model) );
+    surface->SetFinish( static_cast<G4OpticalSurfaceFinish>(data.finish) );
+    surface->SetSigmaAlpha(data.sigmaAlpha);
+    surface->SetPolish(data.polish);
+    // Whichever table the registry ended up with, ours or a built one
+    if ( data.hasTable ) {
+      surface->SetMaterialPropertiesTable( artg4Materials::findPropertiesTableByName(data.name) );
+    }
+    return surface;
+  }
+}
+
+
+std::uint64_t artg4Materials::opticalCacheKey() {
+  artg4::Fingerprint f;
+  f.add(formatVersion).add(ARTG4_MATERIALS_MD5_STRING);
+
+  const std::int32_t g4Version = G4VERSION_NUMBER;
+  f.add(g4Version);
+
+  // Binary layout of this host
+  const std::uint32_t byteOrder = 0x01020304;
+  const std::uint32_t doubleSize = sizeof(double);
+  f.add(byteOrder).add(doubleSize);
+
+  for ( auto const& name : propertiesTableNames() ) f.add(name);
+  for ( auto const& name : opticalSurfaceNames() ) f.add(name);
+  return f.value();
+}
+
+
+bool artg4Materials::writeOpticalCache(std::string const& fileName, std::string & reason) {
+
+  Writer payload;
+
+  std::vector<std::string> tableNames = propertiesTableNames();
+  payload.put( static_cast<std::uint32_t>(tableNames.size()) );
+  for ( auto const& name : tableNames ) {
+    writeTable(payload, name, findPropertiesTableByName(name));
+  }
+
+  std::vector<std::string> surfaceNames = opticalSurfaceNames();
+  payload.put( static_cast<std::uint32_t>(surfaceNames.size()) );
+  for ( auto const& name : surfaceNames ) {
+    G4OpticalSurface* surface = findOpticalByName(name);
+    payload.putString(name);
+    payload.put( static_cast<std::int32_t>( surface->GetType() ) );
+    payload.put( static_cast<std::int32_t>( surface->GetModel() ) );
+    payload.put( static_cast<std::int32_t>( surface->GetFinish() ) );
+    payload.put( static_cast<double>( surface->GetSigmaAlpha() ) );
+    payload.put( static_cast<double>( surface->GetPolish() ) );
+    payload.put( static_cast<std::uint8_t>( surface->GetMaterialPropertiesTable() != 0 ) );
+  }
+
+  std::string const& body = payload.buffer();
+
+  Writer header;
+  for ( char c : magic ) header.put(c);
+  header.put(formatVersion);
+  header.put(opticalCacheKey());
+  header.put( static_cast<std::uint64_t>(body.size()) );
+  header.put( artg4::Fingerprint().add(body.data(), body.size()).value() );
+
+  // Write beside the target and rename, which is atomic on POSIX
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp." << getpid();
+
+  {
+    std::ofstream out( tmpName.str().c_str(), std::ios::binary | std::ios::trunc );
+    out.write( header.buffer().data(), header.buffer().size() );
+    out.write( body.data(), body.size() );
+    out.close();
+    if ( ! out ) {
+      std::remove( tmpName.str().c_str() );
+      reason = "could not write " + tmpName.str();
+      return false;
+    }
+  }
+
+  if ( std::rename( tmpName.str().c_str(), fileName.c_str() ) != 0 ) {
+    std::remove( tmpName.str().c_str() );
+    reason = "could not rename " + tmpName.str() + " to " + fileName;
+    return false;
+  }
+
+  return true;
+}
+
+
+bool artg4Materials::loadOpticalCache(std::string const& fileName, std::string & reason) {
+
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  if ( ! in ) {
+    reason = "no cache file " + fileName;
+    return false;
+  }
+  std::string contents( (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>() );
+
+  Reader header( contents.data(), contents.size() );
+  char fileMagic[8];
+  for ( char & c : fileMagic ) c = header.get<char>();
+  std::uint32_t version = header.get<std::uint32_t>();
+  std::uint64_t key = header.get<std::uint64_t>();
+  std::uint64_t payloadSize = header.get<std::uint64_t>();
+  std::uint64_t payloadHash = header.get<std::uint64_t>();
+
+  if ( ! header.ok() || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ) {
+    reason = fileName + " is not an optical cache file";
+    return false;
+  }
+  if ( version != formatVersion ) {
+    reason = fileName + " has an unknown format version";
+    return false;
+  }
+  if ( key != opticalCacheKey() ) {
+    reason = fileName + " was written for different optical definitions";
+    return false;
+  }
+
+  const std::size_t headerSize = sizeof(magic) + sizeof(version) + 3*sizeof(std::uint64_t);
+  if ( contents.size() - headerSize != payloadSize ||
+       artg4::Fingerprint().add(contents.data() + headerSize, payloadSize).value() != payloadHash ) {
+    reason = fileName + " is truncated or corrupt";
+    return false;
+  }
+
+  Reader r( contents.data() + headerSize, payloadSize );
+
+  std::vector<TableData> tables;
+  std::uint32_t nTables = r.get<std::uint32_t>();
+  for ( std::uint32_t t = 0; t < nTables && r.ok(); ++t ) {
+    TableData table;
+    table.name = r.getString();
+    readTable(r, table);
+    if ( r.ok() ) tables.push_back( std::move(table) );
+  }
+
+  std::vector<SurfaceData> surfaces;
+  std::uint32_t nSurfaces = r.get<std::uint32_t>();
+  for ( std::uint32_t s = 0; s < nSurfaces && r.ok(); ++s ) {
+    SurfaceData surface;
+    surface.name = r.getString();
+    surface.type = r.get<std::int32_t>();
+    surface.model = r.get<std::int32_t>();
+    surface.finish = r.get<std::int32_t>();
+    surface.sigmaAlpha = r.get<double>();
+    surface.polish = r.get<double>();
+    surface.hasTable = r.get<std::uint8_t>() != 0;
+    if ( ! r.ok() ) break;
+
+    if ( surface.hasTable ) {
+      // The table has to come from the same file
+      bool found = false;
+      for ( auto const& table : tables ) {
+        if ( table.name == surface.name ) found = true;
+      }
+      if ( ! found ) {
+        reason = fileName + " is missing the properties table of surface " + surface.name;
+        return false;
+      }
+    }
+    surfaces.push_back( std::move(surface) );
+  }
+
+  if ( ! r.ok() || ! r.atEnd() ) {
+    reason = fileName + " could not be parsed";
+    return false;
+  }
+
+  // The key covers the names, so everything read is known to the
+  // registries. An install only fails if the object was already built, in
+  // which case the built one is kept and ours is never made. Tables go in
+  // first so that surfaces can attach to them.
+  std::size_t rejected = 0;
+  for ( auto const& table : tables ) {
+    if ( ! installPropertiesTable( table.name, [&table]() { return makeTable(table); } ) ) ++rejected;
+  }
+  for ( auto const& surface : surfaces ) {
+    if ( ! installOpticalSurface( surface.name, [&surface]() { return makeSurface(surface); } ) ) ++rejected;
+  }
+
+  if ( rejected ) {
+    std::ostringstream o;
+    o << rejected << " optical tables or surfaces were already built before " << fileName << " was loaded";
+    reason = o.str();
+    return false;
+  }
+
+  return true;
+}
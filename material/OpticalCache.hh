@@ -0,0 +1,44 @@
+#ifndef ARTG4_OPTICALCACHE_HH
+#define ARTG4_OPTICALCACHE_HH
+
+/** @file OpticalCache.hh
+
+    Save and restore the optical properties tables and optical surfaces
+    of artg4Materials.
+
+    The optical tables are rebuilt from scratch in every job, which for
+    the reflectivity spectra is a noticeable part of startup. Instead,
+    one job can write them all to a binary file and later jobs read the
+    finished tables back and install them in the material registries
+    before anything asks for them.
+
+    A cache file is keyed by a hash of everything that determines its
+    contents: the MD5 of Materials.cc at build time, the Geant4 version,
+    the table and surface names and the binary layout (byte order and
+    sizeof(double)). A file with a different key, a bad checksum or an
+    unknown format is ignored, never partially used.
+*/
+
+#include <cstdint>
+#include <string>
+
+namespace artg4Materials {
+
+  /** The key a cache written by this build would carry. */
+  std::uint64_t opticalCacheKey();
+
+  /** Build every optical properties table and surface and write them
+      to fileName. The file is written next to its final location and
+      renamed into place, so concurrent jobs never see a partial file.
+      On failure returns false and says why in reason. */
+  bool writeOpticalCache(std::string const& fileName, std::string & reason);
+
+  /** Read fileName and install its tables and surfaces. Must be called
+      before any optical material or surface is built. Returns false,
+      with an explanation in reason, if the file is missing, stale or
+      corrupt; nothing is installed in that case. */
+  bool loadOpticalCache(std::string const& fileName, std::string & reason);
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+// Implementation of BackgroundLibrary and BackgroundLibraryBuilder
+
+#include "artg4/overlay/BackgroundLibrary.hh"
+
+#include "cetlib/exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  const char fileMagic[8] = { 'A','R','T','G','4','B','K','G' };
+  const std::uint32_t fileVersion = 1;
+
+  struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nCategories;
+    std::uint64_t nEvents;
+    std::uint64_t nRows;
+  };
+
+  template <typename T>
+  void writeColumn(std::ofstream & out, std::vector<T> const& column) {
+    out.write( reinterpret_cast<const char*>( column.data() ), column.size() * sizeof(T) );
+  }
+}
+
+const std::size_t artg4::BackgroundLibrary::categoryNameSize;
+
+
+artg4::BackgroundLibrary::BackgroundLibrary(std::string const& fileName) :
+  fileName_(fileName),
+  categories_(),
+  nEvents_(0),
+  nRows_(0),
+  data_(MAP_FAILED),
+  size_(0),
+  rowStart_(0),
+  time_(0), edep_(0), x_(0), y_(0), z_(0), weight_(0), volumeID_(0), pdgID_(0)
+{
+  int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd < 0 ) {
+    throw cet::exception("BackgroundLibrary") << "Cannot open background library " << fileName << ": "
+                                              << std::strerror(errno) << "\n";
+  }
+  struct stat info;
+  if ( fstat(fd, &info) == 0 && info.st_size > 0 ) {
+    size_ = info.st_size;
+    data_ = mmap( 0, size_, PROT_READ, MAP_SHARED, fd, 0 );
+  }
+  close(fd);
+  if ( data_ == MAP_FAILED ) {
+    throw cet::exception("BackgroundLibrary") << "Cannot map background library " << fileName << "\n";
+  }
+
+  // Check the header, then that the file is as long as it says
+  const char* bytes = static_cast<const char*>(data_);
+  FileHeader header;
+  bool valid = size_ >= sizeof(header);
+  if ( valid ) {
+    std::memcpy( &header, bytes, sizeof(header) );
+    valid = std::equal( fileMagic, fileMagic + sizeof(fileMagic), header.magic ) &&
+            header.version == fileVersion && header.nCategories > 0;
+  }
+  if ( ! valid ) {
+    munmap( data_, size_ );
+    throw cet::exception("BackgroundLibrary") << fileName << " is not a version " << fileVersion
+                                              << " background library\n";
+  }
+
+  // Counts too big for the file would overflow the offsets below
+  if ( header.nCategories > size_ / categoryNameSize || header.nRows > size_ / sizeof(double) ||
+       header.nEvents > size_ / sizeof(std::uint64_t) / header.nCategories ) {
+    munmap( data_, size_ );
+    throw cet::exception("BackgroundLibrary") << fileName << " is corrupt: its header counts are too big "
+                                              << "for its " << size_ << " bytes\n";
+  }
+
+  std::size_t offset = sizeof(header);
+  std::size_t namesOffset = offset;     offset += header.nCategories * categoryNameSize;
+  std::size_t rowStartOffset = offset;  offset += ( header.nEvents * header.nCategories + 1 ) * sizeof(std::uint64_t);
+  std::size_t timeOffset = offset;      offset += header.nRows * sizeof(double);
+  std::size_t floatsOffset = offset;    offset += 5 * header.nRows * sizeof(float);
+  std::size_t volumeIDOffset = offset;  offset += header.nRows * sizeof(std::uint32_t);
+  std::size_t pdgIDOffset = offset;     offset += header.nRows * sizeof(std::int32_t);
+  if ( offset != size_ ) {
+    munmap( data_, size_ );
+    throw cet::exception("BackgroundLibrary") << fileName << " is " << size_ << " bytes long, but its "
+                                              << "header says " << offset << "\n";
+  }
+
+  for ( std::uint32_t c = 0; c < header.nCategories; ++c ) {
+    const char* name = bytes + namesOffset + c * categoryNameSize;
+    categories_.push_back( std::string( name, strnlen(name, categoryNameSize) ) );
+  }
+  nEvents_ = header.nEvents;
+  nRows_ = header.nRows;
+
+  rowStart_ = reinterpret_cast<const std::uint64_t*>( bytes + rowStartOffset );
+  time_ = reinterpret_cast<const double*>( bytes + timeOffset );
+  const float* floats = reinterpret_cast<const float*>( bytes + floatsOffset );
+  edep_ = floats;
+  x_ = floats + nRows_;
+  y_ = floats + 2 * nRows_;
+  z_ = floats + 3 * nRows_;
+  weight_ = floats + 4 * nRows_;
+  volumeID_ = reinterpret_cast<const std::uint32_t*>( bytes + volumeIDOffset );
+  pdgID_ = reinterpret_cast<const std::int32_t*>( bytes + pdgIDOffset );
+
+  // Check that the row starts stay inside the columns, so that a damaged
+  // file can't send hits() off the end of the mapping
+  std::size_t nEntries = nEvents_ * categories_.size();
+  const char* problem = 0;
+  if ( rowStart_[0] != 0 || rowStart_[nEntries] != nRows_ ) {
+    problem = "row starts do not run from 0 to the number of rows";
+  }
+  for ( std::size_t e = 0; e < nEntries && ! problem; ++e ) {
+    if ( rowStart_[e + 1] < rowStart_[e] ) problem = "row starts decrease";
+  }
+  if ( problem ) {
+    munmap( data_, size_ );
+    throw cet::exception("BackgroundLibrary") << fileName << " is corrupt: " << problem << "\n";
+  }
+}
+
+artg4::BackgroundLibrary::~BackgroundLibrary() {
+  munmap( data_, size_ );
+}
+
+int artg4::BackgroundLibrary::categoryIndex(std::string const& category) const {
+  auto found = std::find( categories_.begin(), categories_.end(), category );
+  return found == categories_.end() ? -1 : found - categories_.begin();
+}
+
+artg4::BackgroundHits artg4::BackgroundLibrary::hits(std::size_t event, std::size_t category) const {
+  std::size_t entry = event * categories_.size() + category;
+  std::uint64_t first = rowStart_[entry];
+  BackgroundHits h = { static_cast<std::size_t>( rowStart_[entry + 1] - first ),
+                       time_ + first, edep_ + first, x_ + first, y_ + first, z_ + first,
+                       volumeID_ + first, pdgID_ + first, weight_ + first };
+  return h;
+}
+
+
+void artg4::BackgroundLibraryBuilder::Columns::append(Columns const& other) {
+  time.insert( time.end(), other.time.begin(), other.time.end() );
+  edep.insert( edep.end(), other.edep.begin(), other.edep.end() );
+  x.insert( x.end(), other.x.begin(), other.x.end() );
+  y.insert( y.end(), other.y.begin(), other.y.end() );
+  z.insert( z.end(), other.z.begin(), other.z.end() );
+  weight.insert( weight.end(), other.weight.begin(), other.weight.end() );
+  volumeID.insert( volumeID.end(), other.volumeID.begin(), other.volumeID.end() );
+  pdgID.insert( pdgID.end(), other.pdgID.begin(), other.pdgID.end() );
+}
+
+void artg4::BackgroundLibraryBuilder::Columns::clear() {
+  time.clear();
+  edep.clear();
+  x.clear();
+  y.clear();
+  z.clear();
+  weight.clear();
+  volumeID.clear();
+  pdgID.clear();
+}
+
+artg4::BackgroundLibraryBuilder::BackgroundLibraryBuilder(std::vector<std::string> const& categories) :
+  categories_(categories),
+  current_( categories.size() ),
+  all_(),
+  rowStart_(1, 0),
+  nEvents_(0)
+{
+  if ( categories_.empty() ) {
+    throw cet::exception("BackgroundLibrary") << "A background library needs at least one category\n";
+  }
+  for ( auto const& category : categories_ ) {
+    if ( category.empty() || category.size() >= BackgroundLibrary::categoryNameSize ) {
+      throw cet::exception("BackgroundLibrary") << "Category name '" << category << "' must have 1 to "
+                                                << BackgroundLibrary::categoryNameSize - 1
+                                                << " characters\n";
+    }
+  }
+}
+
+void artg4::BackgroundLibraryBuilder::add(std::size_t category, double time, float edep,
+                                          float x, float y, float z,
+                                          std::uint32_t volumeID, std::int32_t pdgID, float weight) {
+  Columns & c = current_.at(category);
+  c.time.push_back(time);
+  c.edep.push_back(edep);
+  c.x.push_back(x);
+  c.y.push_back(y);
+  c.z.push_back(z);
+  c.weight.push_back(weight);
+  c.volumeID.push_back(volumeID);
+  c.pdgID.push_back(pdgID);
+}
+
+void artg4::BackgroundLibraryBuilder::endEvent() {
+  for ( auto & columns : current_ ) {
+    all_.append(columns);
+    rowStart_.push_back( all_.time.size() );
+    columns.clear();
+  }
+  ++nEvents_;
+}
+
+void artg4::BackgroundLibraryBuilder::write(std::string const& fileName) const {
+  std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( ! out ) {
+    throw cet::exception("BackgroundLibrary") << "Cannot open " << fileName << " for writing\n";
+  }
+
+  FileHeader header;
+  std::copy( fileMagic, fileMagic + sizeof(fileMagic), header.magic );
+  header.version = fileVersion;
+  header.nCategories = categories_.size();
+  header.nEvents = nEvents_;
+  header.nRows = all_.time.size();
+  out.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+
+  for ( auto const& category : categories_ ) {
+    std::vector<char> name( BackgroundLibrary::categoryNameSize, 0 );
+    std::copy( category.begin(), category.end(), name.begin() );
+    out.write( name.data(), name.size() );
+  }
+  writeColumn(out, rowStart_);
+  writeColumn(out, all_.time);
+  writeColumn(out, all_.edep);
+  writeColumn(out, all_.x);
+  writeColumn(out, all_.y);
+  writeColumn(out, all_.z);
+  writeColumn(out, all_.weight);
+  writeColumn(out, all_.volumeID);
+  writeColumn(out, all_.pdgID);
+
+  out.close();
+  if ( ! out ) {
+    throw cet::exception("BackgroundLibrary") << "Error writing " << fileName << "\n";
+  }
+}
@@ -0,0 +1,121 @@
+// BackgroundLibrary - hits of pre-simulated background events, for overlay
+//
+// A background library holds, for each of a number of background events,
+// the hits each detector category had in it (see
+// @artg4/util/BackgroundHits.hh@ for how they are overlaid on simulated
+// events). It is written by BackgroundLibraryBuilder, usually through the
+// BackgroundLibraryMaker module, from the hit collections of a background
+// simulation.
+//
+// A library is read by mapping the file into memory: nothing is copied,
+// and the pages are shared by all the jobs on a machine that use the same
+// file.
+//
+// The file is native endian. After a header, it holds the category names,
+// the index of the first row of each (event, category) and then the
+// columns, each for all the rows.
+
+#ifndef BACKGROUNDLIBRARY_HH
+#define BACKGROUNDLIBRARY_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "artg4/util/BackgroundHits.hh"
+
+namespace artg4 {
+
+  class BackgroundLibrary {
+  public:
+
+    // Category names are stored in this many bytes, including the final 0
+    static const std::size_t categoryNameSize = 64;
+
+    // Map a library file. Throws cet::exception if it cannot be read or is
+    // not a library.
+    explicit BackgroundLibrary(std::string const& fileName);
+    ~BackgroundLibrary();
+
+    BackgroundLibrary(BackgroundLibrary const&) = delete;
+    BackgroundLibrary& operator=(BackgroundLibrary const&) = delete;
+
+    // The index of a category, or -1 if the library has no hits for it
+    int categoryIndex(std::string const& category) const;
+
+    // A category's hits in a background event (event < nEvents(), category
+    // < categories().size())
+    BackgroundHits hits(std::size_t event, std::size_t category) const;
+
+    std::vector<std::string> const& categories() const { return categories_; }
+    std::string const& fileName() const { return fileName_; }
+    std::size_t nEvents() const { return nEvents_; }
+    std::size_t nRows() const { return nRows_; }
+
+  private:
+    std::string fileName_;
+    std::vector<std::string> categories_;
+    std::size_t nEvents_;
+    std::size_t nRows_;
+
+    // The mapping
+    void* data_;
+    std::size_t size_;
+
+    // Into the mapping
+    const std::uint64_t* rowStart_;   // nEvents * nCategories + 1
+    const double* time_;
+    const float* edep_;
+    const float* x_;
+    const float* y_;
+    const float* z_;
+    const float* weight_;
+    const std::uint32_t* volumeID_;
+    const std::int32_t* pdgID_;
+  };
+
+
+  // Collects background events and writes them out as a library
+  class BackgroundLibraryBuilder {
+  public:
+
+    // Throws cet::exception if there are no categories or a name is too
+    // long
+    explicit BackgroundLibraryBuilder(std::vector<std::string> const& categories);
+
+    // Add a hit of the current background event
+    void add(std::size_t category, double time, float edep, float x, float y, float z,
+             std::uint32_t volumeID, std::int32_t pdgID, float weight);
+
+    // The current background event is complete (it may have no hits)
+    void endEvent();
+
+    std::size_t nEvents() const { return nEvents_; }
+    std::size_t nRows() const { return all_.time.size(); }
+
+    // Write the library. Throws cet::exception on failure.
+    void write(std::string const& fileName) const;
+
+  private:
+    struct Columns {
+      std::vector<double> time;
+      std::vector<float> edep, x, y, z, weight;
+      std::vector<std::uint32_t> volumeID;
+      std::vector<std::int32_t> pdgID;
+
+      void append(Columns const& other);
+      void clear();
+    };
+
+    std::vector<std::string> categories_;
+
+    // The current event, by category, and everything before it
+    std::vector<Columns> current_;
+    Columns all_;
+    std::vector<std::uint64_t> rowStart_;
+    std::size_t nEvents_;
+  };
+}
+
+#endif
@@ -0,0 +1,101 @@
+// BackgroundLibraryMaker writes a background library for overlay.
+//
+// Run it on the output of a background-only simulation. For each event it
+// copies the hits of the listed collections, a BasicSoAHitCollection or a
+// BasicQuantizedHitCollection each, into a BackgroundLibrary (see
+// @artg4/overlay/BackgroundLibrary.hh@), under the category of the
+// detector they are to be overlaid on. The library is written at the end of
+// the job.
+//
+//   physics: {
+//     analyzers: {
+//       backgroundLibrary: {
+//         module_type: BackgroundLibraryMaker
+//         libraryFile: "beamBackground.bkg"
+//         hitCollections: [ { category: "calo"  inputTag: "artg4:calo" },
+//                           { category: "tracker"  inputTag: "artg4:tracker" } ]
+//       }
+//     }
+//     path2: [ backgroundLibrary ]
+//     end_paths: [ path2 ]
+//   }
+//
+// An event that lacks a collection has no hits for that category.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Art includes
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Utilities/InputTag.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "artg4/overlay/BackgroundLibrary.hh"
+#include "artg4/util/SoAHitCollection.hh"
+#include "artg4/util/QuantizedHitCollection.hh"
+
+namespace artg4 {
+
+  class BackgroundLibraryMaker : public art::EDAnalyzer {
+  public:
+    explicit BackgroundLibraryMaker(fhicl::ParameterSet const &);
+    virtual ~BackgroundLibraryMaker() {}
+
+    virtual void analyze(art::Event const & e) override;
+    virtual void endJob() override;
+
+  private:
+    std::string libraryFile_;
+    std::vector<art::InputTag> inputTags_;
+    std::unique_ptr<BackgroundLibraryBuilder> builder_;
+  };
+}
+
+artg4::BackgroundLibraryMaker::BackgroundLibraryMaker(fhicl::ParameterSet const & p) :
+  art::EDAnalyzer(p),
+  libraryFile_( p.get<std::string>("libraryFile") ),
+  inputTags_(),
+  builder_()
+{
+  std::vector<std::string> categories;
+  for ( auto const& collection : p.get<std::vector<fhicl::ParameterSet> >("hitCollections") ) {
+    categories.push_back( collection.get<std::string>("category") );
+    inputTags_.push_back( art::InputTag( collection.get<std::string>("inputTag") ) );
+  }
+  builder_.reset( new BackgroundLibraryBuilder(categories) );
+}
+
+void artg4::BackgroundLibraryMaker::analyze(art::Event const & e) {
+  for ( std::size_t c = 0; c < inputTags_.size(); ++c ) {
+    art::Handle<BasicSoAHitCollection> soa;
+    art::Handle<BasicQuantizedHitCollection> quantized;
+    if ( e.getByLabel(inputTags_[c], soa) ) {
+      for ( std::size_t i = 0; i < soa->size(); ++i ) {
+        builder_->add( c, soa->time[i], soa->edep[i], soa->x[i], soa->y[i], soa->z[i],
+                       soa->volumeID[i], soa->pdgID[i], soa->rowWeight(i) );
+      }
+    }
+    else if ( e.getByLabel(inputTags_[c], quantized) ) {
+      for ( std::size_t i = 0; i < quantized->size(); ++i ) {
+        builder_->add( c, quantized->time(i), quantized->edep(i), quantized->x(i), quantized->y(i),
+                       quantized->z(i), quantized->volumeID(i), quantized->pdgID[i],
+                       quantized->rowWeight(i) );
+      }
+    }
+  }
+  builder_->endEvent();
+}
+
+void artg4::BackgroundLibraryMaker::endJob() {
+  builder_->write(libraryFile_);
+  mf::LogInfo("BackgroundLibraryMaker") << "Wrote " << builder_->nEvents() << " background events ("
+                                        << builder_->nRows() << " hits) to " << libraryFile_;
+}
+
+using artg4::BackgroundLibraryMaker;
+DEFINE_ART_MODULE(BackgroundLibraryMaker)
@@ -0,0 +1,38 @@
+// AcceptanceFilterSummary - what AcceptanceFilterService skipped in a run
+
+// Events and primaries that the acceptance filter did not let be tracked
+// are still counted in nEvents and nPrimaries, so that rates can be
+// normalized to everything that was generated.
+//
+// The summary is made by AcceptanceFilterService and put into the run.
+
+#ifndef ACCEPTANCEFILTERSUMMARY_HH
+#define ACCEPTANCEFILTERSUMMARY_HH
+
+#include <string>
+
+namespace artg4 {
+
+  class AcceptanceFilterSummary {
+  public:
+
+    AcceptanceFilterSummary() :
+      mapFile(), nEvents(0), nEventsSkipped(0), nPrimaries(0), nPrimariesDropped(0)
+    {}
+
+    virtual ~AcceptanceFilterSummary() {}
+
+    std::string mapFile;
+
+    unsigned int nEvents;             // generated
+    unsigned int nEventsSkipped;      // none of whose primaries were tracked
+    unsigned int nPrimaries;          // generated
+    unsigned int nPrimariesDropped;   // not tracked
+
+#ifndef __GCCXML__
+    unsigned int nEventsTracked() const { return nEvents - nEventsSkipped; }
+#endif
+  };
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Implementation of AcceptanceFilterService
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceFilter_service.hh"
+
+#include <vector>
+
+#include "Geant4/G4Event.hh"
+#include "Geant4/G4PrimaryVertex.hh"
+#include "Geant4/G4PrimaryParticle.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4DynamicParticle.hh"
+
+artg4::AcceptanceFilterService::AcceptanceFilterService(fhicl::ParameterSet const & p,
+                                                        art::ActivityRegistry &)
+  : PrimaryGeneratorActionBase(p.get<std::string>("name", "acceptanceFilter")),
+    StackingActionBase(p.get<std::string>("name", "acceptanceFilter")),
+    mapFile_( p.get<std::string>("mapFile") ),
+    map_(),
+    dropPrimaries_( p.get<bool>("dropPrimaries", false) ),
+    pdgIDs_(),
+    dropped_(),
+    summary_( new AcceptanceFilterSummary ),
+    logInfo_("AcceptanceFilter")
+{
+  map_.read(mapFile_);
+
+  std::vector<int> pdgIDs = p.get<std::vector<int> >("pdgIDs", std::vector<int>());
+  pdgIDs_.insert( pdgIDs.begin(), pdgIDs.end() );
+}
+
+artg4::AcceptanceFilterService::~AcceptanceFilterService()
+{}
+
+void artg4::AcceptanceFilterService::filterPrimaries(G4Event* event) {
+  dropped_.clear();
+
+  // The primaries out of the acceptance
+  std::vector<const G4PrimaryParticle*> outside;
+  unsigned int nPrimaries = 0;
+  for ( int v = 0; v < event->GetNumberOfPrimaryVertex(); ++v ) {
+    G4PrimaryVertex* vertex = event->GetPrimaryVertex(v);
+    for ( G4PrimaryParticle* particle = vertex->GetPrimary(); particle; particle = particle->GetNext() ) {
+      ++nPrimaries;
+      if ( ! pdgIDs_.empty() && pdgIDs_.find( particle->GetPDGcode() ) == pdgIDs_.end() ) continue;
+      if ( ! map_.accepted( vertex->GetPosition(), particle->GetMomentumDirection() ) ) {
+        outside.push_back(particle);
+      }
+    }
+  }
+
+  ++summary_->nEvents;
+  summary_->nPrimaries += nPrimaries;
+
+  // Either each primary on its own, or all of them or none
+  if ( dropPrimaries_ || outside.size() == nPrimaries ) {
+    dropped_.insert( outside.begin(), outside.end() );
+    summary_->nPrimariesDropped += outside.size();
+    if ( nPrimaries > 0 && outside.size() == nPrimaries ) ++summary_->nEventsSkipped;
+  }
+}
+
+bool artg4::AcceptanceFilterService::killNewTrack(const G4Track* track) {
+  if ( dropped_.empty() || track->GetParentID() != 0 ) return false;
+  return dropped_.count( track->GetDynamicParticle()->GetPrimaryParticle() ) > 0;
+}
+
+void artg4::AcceptanceFilterService::callArtProduces(art::EDProducer * producer) {
+  producer->produces<AcceptanceFilterSummary, art::InRun>( PrimaryGeneratorActionBase::myName() );
+}
+
+void artg4::AcceptanceFilterService::fillRunBeginWithArtStuff(art::Run &) {
+  summary_.reset( new AcceptanceFilterSummary );
+  summary_->mapFile = mapFile_;
+}
+
+void artg4::AcceptanceFilterService::fillRunEndWithArtStuff(art::Run & r) {
+  logInfo_ << "Acceptance filter in run " << r.id().run() << ": skipped " << summary_->nEventsSkipped
+           << " of " << summary_->nEvents << " events and dropped " << summary_->nPrimariesDropped
+           << " of " << summary_->nPrimaries << " primaries\n";
+
+  r.put( std::move(summary_), PrimaryGeneratorActionBase::myName() );
+
+  // See the comment in PhysicalVolumeStoreService::fillRunEndWithArtStuff
+  summary_.release();
+  summary_.reset( new AcceptanceFilterSummary );
+  summary_->mapFile = mapFile_;
+}
+
+using artg4::AcceptanceFilterService;
+DEFINE_ART_SERVICE(AcceptanceFilterService)
@@ -0,0 +1,112 @@
+// AcceptanceFilterService skips primaries that cannot reach the detector,
+// before any time is spent tracking them.
+
+// Once the event's primaries are generated, each one is looked up in an
+// acceptance map (see AcceptanceMap.hh, made by AcceptanceMapMakerService)
+// by its vertex and direction. By default the whole event is skipped if
+// none of its primaries is in the acceptance, and tracked in full
+// otherwise; with dropPrimaries, every primary out of the acceptance is
+// dropped on its own. Dropped primaries are killed when they are stacked,
+// so a skipped event costs next to nothing: it still goes through Geant
+// and into the Art event, just without any tracks or hits.
+
+// Only the particles in pdgIDs (if given) are ever dropped; the map is made
+// with straight rays, so leave out charged particles in a field.
+
+// The numbers of events and primaries generated and skipped are put into
+// the run as an AcceptanceFilterSummary (see AcceptanceFilterSummary.hh)
+// for normalization.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     AcceptanceFilterService: {
+//       @table::AcceptanceFilterDefaults
+//       mapFile: "acceptance.bin"
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action and instance name of the product.
+//       Default is 'acceptanceFilter'.
+// - mapFile (string): The map made by AcceptanceMapMakerService.
+// - dropPrimaries (bool): Drop each primary out of the acceptance, rather
+//       than only whole events. Default is false.
+// - pdgIDs (vector<int>): The particles that may be dropped. Default
+//       (empty) is all.
+
+// Include guard
+#ifndef ACCEPTANCEFILTER_SERVICE_HH
+#define ACCEPTANCEFILTER_SERVICE_HH
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base classes
+#include "artg4/actionBase/PrimaryGeneratorActionBase.hh"
+#include "artg4/actionBase/StackingActionBase.hh"
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceMap.hh"
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceFilterSummary.hh"
+
+class G4PrimaryParticle;
+
+namespace artg4 {
+
+  class AcceptanceFilterService : public PrimaryGeneratorActionBase, public StackingActionBase {
+  public:
+    AcceptanceFilterService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~AcceptanceFilterService();
+
+    // Decide which primaries to drop
+    virtual void filterPrimaries(G4Event*) override;
+
+    // Kill the dropped primaries
+    virtual bool killNewTrack(const G4Track*) override;
+
+    // Tell Art what we'll be producing
+    virtual void callArtProduces(art::EDProducer * producer) override;
+
+    // Start a new summary
+    virtual void fillRunBeginWithArtStuff(art::Run & r) override;
+
+    // Log the summary and put it into the run
+    virtual void fillRunEndWithArtStuff(art::Run & r) override;
+
+  private:
+
+    std::string mapFile_;
+    AcceptanceMap map_;
+    bool dropPrimaries_;
+    std::set<int> pdgIDs_;
+
+    // This event's dropped primaries
+    std::unordered_set<const G4PrimaryParticle*> dropped_;
+
+    // This run
+    std::unique_ptr<AcceptanceFilterSummary> summary_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::AcceptanceFilterService;
+DECLARE_ART_SERVICE(AcceptanceFilterService,LEGACY)
+
+#endif
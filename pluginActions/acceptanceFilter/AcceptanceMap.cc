@@ -0,0 +1,195 @@
+// Implementation of AcceptanceMap
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceMap.hh"
+
+#include "cetlib/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+namespace {
+
+  const char fileMagic[8] = { 'A','R','T','G','4','A','C','C' };
+  const std::uint32_t fileVersion = 1;
+
+  // A map has one byte per cell; more than this is a mistake
+  const std::size_t maxCells = std::size_t(1) << 30;
+
+  // The number of cells of a binning (bins of 0 count as 1). Multiplies up
+  // in size_t, checking each step against maxCells so that nothing can
+  // wrap. False if there would be more than maxCells.
+  bool countCells(artg4::AcceptanceMap::Binning const& binning, std::size_t & cells) {
+    cells = 1;
+    for ( unsigned int n : { binning.nX, binning.nY, binning.nZ, binning.nCosTheta, binning.nPhi } ) {
+      std::size_t factor = std::max(n, 1u);
+      if ( cells > maxCells / factor ) return false;
+      cells *= factor;
+    }
+    return true;
+  }
+
+  // Which of n equal bins x falls in, clamped to the range
+  unsigned int binOf(double x, double low, double high, unsigned int n) {
+    if ( n <= 1 || high <= low ) return 0;
+    int bin = static_cast<int>( (x - low) / (high - low) * n );
+    return static_cast<unsigned int>( std::max( 0, std::min( bin, static_cast<int>(n) - 1 ) ) );
+  }
+
+  bool inside(double x, double low, double high) { return x >= low && x <= high; }
+}
+
+
+artg4::AcceptanceMap::AcceptanceMap() :
+  low_(),
+  high_(),
+  binning_(),
+  accepted_()
+{
+  binning_.nX = binning_.nY = binning_.nZ = binning_.nCosTheta = binning_.nPhi = 0;
+}
+
+artg4::AcceptanceMap::AcceptanceMap(G4ThreeVector const& low, G4ThreeVector const& high,
+                                    Binning const& binning) :
+  low_(low),
+  high_(high),
+  binning_(binning),
+  accepted_()
+{
+  binning_.nX = std::max(binning_.nX, 1u);
+  binning_.nY = std::max(binning_.nY, 1u);
+  binning_.nZ = std::max(binning_.nZ, 1u);
+  binning_.nCosTheta = std::max(binning_.nCosTheta, 1u);
+  binning_.nPhi = std::max(binning_.nPhi, 1u);
+
+  std::size_t cells = 0;
+  if ( ! countCells(binning_, cells) ) {
+    throw cet::exception("AcceptanceMap") << "An acceptance map binned " << binning_.nX << " x "
+                                          << binning_.nY << " x " << binning_.nZ << " x "
+                                          << binning_.nCosTheta << " x " << binning_.nPhi
+                                          << " would have more than " << maxCells << " cells\n";
+  }
+  accepted_.assign( cells, 0 );
+}
+
+bool artg4::AcceptanceMap::accepted(G4ThreeVector const& position, G4ThreeVector const& direction) const {
+  if ( accepted_.empty() ) return true;
+  if ( ! inside( position.x(), low_.x(), high_.x() ) || ! inside( position.y(), low_.y(), high_.y() ) ||
+       ! inside( position.z(), low_.z(), high_.z() ) ) return true;
+
+  return accepted_[ cellIndex( binOf( position.x(), low_.x(), high_.x(), binning_.nX ),
+                               binOf( position.y(), low_.y(), high_.y(), binning_.nY ),
+                               binOf( position.z(), low_.z(), high_.z(), binning_.nZ ),
+                               binOf( direction.cosTheta(), -1., 1., binning_.nCosTheta ),
+                               binOf( direction.phi(), -M_PI, M_PI, binning_.nPhi ) ) ];
+}
+
+void artg4::AcceptanceMap::sampleCell(std::size_t cell, const double u[5], G4ThreeVector & position,
+                                      G4ThreeVector & direction) const {
+  unsigned int ip = cell % binning_.nPhi;         cell /= binning_.nPhi;
+  unsigned int ic = cell % binning_.nCosTheta;    cell /= binning_.nCosTheta;
+  unsigned int iz = cell % binning_.nZ;           cell /= binning_.nZ;
+  unsigned int iy = cell % binning_.nY;           cell /= binning_.nY;
+  unsigned int ix = cell;
+
+  G4ThreeVector size = high_ - low_;
+  position.set( low_.x() + size.x() * ( ix + u[0] ) / binning_.nX,
+                low_.y() + size.y() * ( iy + u[1] ) / binning_.nY,
+                low_.z() + size.z() * ( iz + u[2] ) / binning_.nZ );
+
+  double cosTheta = -1 + 2 * ( ic + u[3] ) / binning_.nCosTheta;
+  double sinTheta = std::sqrt( std::max( 0., 1 - cosTheta * cosTheta ) );
+  double phi = -M_PI + 2 * M_PI * ( ip + u[4] ) / binning_.nPhi;
+  direction.set( sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta );
+}
+
+void artg4::AcceptanceMap::widen() {
+  std::vector<unsigned char> widened(accepted_);
+  std::size_t nDirections = binning_.nCosTheta * binning_.nPhi;
+  int nc = binning_.nCosTheta, np = binning_.nPhi;
+
+  for ( std::size_t cell = 0; cell < accepted_.size(); ++cell ) {
+    if ( ! accepted_[cell] ) continue;
+    std::size_t vertexStart = cell - cell % nDirections;
+    int ic = ( cell % nDirections ) / np;
+    int ip = cell % np;
+    for ( int dc = -1; dc <= 1; ++dc ) {
+      if ( ic + dc < 0 || ic + dc >= nc ) continue;
+      for ( int dp = -1; dp <= 1; ++dp ) {
+        int jp = ( ip + dp + np ) % np;     // phi wraps around
+        widened[ vertexStart + ( ic + dc ) * np + jp ] = 1;
+      }
+    }
+  }
+  accepted_.swap(widened);
+}
+
+double artg4::AcceptanceMap::acceptedFraction() const {
+  if ( accepted_.empty() ) return 1;
+  return double( std::count( accepted_.begin(), accepted_.end(), 1 ) ) / accepted_.size();
+}
+
+
+void artg4::AcceptanceMap::write(std::string const& fileName) const {
+  std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( ! out ) {
+    throw cet::exception("AcceptanceMap") << "Cannot open " << fileName << " for writing\n";
+  }
+
+  out.write( fileMagic, sizeof(fileMagic) );
+  out.write( reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion) );
+
+  double box[6] = { low_.x(), low_.y(), low_.z(), high_.x(), high_.y(), high_.z() };
+  std::uint32_t bins[5] = { binning_.nX, binning_.nY, binning_.nZ, binning_.nCosTheta, binning_.nPhi };
+  out.write( reinterpret_cast<const char*>(box), sizeof(box) );
+  out.write( reinterpret_cast<const char*>(bins), sizeof(bins) );
+  out.write( reinterpret_cast<const char*>( accepted_.data() ), accepted_.size() );
+
+  out.close();
+  if ( ! out ) {
+    throw cet::exception("AcceptanceMap") << "Error writing " << fileName << "\n";
+  }
+}
+
+void artg4::AcceptanceMap::read(std::string const& fileName) {
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  if ( ! in ) {
+    throw cet::exception("AcceptanceMap") << "Cannot open acceptance map " << fileName << "\n";
+  }
+
+  char magic[8];
+  std::uint32_t version = 0;
+  in.read( magic, sizeof(magic) );
+  in.read( reinterpret_cast<char*>(&version), sizeof(version) );
+  if ( ! in || ! std::equal( magic, magic + sizeof(magic), fileMagic ) || version != fileVersion ) {
+    throw cet::exception("AcceptanceMap") << fileName << " is not a version " << fileVersion
+                                          << " acceptance map\n";
+  }
+
+  double box[6];
+  std::uint32_t bins[5];
+  in.read( reinterpret_cast<char*>(box), sizeof(box) );
+  in.read( reinterpret_cast<char*>(bins), sizeof(bins) );
+  if ( ! in ) {
+    throw cet::exception("AcceptanceMap") << fileName << " is truncated\n";
+  }
+
+  // Check the binning against what is in the file before allocating the map
+  Binning binning = { bins[0], bins[1], bins[2], bins[3], bins[4] };
+  std::size_t cells = 0;
+  std::streamoff headerEnd = in.tellg();
+  in.seekg( 0, std::ios::end );
+  std::streamoff fileSize = in.tellg();
+  in.seekg( headerEnd );
+  if ( ! countCells(binning, cells) || ! in || fileSize - headerEnd != std::streamoff(cells) ) {
+    throw cet::exception("AcceptanceMap") << fileName << " is corrupt: its binning does not match "
+                                          << "its size\n";
+  }
+
+  *this = AcceptanceMap( G4ThreeVector(box[0], box[1], box[2]), G4ThreeVector(box[3], box[4], box[5]), binning );
+  in.read( reinterpret_cast<char*>( accepted_.data() ), accepted_.size() );
+  if ( ! in ) {
+    throw cet::exception("AcceptanceMap") << fileName << " is truncated\n";
+  }
+}
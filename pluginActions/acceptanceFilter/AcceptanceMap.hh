@@ -0,0 +1,81 @@
+// AcceptanceMap - which primaries can reach the detector
+
+// The map is a grid over a primary's vertex position (a box, usually around
+// the target) and direction (cos theta and phi about the global z axis).
+// Each cell says whether a straight line from within the cell could reach
+// one of the detector's volumes. Maps are made by AcceptanceMapMakerService
+// with a ray scan of the geometry and used by AcceptanceFilterService to
+// skip primaries that cannot be seen.
+
+// Vertices outside the box count as accepted, so that the map never throws
+// away what it knows nothing about.
+
+#ifndef ACCEPTANCEMAP_HH
+#define ACCEPTANCEMAP_HH
+
+#include <string>
+#include <vector>
+
+#include "Geant4/G4ThreeVector.hh"
+
+namespace artg4 {
+
+  class AcceptanceMap {
+  public:
+
+    // How finely to bin
+    struct Binning {
+      unsigned int nX, nY, nZ;        // vertex position
+      unsigned int nCosTheta, nPhi;   // direction
+    };
+
+    // An empty map, which accepts everything
+    AcceptanceMap();
+
+    // A map of the box [low, high], with nothing accepted yet. Throws
+    // cet::exception if the binning would make the map unreasonably large.
+    AcceptanceMap(G4ThreeVector const& low, G4ThreeVector const& high, Binning const& binning);
+
+    // Whether a primary starting at position going in direction can reach
+    // the detector
+    bool accepted(G4ThreeVector const& position, G4ThreeVector const& direction) const;
+
+    // h3. For making the map
+
+    std::size_t nCells() const { return accepted_.size(); }
+
+    // A random vertex and direction within a cell, from five uniform random
+    // numbers in [0,1)
+    void sampleCell(std::size_t cell, const double u[5], G4ThreeVector & position,
+                    G4ThreeVector & direction) const;
+
+    void setAccepted(std::size_t cell, bool accepted) { accepted_[cell] = accepted; }
+
+    // Also accept the cells next to accepted ones in direction, as a margin
+    // for what the scan missed
+    void widen();
+
+    // The fraction of cells accepted
+    double acceptedFraction() const;
+
+    Binning const& binning() const { return binning_; }
+
+    // Read and write the binary map file. Both throw cet::exception on
+    // failure.
+    void read(std::string const& fileName);
+    void write(std::string const& fileName) const;
+
+  private:
+
+    std::size_t cellIndex(unsigned int ix, unsigned int iy, unsigned int iz,
+                          unsigned int ic, unsigned int ip) const {
+      return (((ix * binning_.nY + iy) * binning_.nZ + iz) * binning_.nCosTheta + ic) * binning_.nPhi + ip;
+    }
+
+    G4ThreeVector low_, high_;
+    Binning binning_;
+    std::vector<unsigned char> accepted_;
+  };
+}
+
+#endif
@@ -0,0 +1,109 @@
+// Implementation of AcceptanceMapMakerService
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceMapMaker_service.hh"
+
+#include <vector>
+
+#include "cetlib/exception.h"
+
+#include "Geant4/G4Navigator.hh"
+#include "Geant4/G4TransportationManager.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+#include "Geant4/Randomize.hh"
+#include "Geant4/geomdefs.hh"
+
+namespace {
+
+  G4ThreeVector pointFrom(fhicl::ParameterSet const& p, std::string const& key) {
+    std::vector<double> v = p.get<std::vector<double> >(key);
+    if ( v.size() != 3 ) {
+      throw cet::exception("AcceptanceMapMakerService") << key << " must have three elements\n";
+    }
+    return G4ThreeVector( v[0], v[1], v[2] ) * CLHEP::mm;
+  }
+
+  // Enough for any sane geometry; a ray that crosses more is given up on
+  const unsigned int maxCrossings = 100000;
+}
+
+artg4::AcceptanceMapMakerService::AcceptanceMapMakerService(fhicl::ParameterSet const & p,
+                                                            art::ActivityRegistry &)
+  : RunActionBase(p.get<std::string>("name", "acceptanceMapMaker")),
+    outputFile_( p.get<std::string>("outputFile") ),
+    low_( pointFrom(p, "vertexBoxLow") ),
+    high_( pointFrom(p, "vertexBoxHigh") ),
+    binning_(),
+    raysPerCell_( p.get<unsigned int>("raysPerCell", 10) ),
+    targetVolumes_(),
+    widen_( p.get<bool>("widen", true) ),
+    logInfo_("AcceptanceMapMaker")
+{
+  fhicl::ParameterSet b = p.get<fhicl::ParameterSet>("binning", fhicl::ParameterSet());
+  binning_.nX = b.get<unsigned int>("nX", 1);
+  binning_.nY = b.get<unsigned int>("nY", 1);
+  binning_.nZ = b.get<unsigned int>("nZ", 1);
+  binning_.nCosTheta = b.get<unsigned int>("nCosTheta", 50);
+  binning_.nPhi = b.get<unsigned int>("nPhi", 60);
+
+  std::vector<std::string> targets = p.get<std::vector<std::string> >("targetVolumes", std::vector<std::string>());
+  targetVolumes_.insert( targets.begin(), targets.end() );
+}
+
+artg4::AcceptanceMapMakerService::~AcceptanceMapMakerService()
+{}
+
+bool artg4::AcceptanceMapMakerService::isTarget(const G4VPhysicalVolume* pv) const {
+  const G4LogicalVolume* lv = pv->GetLogicalVolume();
+  if ( targetVolumes_.empty() ) return lv->GetSensitiveDetector() != 0;
+  return targetVolumes_.find( lv->GetName() ) != targetVolumes_.end();
+}
+
+bool artg4::AcceptanceMapMakerService::reachesTarget(G4Navigator & navigator, G4ThreeVector position,
+                                                     G4ThreeVector const& direction) const {
+  G4VPhysicalVolume* pv = navigator.LocateGlobalPointAndSetup(position, &direction, false, false);
+  for ( unsigned int i = 0; pv && i < maxCrossings; ++i ) {
+    if ( isTarget(pv) ) return true;
+
+    // On to the next boundary
+    double safety = 0;
+    double step = navigator.ComputeStep(position, direction, kInfinity, safety);
+    if ( step >= kInfinity ) return false;
+    position += step * direction;
+    navigator.SetGeometricallyLimitedStep();
+    pv = navigator.LocateGlobalPointAndSetup(position, &direction, true);
+  }
+  return false;
+}
+
+void artg4::AcceptanceMapMakerService::beginOfRunAction(const G4Run*) {
+  AcceptanceMap map(low_, high_, binning_);
+
+  // A navigator of our own so as not to disturb tracking
+  G4Navigator navigator;
+  navigator.SetWorldVolume( G4TransportationManager::GetTransportationManager()
+                              ->GetNavigatorForTracking()->GetWorldVolume() );
+
+  for ( std::size_t cell = 0; cell < map.nCells(); ++cell ) {
+    for ( unsigned int ray = 0; ray < raysPerCell_; ++ray ) {
+      double u[5] = { G4UniformRand(), G4UniformRand(), G4UniformRand(), G4UniformRand(), G4UniformRand() };
+      G4ThreeVector position, direction;
+      map.sampleCell(cell, u, position, direction);
+      if ( reachesTarget(navigator, position, direction) ) {
+        map.setAccepted(cell, true);
+        break;
+      }
+    }
+  }
+
+  double scanned = map.acceptedFraction();
+  if ( widen_ ) map.widen();
+  map.write(outputFile_);
+
+  logInfo_ << "Acceptance map: " << map.nCells() << " cells, " << 100 * scanned << "% reach the detector, "
+           << 100 * map.acceptedFraction() << "% accepted. Wrote " << outputFile_ << "\n";
+}
+
+using artg4::AcceptanceMapMakerService;
+DEFINE_ART_SERVICE(AcceptanceMapMakerService)
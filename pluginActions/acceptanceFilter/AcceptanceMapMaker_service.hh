@@ -0,0 +1,102 @@
+// AcceptanceMapMakerService makes an acceptance map (see AcceptanceMap.hh)
+// with a ray scan of the geometry, for use by AcceptanceFilterService.
+
+// At the beginning of the run, once the geometry is built, rays are cast
+// from every cell of the map: raysPerCell straight lines, each from a
+// random point in the cell's part of the vertex box in a random direction
+// within the cell. A ray is followed through the geometry, as a geantino
+// would be, until it enters one of the targetVolumes (by default, any
+// volume with a sensitive detector) or leaves the world. A cell is
+// accepted if any of its rays reached a target. The map is then widened by
+// one direction bin all round (unless widen is false) and written out.
+
+// Rays are straight, so the map is only right for particles that go
+// straight: neutrals, or charged particles where there is no field.
+
+// The scan takes nCells * raysPerCell rays, so keep the vertex grid coarse;
+// no events need to be simulated.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     AcceptanceMapMakerService: {
+//       @table::AcceptanceMapMakerDefaults
+//       outputFile: "acceptance.bin"
+//       vertexBoxLow: [ -10, -10, -50 ]
+//       vertexBoxHigh: [ 10, 10, 50 ]
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'acceptanceMapMaker'.
+// - outputFile (string): Where to write the map.
+// - vertexBoxLow, vertexBoxHigh (vector<double>, mm): The corners of the
+//       box of vertex positions the map covers.
+// - binning (table): nX, nY, nZ, nCosTheta and nPhi (ints).
+// - raysPerCell (unsigned): Default is 10.
+// - targetVolumes (vector<string>): Logical volumes that count as seeing
+//       the particle. Default is all sensitive volumes.
+// - widen (bool): Default is true.
+
+// Include guard
+#ifndef ACCEPTANCEMAPMAKER_SERVICE_HH
+#define ACCEPTANCEMAPMAKER_SERVICE_HH
+
+#include <set>
+#include <string>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Geant4/G4ThreeVector.hh"
+
+// Get the base class
+#include "artg4/actionBase/RunActionBase.hh"
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceMap.hh"
+
+class G4Navigator;
+class G4VPhysicalVolume;
+
+namespace artg4 {
+
+  class AcceptanceMapMakerService : public RunActionBase {
+  public:
+    AcceptanceMapMakerService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~AcceptanceMapMakerService();
+
+    // Scan the geometry and write the map
+    virtual void beginOfRunAction(const G4Run*) override;
+
+  private:
+
+    // Whether a straight line from position in direction enters a target
+    bool reachesTarget(G4Navigator & navigator, G4ThreeVector position,
+                       G4ThreeVector const& direction) const;
+
+    bool isTarget(const G4VPhysicalVolume* pv) const;
+
+    std::string outputFile_;
+    G4ThreeVector low_, high_;
+    AcceptanceMap::Binning binning_;
+    unsigned int raysPerCell_;
+    std::set<std::string> targetVolumes_;
+    bool widen_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::AcceptanceMapMakerService;
+DECLARE_ART_SERVICE(AcceptanceMapMakerService,LEGACY)
+
+#endif
@@ -0,0 +1,8 @@
+// classes.h
+
+#include <string>
+
+#include "art/Persistency/Common/Wrapper.h"
+
+#include "artg4/pluginActions/acceptanceFilter/AcceptanceFilterSummary.hh"
+template class art::Wrapper<artg4::AcceptanceFilterSummary>;
@@ -0,0 +1,37 @@
+// FastOpticsHits - optical photons detected by the fast optics simulation
+
+// FastOpticsService does not track optical photons. For every photon
+// created in a mapped volume it decides from the photon response map
+// whether the photon would have been detected and when. The result for an
+// event is one FastOpticsVolumeHits per volume placement that produced
+// photons.
+
+#ifndef FASTOPTICSHITS_HH
+#define FASTOPTICSHITS_HH
+
+#include <vector>
+
+namespace artg4 {
+
+  struct FastOpticsVolumeHits {
+
+    FastOpticsVolumeHits() :
+      volumeID(0),
+      nCreated(0),
+      times()
+    {}
+
+    // The placement, as an ID from the PhysicalVolumeStoreService
+    unsigned int volumeID;
+
+    // Optical photons created in this placement (and not tracked)
+    unsigned int nCreated;
+
+    // Detection time (global time, ns) of each photon judged detected
+    std::vector<float> times;
+  };
+
+  typedef std::vector<FastOpticsVolumeHits> FastOpticsHitCollection;
+}
+
+#endif
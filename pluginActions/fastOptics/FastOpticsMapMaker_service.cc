@@ -0,0 +1,121 @@
+// Implementation of FastOpticsMapMakerService
+
+#include "artg4/pluginActions/fastOptics/FastOpticsMapMaker_service.hh"
+
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4OpticalPhoton.hh"
+#include "Geant4/G4VTouchable.hh"
+#include "Geant4/G4NavigationHistory.hh"
+#include "Geant4/G4AffineTransform.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4VSolid.hh"
+#include "Geant4/G4VisExtent.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+#include <vector>
+
+artg4::FastOpticsMapMakerService::FastOpticsMapMakerService(fhicl::ParameterSet const & p,
+                                                            art::ActivityRegistry &)
+  : TrackingActionBase(p.get<std::string>("name", "fastOpticsMapMaker")),
+    outputFile_( p.get<std::string>("outputFile") ),
+    mappedVolumes_(),
+    detectingVolumes_(),
+    binning_(),
+    responseMap_(),
+    current_(),
+    suspended_(),
+    logInfo_("FastOpticsMapMaker")
+{
+  current_.map = 0;
+  current_.time = 0;
+
+  std::vector<std::string> mapped = p.get<std::vector<std::string> >("mappedVolumes");
+  std::vector<std::string> detecting = p.get<std::vector<std::string> >("detectingVolumes");
+  mappedVolumes_.insert( mapped.begin(), mapped.end() );
+  detectingVolumes_.insert( detecting.begin(), detecting.end() );
+
+  fhicl::ParameterSet b = p.get<fhicl::ParameterSet>("binning", fhicl::ParameterSet());
+  binning_.nX = b.get<unsigned int>("nX", 5);
+  binning_.nY = b.get<unsigned int>("nY", 5);
+  binning_.nZ = b.get<unsigned int>("nZ", 10);
+  binning_.nCosTheta = b.get<unsigned int>("nCosTheta", 10);
+  binning_.nPhi = b.get<unsigned int>("nPhi", 8);
+  binning_.nTime = b.get<unsigned int>("nTime", 40);
+  binning_.maxTime = b.get<double>("maxTime", 10.0) * CLHEP::ns;
+
+  // Find out about an impossible binning now rather than at the first photon
+  PhotonResponseMap::nCells(binning_);
+}
+
+artg4::FastOpticsMapMakerService::~FastOpticsMapMakerService()
+{}
+
+void artg4::FastOpticsMapMakerService::preUserTrackingAction(const G4Track* track) {
+  current_.map = 0;
+  if ( track->GetDefinition() != G4OpticalPhoton::Definition() ) return;
+
+  // A resumed photon carries on from where it really started
+  if ( track->GetCurrentStepNumber() > 0 ) {
+    auto found = suspended_.find( track->GetTrackID() );
+    if ( found != suspended_.end() ) {
+      current_ = found->second;
+      suspended_.erase(found);
+    }
+    return;
+  }
+  suspended_.erase( track->GetTrackID() );
+
+  const G4VTouchable* touchable = track->GetTouchable();
+  if ( ! touchable || ! touchable->GetVolume() ) return;
+
+  const G4LogicalVolume* lv = touchable->GetVolume()->GetLogicalVolume();
+  if ( mappedVolumes_.find( lv->GetName() ) == mappedVolumes_.end() ) return;
+
+  // The map is sized to the volume the first time a photon starts in it
+  G4VisExtent extent = lv->GetSolid()->GetExtent();
+  current_.map = &( responseMap_.addVolume( lv->GetName(),
+                                           G4ThreeVector( extent.GetXmin(), extent.GetYmin(), extent.GetZmin() ),
+                                           G4ThreeVector( extent.GetXmax(), extent.GetYmax(), extent.GetZmax() ),
+                                           binning_ ) );
+
+  const G4AffineTransform & toLocal = touchable->GetHistory()->GetTopTransform();
+  current_.pos = toLocal.TransformPoint( track->GetPosition() );
+  current_.dir = toLocal.TransformAxis( track->GetMomentumDirection() );
+  current_.time = track->GetGlobalTime();
+}
+
+void artg4::FastOpticsMapMakerService::postUserTrackingAction(const G4Track* track) {
+  if ( ! current_.map ) return;
+
+  // Not over yet; count it when it ends
+  if ( track->GetTrackStatus() == fSuspend ) {
+    suspended_[ track->GetTrackID() ] = current_;
+    current_.map = 0;
+    return;
+  }
+
+  // The volume the last step ended in; none if the photon left the world
+  const G4VPhysicalVolume* endVolume = track->GetStep()->GetPostStepPoint()->GetPhysicalVolume();
+  bool detected = endVolume &&
+    detectingVolumes_.find( endVolume->GetLogicalVolume()->GetName() ) != detectingVolumes_.end();
+
+  current_.map->fill( current_.pos, current_.dir, detected, track->GetGlobalTime() - current_.time );
+  current_.map = 0;
+}
+
+void artg4::FastOpticsMapMakerService::fillRunEndWithArtStuff(art::Run &) {
+  responseMap_.write(outputFile_);
+
+  for ( auto const& name : responseMap_.volumeNames() ) {
+    const PhotonResponseMap::VolumeMap* volumeMap = responseMap_.find(name);
+    logInfo_ << "Photon response map for " << name << ": " << volumeMap->nDetected()
+             << " of " << volumeMap->nGenerated() << " photons detected\n";
+  }
+  logInfo_ << "Wrote photon response maps to " << outputFile_ << "\n";
+}
+
+using artg4::FastOpticsMapMakerService;
+DEFINE_ART_SERVICE(FastOpticsMapMakerService)
@@ -0,0 +1,111 @@
+// FastOpticsMapMakerService fills photon response maps (see
+// PhotonResponseMap.hh) from full optical simulation, for use by
+// FastOpticsService.
+
+// For every optical photon that starts in one of the mappedVolumes, the
+// starting position and direction (in the volume's frame) and the creation
+// time are remembered. When the photon's track ends, it counts as detected
+// if its last step ended in one of the detectingVolumes (e.g. the SiPMs),
+// and the delay is the time it took to get there. The map is written at
+// the end of each run and holds everything accumulated so far.
+
+// Run this with the full optical physics and without FastOpticsService.
+// Use enough photons that the cells are well populated; cells without any
+// photons fall back to the volume average.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     FastOpticsMapMakerService: {
+//       outputFile: "caloPhotonResponse.bin"
+//       mappedVolumes: [ "xtal_L" ]
+//       detectingVolumes: [ "sipm_L" ]
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'fastOpticsMapMaker'.
+// - outputFile (string): Where to write the maps.
+// - mappedVolumes (vector<string>): Logical volumes to make maps for.
+// - detectingVolumes (vector<string>): Logical volumes that detect photons.
+// - binning (table): nX, nY, nZ, nCosTheta, nPhi, nTime (ints) and
+//       maxTime (ns). See FastOpticsMapMakerDefaults in actionDefaults.fcl.
+
+// Include guard
+#ifndef FASTOPTICSMAPMAKER_SERVICE_HH
+#define FASTOPTICSMAPMAKER_SERVICE_HH
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Geant4/G4ThreeVector.hh"
+
+// Get the base class
+#include "artg4/actionBase/TrackingActionBase.hh"
+
+#include "artg4/pluginActions/fastOptics/PhotonResponseMap.hh"
+
+namespace artg4 {
+
+  class FastOpticsMapMakerService : public TrackingActionBase {
+  public:
+    FastOpticsMapMakerService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~FastOpticsMapMakerService();
+
+    // Remember where a photon starts
+    virtual void preUserTrackingAction(const G4Track*) override;
+
+    // See where it ended and fill the map
+    virtual void postUserTrackingAction(const G4Track*) override;
+
+    // Write out the maps
+    virtual void fillRunEndWithArtStuff(art::Run &) override;
+
+  private:
+
+    std::string outputFile_;
+    std::set<std::string> mappedVolumes_;
+    std::set<std::string> detectingVolumes_;
+    PhotonResponseMap::Binning binning_;
+
+    PhotonResponseMap responseMap_;
+
+    // Where a photon that started in a mapped volume started
+    struct PhotonStart {
+      PhotonResponseMap::VolumeMap* map;
+      G4ThreeVector pos;
+      G4ThreeVector dir;
+      double time;
+    };
+
+    // The photon being tracked (map is 0 if it is not being mapped).
+    // Tracks are processed one at a time, so one is enough.
+    PhotonStart current_;
+
+    // Photons suspended (e.g. by time slicing) before they ended, by track
+    // ID. They come back through preUserTrackingAction when resumed, and
+    // are only counted once they really end.
+    std::unordered_map<int, PhotonStart> suspended_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::FastOpticsMapMakerService;
+DECLARE_ART_SERVICE(FastOpticsMapMakerService,LEGACY)
+
+#endif
@@ -0,0 +1,99 @@
+// Implementation of FastOpticsService
+
+#include "artg4/pluginActions/fastOptics/FastOptics_service.hh"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "artg4/pluginActions/physicalVolumeStore/physicalVolumeStore_service.hh"
+
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4OpticalPhoton.hh"
+#include "Geant4/G4VTouchable.hh"
+#include "Geant4/G4NavigationHistory.hh"
+#include "Geant4/G4AffineTransform.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/Randomize.hh"
+
+artg4::FastOpticsService::FastOpticsService(fhicl::ParameterSet const & p,
+                                            art::ActivityRegistry &)
+  : StackingActionBase(p.get<std::string>("name", "fastOptics")),
+    responseMap_(),
+    killUnmapped_( p.get<bool>("killUnmapped", false) ),
+    mapCache_(),
+    hits_( new FastOpticsHitCollection ),
+    hitIndex_(),
+    logInfo_("FastOptics")
+{
+  std::string mapFile = p.get<std::string>("responseMapFile");
+  responseMap_.read(mapFile);
+  logInfo_ << "Read photon response maps for " << responseMap_.volumeNames().size()
+           << " volumes from " << mapFile << "\n";
+}
+
+artg4::FastOpticsService::~FastOpticsService()
+{}
+
+const artg4::PhotonResponseMap::VolumeMap* artg4::FastOpticsService::mapFor(const G4LogicalVolume* lv) {
+  auto cached = mapCache_.find(lv);
+  if ( cached != mapCache_.end() ) return cached->second;
+
+  const PhotonResponseMap::VolumeMap* volumeMap = responseMap_.find( lv->GetName() );
+  mapCache_[lv] = volumeMap;
+  return volumeMap;
+}
+
+artg4::FastOpticsVolumeHits & artg4::FastOpticsService::hitsFor(const G4VPhysicalVolume* pv) {
+  auto found = hitIndex_.find(pv);
+  if ( found != hitIndex_.end() ) return (*hits_)[ found->second ];
+
+  art::ServiceHandle<PhysicalVolumeStoreService> pvs;
+  FastOpticsVolumeHits volumeHits;
+  volumeHits.volumeID = pvs->idGivenPhysicalVolume(pv);
+
+  hitIndex_[pv] = hits_->size();
+  hits_->push_back(volumeHits);
+  return hits_->back();
+}
+
+bool artg4::FastOpticsService::killNewTrack(const G4Track* track) {
+
+  if ( track->GetDefinition() != G4OpticalPhoton::Definition() ) return false;
+
+  // Optical processes give their secondaries the touchable of the step
+  // that made them; without one we cannot tell where the photon is
+  const G4VTouchable* touchable = track->GetTouchable();
+  if ( ! touchable || ! touchable->GetVolume() ) return killUnmapped_;
+
+  const G4VPhysicalVolume* pv = touchable->GetVolume();
+  const PhotonResponseMap::VolumeMap* volumeMap = mapFor( pv->GetLogicalVolume() );
+  if ( ! volumeMap ) return killUnmapped_;
+
+  const G4AffineTransform & toLocal = touchable->GetHistory()->GetTopTransform();
+  G4ThreeVector localPos = toLocal.TransformPoint( track->GetPosition() );
+  G4ThreeVector localDir = toLocal.TransformAxis( track->GetMomentumDirection() );
+
+  FastOpticsVolumeHits & volumeHits = hitsFor(pv);
+  ++volumeHits.nCreated;
+
+  if ( G4UniformRand() < volumeMap->efficiency(localPos, localDir) ) {
+    double delay = volumeMap->sampleDelay( localPos, localDir, G4UniformRand() );
+    volumeHits.times.push_back( track->GetGlobalTime() + delay );
+  }
+
+  return true;
+}
+
+void artg4::FastOpticsService::callArtProduces(art::EDProducer * producer) {
+  producer->produces<FastOpticsHitCollection>( myName() );
+}
+
+void artg4::FastOpticsService::fillEventWithArtStuff(art::Event & e) {
+  e.put( std::move(hits_), myName() );
+
+  // See the comment in PhysicalVolumeStoreService::fillRunEndWithArtStuff
+  hits_.release();
+  hits_.reset( new FastOpticsHitCollection );
+  hitIndex_.clear();
+}
+
+using artg4::FastOpticsService;
+DEFINE_ART_SERVICE(FastOpticsService)
@@ -0,0 +1,107 @@
+// FastOpticsService replaces optical photon tracking with a lookup in a
+// photon response map (see PhotonResponseMap.hh).
+
+// Every optical photon pushed onto the stack inside a mapped volume is
+// killed before it is tracked. Instead, the map gives the probability that
+// a photon with that starting position and direction would be detected and
+// the distribution of its detection delay; the photon is judged detected or
+// not with that probability and, if detected, gets a detection time. The
+// results are put into the event as a FastOpticsHitCollection.
+
+// Photons created in volumes without a map are tracked normally unless
+// killUnmapped is set.
+
+// Make the maps with FastOpticsMapMakerService, running the same geometry
+// with full optical simulation.
+
+// This action needs the PhysicalVolumeStoreService for the volume IDs.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     FastOpticsService: {
+//       responseMapFile: "caloPhotonResponse.bin"
+//     }
+//     PhysicalVolumeStoreService: {}
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action and instance name of the product.
+//       Default is 'fastOptics'.
+// - responseMapFile (string): The map made by FastOpticsMapMakerService.
+// - killUnmapped (bool): Also kill optical photons created in volumes
+//       without a map. Default is false.
+
+// Include guard
+#ifndef FASTOPTICS_SERVICE_HH
+#define FASTOPTICS_SERVICE_HH
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Event.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base class
+#include "artg4/actionBase/StackingActionBase.hh"
+
+#include "artg4/pluginActions/fastOptics/FastOpticsHits.hh"
+#include "artg4/pluginActions/fastOptics/PhotonResponseMap.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+namespace artg4 {
+
+  class FastOpticsService : public StackingActionBase {
+  public:
+    FastOpticsService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~FastOpticsService();
+
+    // Intercept optical photons
+    virtual bool killNewTrack(const G4Track*) override;
+
+    // Tell Art what we'll be producing
+    virtual void callArtProduces(art::EDProducer * producer) override;
+
+    // Put the detected photons into the event
+    virtual void fillEventWithArtStuff(art::Event & e) override;
+
+  private:
+
+    // The map for a logical volume, or 0. Looking maps up by name for every
+    // photon would be slow, so the answer is remembered per volume.
+    const PhotonResponseMap::VolumeMap* mapFor(const G4LogicalVolume* lv);
+
+    // The hits of a placement in the current event
+    FastOpticsVolumeHits & hitsFor(const G4VPhysicalVolume* pv);
+
+    PhotonResponseMap responseMap_;
+    bool killUnmapped_;
+
+    std::unordered_map<const G4LogicalVolume*, const PhotonResponseMap::VolumeMap*> mapCache_;
+
+    // This event's hits, and where each placement's entry is
+    std::unique_ptr<FastOpticsHitCollection> hits_;
+    std::unordered_map<const G4VPhysicalVolume*, std::size_t> hitIndex_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::FastOpticsService;
+DECLARE_ART_SERVICE(FastOpticsService,LEGACY)
+
+#endif
@@ -0,0 +1,286 @@
+// Implementation of PhotonResponseMap
+
+#include "artg4/pluginActions/fastOptics/PhotonResponseMap.hh"
+
+#include "cetlib/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+
+namespace {
+
+  const char fileMagic[8] = { 'A','R','T','G','4','P','R','M' };
+  // Version 2: the counts are uint64 rather than float
+  const std::uint32_t fileVersion = 2;
+
+  // Limits no real map comes near; beyond them a file or configuration is
+  // taken to be wrong rather than allocated. 2^28 counts are 2 GB.
+  const std::size_t maxCounts = std::size_t(1) << 28;
+  const std::uint32_t maxNameLength = 4096;
+
+  // The number of position and direction cells of a binning. Multiplies up in size_t,
+  // checking each step against maxCounts so that nothing can wrap. False
+  // if the cells times their delay bins would be more than maxCounts.
+  bool countCells(artg4::PhotonResponseMap::Binning const& binning, std::size_t & cells) {
+    std::size_t counts = 1;
+    for ( unsigned int n : { binning.nX, binning.nY, binning.nZ, binning.nCosTheta, binning.nPhi, binning.nTime } ) {
+      std::size_t factor = std::max(n, 1u);
+      if ( counts > maxCounts / factor ) return false;
+      counts *= factor;
+    }
+    cells = counts / std::max(binning.nTime, 1u);
+    return true;
+  }
+
+  // Which of n equal bins x falls in, clamped to the range
+  unsigned int binOf(double x, double low, double high, unsigned int n) {
+    if ( n <= 1 || high <= low ) return 0;
+    int bin = static_cast<int>( (x - low) / (high - low) * n );
+    return static_cast<unsigned int>( std::max( 0, std::min( bin, static_cast<int>(n) - 1 ) ) );
+  }
+
+  // Draw from a histogram of delays, spreading uniformly within the bin
+  double sampleHistogram(const std::uint64_t* hist, unsigned int n, double binWidth, double u) {
+    double total = 0;
+    for ( unsigned int i = 0; i < n; ++i ) total += hist[i];
+    if ( total <= 0 ) return 0;
+
+    double target = u * total;
+    for ( unsigned int i = 0; i < n; ++i ) {
+      double count = static_cast<double>( hist[i] );
+      if ( target < count ) return binWidth * ( i + target / count );
+      target -= count;
+    }
+    return binWidth * n;
+  }
+
+  template <typename T>
+  void writeValue(std::ofstream & out, T const& v) {
+    out.write( reinterpret_cast<const char*>(&v), sizeof(T) );
+  }
+
+  template <typename T>
+  void readValue(std::ifstream & in, T & v) {
+    in.read( reinterpret_cast<char*>(&v), sizeof(T) );
+  }
+
+  void writeCounts(std::ofstream & out, std::vector<std::uint64_t> const& v) {
+    writeValue( out, static_cast<std::uint64_t>(v.size()) );
+    out.write( reinterpret_cast<const char*>(v.data()), v.size() * sizeof(std::uint64_t) );
+  }
+
+  void readCounts(std::ifstream & in, std::vector<std::uint64_t> & v, std::string const& fileName) {
+    std::uint64_t n = 0;
+    readValue(in, n);
+    if ( ! in || n != v.size() ) {
+      throw cet::exception("PhotonResponseMap") << "Inconsistent array size in " << fileName << "\n";
+    }
+    in.read( reinterpret_cast<char*>(v.data()), v.size() * sizeof(std::uint64_t) );
+  }
+}
+
+
+std::size_t artg4::PhotonResponseMap::nCells(Binning const& binning) {
+  std::size_t cells = 0;
+  if ( ! countCells(binning, cells) ) {
+    throw cet::exception("PhotonResponseMap") << "A photon response map binned " << binning.nX << " x "
+                                              << binning.nY << " x " << binning.nZ << " x "
+                                              << binning.nCosTheta << " x " << binning.nPhi << " x "
+                                              << binning.nTime << " would have more than "
+                                              << maxCounts << " counts\n";
+  }
+  return cells;
+}
+
+
+artg4::PhotonResponseMap::VolumeMap::VolumeMap(G4ThreeVector const& low, G4ThreeVector const& high,
+                                               Binning const& binning) :
+  low_(low),
+  high_(high),
+  binning_(binning),
+  generated_(),
+  detected_(),
+  delays_(),
+  totalGenerated_(0),
+  totalDetected_(0),
+  totalDelays_()
+{
+  // Zero bins anywhere would make the map unusable
+  binning_.nX = std::max(binning_.nX, 1u);
+  binning_.nY = std::max(binning_.nY, 1u);
+  binning_.nZ = std::max(binning_.nZ, 1u);
+  binning_.nCosTheta = std::max(binning_.nCosTheta, 1u);
+  binning_.nPhi = std::max(binning_.nPhi, 1u);
+  binning_.nTime = std::max(binning_.nTime, 1u);
+
+  std::size_t cells = nCells(binning_);
+  generated_.assign(cells, 0);
+  detected_.assign(cells, 0);
+  delays_.assign(cells * binning_.nTime, 0);
+  totalDelays_.assign(binning_.nTime, 0);
+}
+
+unsigned int artg4::PhotonResponseMap::VolumeMap::cellIndex(G4ThreeVector const& localPos,
+                                                            G4ThreeVector const& localDir) const {
+  unsigned int ix = binOf( localPos.x(), low_.x(), high_.x(), binning_.nX );
+  unsigned int iy = binOf( localPos.y(), low_.y(), high_.y(), binning_.nY );
+  unsigned int iz = binOf( localPos.z(), low_.z(), high_.z(), binning_.nZ );
+  unsigned int ic = binOf( localDir.cosTheta(), -1., 1., binning_.nCosTheta );
+  unsigned int ip = binOf( localDir.phi(), -M_PI, M_PI, binning_.nPhi );
+
+  return (((ix * binning_.nY + iy) * binning_.nZ + iz) * binning_.nCosTheta + ic) * binning_.nPhi + ip;
+}
+
+void artg4::PhotonResponseMap::VolumeMap::fill(G4ThreeVector const& localPos, G4ThreeVector const& localDir,
+                                               bool detected, double delay) {
+  unsigned int cell = cellIndex(localPos, localDir);
+  generated_[cell] += 1;
+  totalGenerated_ += 1;
+
+  if ( detected ) {
+    unsigned int it = binOf( delay, 0., binning_.maxTime, binning_.nTime );
+    detected_[cell] += 1;
+    delays_[cell * binning_.nTime + it] += 1;
+    totalDetected_ += 1;
+    totalDelays_[it] += 1;
+  }
+}
+
+double artg4::PhotonResponseMap::VolumeMap::efficiency(G4ThreeVector const& localPos,
+                                                       G4ThreeVector const& localDir) const {
+  unsigned int cell = cellIndex(localPos, localDir);
+  if ( generated_[cell] > 0 ) return static_cast<double>( detected_[cell] ) / generated_[cell];
+  if ( totalGenerated_ > 0 ) return static_cast<double>( totalDetected_ ) / totalGenerated_;
+  return 0;
+}
+
+double artg4::PhotonResponseMap::VolumeMap::sampleDelay(G4ThreeVector const& localPos,
+                                                        G4ThreeVector const& localDir, double u) const {
+  unsigned int cell = cellIndex(localPos, localDir);
+  double binWidth = binning_.maxTime / binning_.nTime;
+  if ( detected_[cell] > 0 ) {
+    return sampleHistogram( &delays_[cell * binning_.nTime], binning_.nTime, binWidth, u );
+  }
+  return sampleHistogram( totalDelays_.data(), binning_.nTime, binWidth, u );
+}
+
+
+artg4::PhotonResponseMap::VolumeMap& artg4::PhotonResponseMap::addVolume(std::string const& lvName,
+                                                                         G4ThreeVector const& low,
+                                                                         G4ThreeVector const& high,
+                                                                         Binning const& binning) {
+  auto found = maps_.find(lvName);
+  if ( found != maps_.end() ) return found->second;
+  return maps_.insert( std::make_pair( lvName, VolumeMap(low, high, binning) ) ).first->second;
+}
+
+artg4::PhotonResponseMap::VolumeMap const* artg4::PhotonResponseMap::find(std::string const& lvName) const {
+  auto found = maps_.find(lvName);
+  return ( found == maps_.end() ) ? 0 : &(found->second);
+}
+
+std::vector<std::string> artg4::PhotonResponseMap::volumeNames() const {
+  std::vector<std::string> names;
+  for ( auto const& entry : maps_ ) names.push_back(entry.first);
+  return names;
+}
+
+
+void artg4::PhotonResponseMap::write(std::string const& fileName) const {
+  std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+  if ( ! out ) {
+    throw cet::exception("PhotonResponseMap") << "Cannot open " << fileName << " for writing\n";
+  }
+
+  out.write( fileMagic, sizeof(fileMagic) );
+  writeValue( out, fileVersion );
+  writeValue( out, static_cast<std::uint32_t>(maps_.size()) );
+
+  for ( auto const& entry : maps_ ) {
+    VolumeMap const& m = entry.second;
+    writeValue( out, static_cast<std::uint32_t>(entry.first.size()) );
+    out.write( entry.first.data(), entry.first.size() );
+
+    double extent[6] = { m.low_.x(), m.low_.y(), m.low_.z(), m.high_.x(), m.high_.y(), m.high_.z() };
+    out.write( reinterpret_cast<const char*>(extent), sizeof(extent) );
+
+    std::uint32_t bins[6] = { m.binning_.nX, m.binning_.nY, m.binning_.nZ,
+                              m.binning_.nCosTheta, m.binning_.nPhi, m.binning_.nTime };
+    out.write( reinterpret_cast<const char*>(bins), sizeof(bins) );
+    writeValue( out, m.binning_.maxTime );
+
+    writeValue( out, m.totalGenerated_ );
+    writeValue( out, m.totalDetected_ );
+    writeCounts( out, m.generated_ );
+    writeCounts( out, m.detected_ );
+    writeCounts( out, m.delays_ );
+    writeCounts( out, m.totalDelays_ );
+  }
+
+  out.close();
+  if ( ! out ) {
+    throw cet::exception("PhotonResponseMap") << "Error writing " << fileName << "\n";
+  }
+}
+
+void artg4::PhotonResponseMap::read(std::string const& fileName) {
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  if ( ! in ) {
+    throw cet::exception("PhotonResponseMap") << "Cannot open photon response map " << fileName << "\n";
+  }
+
+  char magic[8];
+  std::uint32_t version = 0, nVolumes = 0;
+  in.read( magic, sizeof(magic) );
+  readValue( in, version );
+  readValue( in, nVolumes );
+  if ( ! in || ! std::equal( magic, magic + sizeof(magic), fileMagic ) || version != fileVersion ) {
+    throw cet::exception("PhotonResponseMap") << fileName << " is not a version " << fileVersion
+                                              << " photon response map\n";
+  }
+
+  for ( std::uint32_t v = 0; v < nVolumes; ++v ) {
+    std::uint32_t nameLength = 0;
+    readValue( in, nameLength );
+    if ( ! in || nameLength > maxNameLength ) {
+      throw cet::exception("PhotonResponseMap") << fileName << " is corrupt: volume " << v
+                                                << " has a name " << nameLength << " bytes long\n";
+    }
+    std::string name( nameLength, ' ' );
+    in.read( &name[0], nameLength );
+
+    double extent[6];
+    std::uint32_t bins[6];
+    Binning binning;
+    in.read( reinterpret_cast<char*>(extent), sizeof(extent) );
+    in.read( reinterpret_cast<char*>(bins), sizeof(bins) );
+    readValue( in, binning.maxTime );
+    if ( ! in ) {
+      throw cet::exception("PhotonResponseMap") << fileName << " is truncated\n";
+    }
+    binning.nX = bins[0]; binning.nY = bins[1]; binning.nZ = bins[2];
+    binning.nCosTheta = bins[3]; binning.nPhi = bins[4]; binning.nTime = bins[5];
+    std::size_t cells = 0;
+    if ( ! countCells(binning, cells) ) {
+      throw cet::exception("PhotonResponseMap") << fileName << " is corrupt: volume " << name
+                                                << " has too many bins\n";
+    }
+
+    VolumeMap m( G4ThreeVector(extent[0], extent[1], extent[2]),
+                 G4ThreeVector(extent[3], extent[4], extent[5]), binning );
+    readValue( in, m.totalGenerated_ );
+    readValue( in, m.totalDetected_ );
+    readCounts( in, m.generated_, fileName );
+    readCounts( in, m.detected_, fileName );
+    readCounts( in, m.delays_, fileName );
+    readCounts( in, m.totalDelays_, fileName );
+    if ( ! in ) {
+      throw cet::exception("PhotonResponseMap") << fileName << " is truncated\n";
+    }
+
+    maps_.erase(name);
+    maps_.insert( std::make_pair(name, m) );
+  }
+}
@@ -0,0 +1,107 @@
+// PhotonResponseMap - what happens to an optical photon, given where it
+// starts and which way it goes
+
+// For each mapped logical volume (e.g. a calorimeter crystal) the map is a
+// grid over the photon's starting position and direction in the volume's
+// local frame. Each cell holds how many photons were generated there, how
+// many of them were detected and a histogram of the detection delay
+// (detection time minus creation time). Maps are filled from full optical
+// simulation by FastOpticsMapMakerService and used by FastOpticsService to
+// replace photon tracking with a lookup.
+
+// Volumes are keyed by logical volume name, so identical crystals placed
+// many times share one map.
+
+#ifndef PHOTONRESPONSEMAP_HH
+#define PHOTONRESPONSEMAP_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Geant4/G4ThreeVector.hh"
+
+namespace artg4 {
+
+  class PhotonResponseMap {
+  public:
+
+    // How finely to bin one volume
+    struct Binning {
+      unsigned int nX, nY, nZ;         // starting position
+      unsigned int nCosTheta, nPhi;    // starting direction (local z axis is the pole)
+      unsigned int nTime;              // delay histogram bins
+      double maxTime;                  // delays beyond this go in the last bin
+    };
+
+    // The number of position and direction cells of a binning (bins of 0
+    // count as 1). Throws cet::exception if the map, delay histograms
+    // included, would be unreasonably large (or overflow).
+    static std::size_t nCells(Binning const& binning);
+
+    // The response of one volume
+    class VolumeMap {
+    public:
+      VolumeMap(G4ThreeVector const& low, G4ThreeVector const& high, Binning const& binning);
+
+      // Record one photon (local coordinates)
+      void fill(G4ThreeVector const& localPos, G4ThreeVector const& localDir,
+                bool detected, double delay);
+
+      // Probability that a photon starting here is detected. Cells that were
+      // never filled fall back to the average over the whole volume.
+      double efficiency(G4ThreeVector const& localPos, G4ThreeVector const& localDir) const;
+
+      // Draw a detection delay for a photon starting here, given a uniform
+      // random number in [0,1)
+      double sampleDelay(G4ThreeVector const& localPos, G4ThreeVector const& localDir, double u) const;
+
+      Binning const& binning() const { return binning_; }
+      std::uint64_t nGenerated() const { return totalGenerated_; }
+      std::uint64_t nDetected() const { return totalDetected_; }
+
+    private:
+      friend class PhotonResponseMap;
+
+      unsigned int cellIndex(G4ThreeVector const& localPos, G4ThreeVector const& localDir) const;
+
+      G4ThreeVector low_, high_;
+      Binning binning_;
+
+      // Per cell. Integer counts, since a float stops counting at 2^24
+      // photons and a long mapping job gets there in the popular cells.
+      std::vector<std::uint64_t> generated_;
+      std::vector<std::uint64_t> detected_;
+      std::vector<std::uint64_t> delays_;   // nTime entries per cell
+
+      // Whole volume, for empty cells
+      std::uint64_t totalGenerated_;
+      std::uint64_t totalDetected_;
+      std::vector<std::uint64_t> totalDelays_;
+    };
+
+    PhotonResponseMap() : maps_() {}
+
+    // Add an empty map for a volume whose local extent is [low, high].
+    // Returns the existing map if the volume is already present.
+    VolumeMap& addVolume(std::string const& lvName, G4ThreeVector const& low,
+                         G4ThreeVector const& high, Binning const& binning);
+
+    // The map of a volume, or 0 if it is not mapped
+    VolumeMap const* find(std::string const& lvName) const;
+
+    std::vector<std::string> volumeNames() const;
+
+    // Read and write the binary map file. Both throw cet::exception on
+    // failure.
+    void read(std::string const& fileName);
+    void write(std::string const& fileName) const;
+
+  private:
+    std::map<std::string, VolumeMap> maps_;
+  };
+}
+
+#endif
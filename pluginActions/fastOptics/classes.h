@@ -0,0 +1,10 @@
+// classes.h
+
+#include <vector>
+
+#include "art/Persistency/Common/Wrapper.h"
+
+#include "artg4/pluginActions/fastOptics/FastOpticsHits.hh"
+
+template class std::vector<artg4::FastOpticsVolumeHits>;
+template class art::Wrapper< std::vector<artg4::FastOpticsVolumeHits> >;
@@ -0,0 +1,178 @@
+// Implementation of ImportanceBiasingService
+
+#include "artg4/pluginActions/importanceBiasing/ImportanceBiasing_service.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cetlib/exception.h"
+
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4DynamicParticle.hh"
+#include "Geant4/G4EventManager.hh"
+#include "Geant4/G4TrackingManager.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+#include "Geant4/Randomize.hh"
+
+artg4::ImportanceBiasingService::ImportanceBiasingService(fhicl::ParameterSet const & p,
+                                                          art::ActivityRegistry &)
+  : StackingActionBase(p.get<std::string>("name", "importanceBiasing")),
+    SteppingActionBase(p.get<std::string>("name", "importanceBiasing")),
+    defaultImportance_( p.get<double>("defaultImportance", 1.) ),
+    namedImportances_(),
+    importances_(),
+    maxSplit_( std::max( p.get<unsigned int>("maxSplit", 100), 1u ) ),
+    rouletteBelowImportance_(0),
+    rouletteBelowEnergy_(0),
+    roulettePdgIDs_(),
+    splitCopies_(),
+    rouletted_(),
+    nSplit_(0),
+    nCopies_(0),
+    nRouletteKilled_(0),
+    nRouletteSurvived_(0),
+    nSecondariesKilled_(0),
+    logInfo_("ImportanceBiasing")
+{
+  std::vector<fhicl::ParameterSet> importances =
+    p.get<std::vector<fhicl::ParameterSet> >("importances", std::vector<fhicl::ParameterSet>());
+  for ( auto const& entry : importances ) {
+    double value = entry.get<double>("importance");
+    if ( value < 0 ) {
+      throw cet::exception("ImportanceBiasingService") << "Importances cannot be negative\n";
+    }
+    for ( auto const& volume : entry.get<std::vector<std::string> >("volumes") ) {
+      namedImportances_[volume] = value;
+    }
+  }
+
+  fhicl::ParameterSet roulette = p.get<fhicl::ParameterSet>("secondaryRoulette", fhicl::ParameterSet());
+  rouletteBelowImportance_ = roulette.get<double>("belowImportance", 0.);
+  rouletteBelowEnergy_ = roulette.get<double>("belowKineticEnergy", 0.) * CLHEP::MeV;
+  std::vector<int> pdgIDs = roulette.get<std::vector<int> >("pdgIDs", std::vector<int>());
+  roulettePdgIDs_.insert( pdgIDs.begin(), pdgIDs.end() );
+}
+
+artg4::ImportanceBiasingService::~ImportanceBiasingService()
+{}
+
+double artg4::ImportanceBiasingService::importance(const G4VPhysicalVolume* pv) {
+  const G4LogicalVolume* lv = pv->GetLogicalVolume();
+  auto found = importances_.find(lv);
+  if ( found != importances_.end() ) return found->second;
+
+  // First time for this volume: look it up by name
+  auto named = namedImportances_.find( lv->GetName() );
+  double value = ( named != namedImportances_.end() ) ? named->second : defaultImportance_;
+  importances_[lv] = value;
+  return value;
+}
+
+bool artg4::ImportanceBiasingService::killNewTrack(const G4Track* track) {
+  // Tracks reclassified at a new stacking stage have had their turn
+  auto seen = rouletted_.find(track);
+  if ( seen != rouletted_.end() ) {
+    if ( seen->second == track->GetTrackID() ) return false;
+    rouletted_.erase(seen);
+  }
+
+  // Split copies only get their track ID once stacked, so they are
+  // recognized by address the first time
+  if ( splitCopies_.erase(track) ) {
+    rouletted_[track] = track->GetTrackID();
+    return false;
+  }
+  if ( rouletteBelowImportance_ <= 0 || track->GetParentID() == 0 || ! track->GetVolume() ) return false;
+
+  // A suspended track (e.g. by time slicing) comes back here; it has had
+  // its roulette already
+  if ( track->GetCurrentStepNumber() > 0 ) return false;
+  if ( rouletteBelowEnergy_ > 0 && track->GetKineticEnergy() >= rouletteBelowEnergy_ ) return false;
+  if ( ! roulettePdgIDs_.empty() &&
+       roulettePdgIDs_.find( track->GetDefinition()->GetPDGEncoding() ) == roulettePdgIDs_.end() ) return false;
+
+  double survival = importance( track->GetVolume() ) / rouletteBelowImportance_;
+  if ( survival >= 1 ) return false;
+  if ( G4UniformRand() >= survival ) {
+    ++nSecondariesKilled_;
+    return true;
+  }
+
+  // Geant hands stacking actions a const track, but the track itself is
+  // not const: the stack manager owns it and it has not been tracked yet,
+  // so changing its weight here is safe and is seen when it is tracked
+  const_cast<G4Track*>(track)->SetWeight( track->GetWeight() / survival );
+  rouletted_[track] = track->GetTrackID();
+  return false;
+}
+
+void artg4::ImportanceBiasingService::userSteppingAction(const G4Step* step) {
+  const G4StepPoint* post = step->GetPostStepPoint();
+  if ( post->GetStepStatus() != fGeomBoundary || ! post->GetPhysicalVolume() ) return;
+
+  G4Track* track = step->GetTrack();
+  if ( track->GetTrackStatus() != fAlive ) return;
+
+  double from = importance( step->GetPreStepPoint()->GetPhysicalVolume() );
+  double to = importance( post->GetPhysicalVolume() );
+  if ( from <= 0 || to == from ) return;
+
+  double ratio = to / from;
+  if ( ratio < 1 ) {
+    // Russian roulette
+    if ( G4UniformRand() < ratio ) {
+      track->SetWeight( track->GetWeight() / ratio );
+      ++nRouletteSurvived_;
+    }
+    else {
+      track->SetTrackStatus(fStopAndKill);
+      ++nRouletteKilled_;
+    }
+    return;
+  }
+
+  // Split into floor(ratio) or floor(ratio) + 1 tracks, ratio on average
+  unsigned int n = static_cast<unsigned int>(ratio);
+  if ( G4UniformRand() < ratio - n ) ++n;
+  n = std::min(n, maxSplit_);
+  if ( n < 2 ) return;
+
+  // The copies go in with this track's secondaries. G4Step only gives out
+  // a const view of them, so take the vector from the tracking manager,
+  // which stacks it when this track is done.
+  G4TrackVector* secondaries = G4EventManager::GetEventManager()->GetTrackingManager()->GimmeSecondaries();
+
+  double weight = track->GetWeight() / n;
+  track->SetWeight(weight);
+  for ( unsigned int i = 1; i < n; ++i ) {
+    G4Track* copy = new G4Track( new G4DynamicParticle( *track->GetDynamicParticle() ),
+                                 post->GetGlobalTime(), post->GetPosition() );
+    copy->SetWeight(weight);
+    copy->SetParentID( track->GetTrackID() );
+    copy->SetTouchableHandle( post->GetTouchableHandle() );
+    secondaries->push_back(copy);
+    splitCopies_.insert(copy);
+  }
+  ++nSplit_;
+  nCopies_ += n - 1;
+}
+
+void artg4::ImportanceBiasingService::fillRunEndWithArtStuff(art::Run & r) {
+  logInfo_ << "Importance biasing in run " << r.id().run() << ": " << nSplit_ << " tracks split into "
+           << nCopies_ << " more, " << nRouletteKilled_ << " killed and " << nRouletteSurvived_
+           << " survived roulette at boundaries, " << nSecondariesKilled_
+           << " secondaries killed by roulette\n";
+
+  nSplit_ = nCopies_ = nRouletteKilled_ = nRouletteSurvived_ = nSecondariesKilled_ = 0;
+  splitCopies_.clear();
+  rouletted_.clear();
+}
+
+using artg4::ImportanceBiasingService;
+DEFINE_ART_SERVICE(ImportanceBiasingService)
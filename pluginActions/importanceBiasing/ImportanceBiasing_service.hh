@@ -0,0 +1,140 @@
+// ImportanceBiasingService is geometric importance biasing: Russian
+// roulette and splitting, for shielding and background studies.
+
+// Every logical volume has an importance (defaultImportance unless listed
+// in importances). When a track crosses from a volume of importance I1
+// into one of importance I2:
+// - if I2 > I1 it is split into about I2/I1 tracks (at most maxSplit),
+//       each carrying its share of the weight. The copies start at the
+//       boundary as secondaries of the track, with no creator process.
+// - if I2 < I1 it plays Russian roulette: it survives with probability
+//       I2/I1, with its weight raised by I1/I2 if it does.
+// - if I2 is 0 it is killed.
+// So fewer tracks are followed where they matter little, and more where
+// they matter, while the weighted sums stay unbiased.
+
+// New secondaries can also play roulette when they are stacked, before
+// any time is spent on them (secondaryRoulette): a secondary born in a
+// volume of importance I below belowImportance survives with probability
+// I/belowImportance, with its weight raised to match. Each secondary
+// plays once: tracks that wait on the stack are classified again at every
+// new stacking stage, and those that already survived are let through.
+
+// The weights reach the hits through the track weight: SoASensitiveDetector
+// fills the weight column of SoAHitCollection (see
+// artg4/util/SoAHitCollection.hh). Detectors with hits of their own must
+// store G4Track::GetWeight too, and analyses must weight every hit.
+
+// The numbers of splits and roulette kills are logged at the end of each
+// run.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     ImportanceBiasingService: {
+//       @table::ImportanceBiasingDefaults
+//       importances: [ { volumes: [ "shieldOuter" ]  importance: 1 },
+//                      { volumes: [ "shieldMiddle" ] importance: 4 },
+//                      { volumes: [ "shieldInner" ]  importance: 16 } ]
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'importanceBiasing'.
+// - defaultImportance (double): For volumes not listed. Default is 1.
+// - importances (sequence of tables): Each has volumes (vector<string>,
+//       logical volume names) and importance (double, >= 0).
+// - maxSplit (unsigned): The most tracks one track is split into at a
+//       boundary. Default is 100.
+// - secondaryRoulette (table): belowImportance (double; 0, the default,
+//       switches it off), belowKineticEnergy (double, MeV; only
+//       secondaries below this, 0 for any) and pdgIDs (vector<int>; only
+//       these particles, empty for all).
+
+// Include guard
+#ifndef IMPORTANCEBIASING_SERVICE_HH
+#define IMPORTANCEBIASING_SERVICE_HH
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base classes
+#include "artg4/actionBase/StackingActionBase.hh"
+#include "artg4/actionBase/SteppingActionBase.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+namespace artg4 {
+
+  class ImportanceBiasingService : public StackingActionBase, public SteppingActionBase {
+  public:
+    ImportanceBiasingService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~ImportanceBiasingService();
+
+    // Roulette new secondaries
+    virtual bool killNewTrack(const G4Track*) override;
+
+    // Forget the last event's split copies and roulette survivors
+    virtual void prepareNewEvent() override { splitCopies_.clear(); rouletted_.clear(); }
+
+    // Split or roulette tracks crossing between volumes
+    virtual void userSteppingAction(const G4Step*) override;
+
+    // Log the counts
+    virtual void fillRunEndWithArtStuff(art::Run &) override;
+
+  private:
+
+    // The importance of a volume
+    double importance(const G4VPhysicalVolume* pv);
+
+    double defaultImportance_;
+    std::unordered_map<std::string, double> namedImportances_;
+    std::unordered_map<const G4LogicalVolume*, double> importances_;
+    unsigned int maxSplit_;
+
+    double rouletteBelowImportance_;
+    double rouletteBelowEnergy_;
+    std::set<int> roulettePdgIDs_;
+
+    // Copies made by splitting, so that they are not rouletted again when
+    // they are stacked
+    std::unordered_set<const G4Track*> splitCopies_;
+
+    // Tracks that have had their roulette (or are split copies) and so
+    // are let through when the stack reclassifies them at a new stage,
+    // with the track ID they had so that a later track reusing the memory
+    // of a deleted one is not mistaken for it
+    std::unordered_map<const G4Track*, int> rouletted_;
+
+    // This run
+    unsigned long nSplit_;
+    unsigned long nCopies_;
+    unsigned long nRouletteKilled_;
+    unsigned long nRouletteSurvived_;
+    unsigned long nSecondariesKilled_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::ImportanceBiasingService;
+DECLARE_ART_SERVICE(ImportanceBiasingService,LEGACY)
+
+#endif
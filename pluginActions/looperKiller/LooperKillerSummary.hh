@@ -0,0 +1,42 @@
+// LooperKillerSummary - what LooperKillerService killed in a run
+
+// One row per logical volume in which tracks were killed, one vector per
+// quantity. The n*Exceeded columns say which limit did it (each killed
+// track counts for the first limit it broke, in the order below).
+//
+// The summary is made by LooperKillerService and put into the run.
+
+#ifndef LOOPERKILLERSUMMARY_HH
+#define LOOPERKILLERSUMMARY_HH
+
+#include <string>
+#include <vector>
+
+namespace artg4 {
+
+  class LooperKillerSummary {
+  public:
+
+    LooperKillerSummary() :
+      volumeName(), nKilled(), energyKilled(),
+      nStepsExceeded(), nPathLengthExceeded(), nTurnsExceeded(), nProperTimeExceeded()
+    {}
+
+    virtual ~LooperKillerSummary() {}
+
+    std::vector<std::string> volumeName;
+    std::vector<unsigned int> nKilled;
+    std::vector<double> energyKilled;        // kinetic energy of the killed tracks (MeV)
+
+    std::vector<unsigned int> nStepsExceeded;
+    std::vector<unsigned int> nPathLengthExceeded;
+    std::vector<unsigned int> nTurnsExceeded;
+    std::vector<unsigned int> nProperTimeExceeded;
+
+#ifndef __GCCXML__
+    std::size_t size() const { return volumeName.size(); }
+#endif
+  };
+}
+
+#endif
@@ -0,0 +1,146 @@
+// Implementation of LooperKillerService
+
+#include "artg4/pluginActions/looperKiller/LooperKiller_service.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::LooperKillerService::Limits::Limits(fhicl::ParameterSet const& p) :
+  maxSteps( p.get<unsigned int>("maxSteps", 0) ),
+  maxPathLength( p.get<double>("maxPathLength", 0.) * CLHEP::mm ),
+  maxTurns( p.get<double>("maxTurns", 0.) ),
+  maxProperTime( p.get<double>("maxProperTime", 0.) * CLHEP::ns ),
+  belowKineticEnergy( p.get<double>("belowKineticEnergy", 0.) * CLHEP::MeV )
+{}
+
+artg4::LooperKillerService::LooperKillerService(fhicl::ParameterSet const & p,
+                                                art::ActivityRegistry &)
+  : SteppingActionBase(p.get<std::string>("name", "looperKiller")),
+    defaultLimits_(p),
+    particleLimits_(),
+    currentTrackID_(0),
+    currentLimits_(nullptr),
+    turnAngle_(0),
+    summary_( new LooperKillerSummary ),
+    rows_(),
+    logInfo_("LooperKiller")
+{
+  std::vector<fhicl::ParameterSet> perParticle =
+    p.get<std::vector<fhicl::ParameterSet> >("particleLimits", std::vector<fhicl::ParameterSet>());
+  for ( auto const& limits : perParticle ) {
+    for ( int pdgID : limits.get<std::vector<int> >("pdgIDs") ) {
+      particleLimits_[pdgID] = Limits(limits);
+    }
+  }
+}
+
+artg4::LooperKillerService::~LooperKillerService()
+{}
+
+std::size_t artg4::LooperKillerService::rowFor(const G4LogicalVolume* volume) {
+  auto found = rows_.find(volume);
+  if ( found != rows_.end() ) return found->second;
+
+  std::size_t row = summary_->size();
+  summary_->volumeName.push_back( volume ? std::string( volume->GetName() ) : std::string("none") );
+  summary_->nKilled.push_back(0);
+  summary_->energyKilled.push_back(0);
+  summary_->nStepsExceeded.push_back(0);
+  summary_->nPathLengthExceeded.push_back(0);
+  summary_->nTurnsExceeded.push_back(0);
+  summary_->nProperTimeExceeded.push_back(0);
+  rows_[volume] = row;
+  return row;
+}
+
+void artg4::LooperKillerService::userSteppingAction(const G4Step* step) {
+  G4Track* track = step->GetTrack();
+
+  // A new track: look up its limits and start its tallies. Step counts,
+  // path length and proper time are kept by the track itself.
+  if ( track->GetTrackID() != currentTrackID_ || track->GetCurrentStepNumber() == 1 ) {
+    currentTrackID_ = track->GetTrackID();
+    auto found = particleLimits_.find( track->GetDefinition()->GetPDGEncoding() );
+    currentLimits_ = found != particleLimits_.end() ? &found->second : &defaultLimits_;
+    if ( ! currentLimits_->any() ) currentLimits_ = nullptr;
+    turnAngle_ = 0;
+  }
+  if ( ! currentLimits_ ) return;
+  Limits const& limits = *currentLimits_;
+
+  if ( limits.maxTurns > 0 ) {
+    double cosAngle = step->GetPreStepPoint()->GetMomentumDirection().dot(
+                        step->GetPostStepPoint()->GetMomentumDirection() );
+    turnAngle_ += std::acos( std::max(-1., std::min(1., cosAngle)) );
+  }
+
+  if ( limits.belowKineticEnergy > 0 && track->GetKineticEnergy() >= limits.belowKineticEnergy ) return;
+
+  Limit broken = kNone;
+  if ( limits.maxSteps > 0 && static_cast<unsigned int>( track->GetCurrentStepNumber() ) > limits.maxSteps ) broken = kSteps;
+  else if ( limits.maxPathLength > 0 && track->GetTrackLength() > limits.maxPathLength ) broken = kPathLength;
+  else if ( limits.maxTurns > 0 && turnAngle_ > limits.maxTurns * 2 * M_PI ) broken = kTurns;
+  else if ( limits.maxProperTime > 0 && track->GetProperTime() > limits.maxProperTime ) broken = kProperTime;
+  if ( broken == kNone ) return;
+
+  track->SetTrackStatus(fStopAndKill);
+
+  const G4VPhysicalVolume* pv = step->GetPreStepPoint()->GetPhysicalVolume();
+  std::size_t row = rowFor( pv ? pv->GetLogicalVolume() : nullptr );
+  ++summary_->nKilled[row];
+  summary_->energyKilled[row] += track->GetKineticEnergy() / CLHEP::MeV;
+  switch ( broken ) {
+    case kSteps:       ++summary_->nStepsExceeded[row];      break;
+    case kPathLength:  ++summary_->nPathLengthExceeded[row]; break;
+    case kTurns:       ++summary_->nTurnsExceeded[row];      break;
+    case kProperTime:  ++summary_->nProperTimeExceeded[row]; break;
+    case kNone: break;
+  }
+
+  mf::LogDebug("LooperKiller") << "Killed track " << track->GetTrackID() << " ("
+                               << track->GetDefinition()->GetParticleName() << ") in "
+                               << summary_->volumeName[row] << " after "
+                               << track->GetCurrentStepNumber() << " steps";
+}
+
+void artg4::LooperKillerService::callArtProduces(art::EDProducer * producer) {
+  producer->produces<LooperKillerSummary, art::InRun>( myName() );
+}
+
+void artg4::LooperKillerService::fillRunBeginWithArtStuff(art::Run &) {
+  summary_.reset( new LooperKillerSummary );
+  rows_.clear();
+  currentTrackID_ = 0;
+  currentLimits_ = nullptr;
+}
+
+void artg4::LooperKillerService::fillRunEndWithArtStuff(art::Run & r) {
+
+  mf::LogInfo log("LooperKiller");
+  log << "Tracks killed in run " << r.id().run() << ":\n";
+  for ( std::size_t i = 0; i < summary_->size(); ++i ) {
+    log << "  " << summary_->volumeName[i] << ": " << summary_->nKilled[i] << " tracks, "
+        << summary_->energyKilled[i] << " MeV (steps " << summary_->nStepsExceeded[i]
+        << ", path length " << summary_->nPathLengthExceeded[i]
+        << ", turns " << summary_->nTurnsExceeded[i]
+        << ", proper time " << summary_->nProperTimeExceeded[i] << ")\n";
+  }
+
+  r.put( std::move(summary_), myName() );
+
+  // See the comment in PhysicalVolumeStoreService::fillRunEndWithArtStuff
+  summary_.release();
+  summary_.reset( new LooperKillerSummary );
+  rows_.clear();
+}
+
+using artg4::LooperKillerService;
+DEFINE_ART_SERVICE(LooperKillerService)
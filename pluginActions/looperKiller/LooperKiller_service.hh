@@ -0,0 +1,121 @@
+// LooperKillerService kills tracks that are going nowhere.
+
+// Charged tracks spiraling in a magnetic field, and tracks taking millions
+// of tiny steps at a volume boundary, can take most of an event's time
+// without depositing anything worth having. This stepping action follows
+// each track's step count, path length, number of turns (the total angle
+// its direction has turned through, over 2 pi) and proper time, and kills
+// the track once it goes over any of the limits for its particle type.
+
+// What was killed, per logical volume, is put into the run as a
+// LooperKillerSummary (see LooperKillerSummary.hh) and logged at the end of
+// the run, so that the limits can be tuned.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     LooperKillerService: @local::LooperKillerDefaults
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action and instance name of the product.
+//       Default is 'looperKiller'.
+// - maxSteps (unsigned), maxPathLength (double, mm), maxTurns (double),
+//       maxProperTime (double, ns): The limits for all particles. 0 (the
+//       default) means no limit.
+// - belowKineticEnergy (double, MeV): Only kill tracks with less kinetic
+//       energy than this. 0 (the default) means any energy.
+// - particleLimits (sequence of tables): Limits for particular particles,
+//       replacing the ones above. Each table has pdgIDs (vector<int>) and
+//       any of the parameters above; those not given are unlimited. E.g.
+//         particleLimits: [ { pdgIDs: [11, -11]  maxTurns: 20  belowKineticEnergy: 5 } ]
+
+// Include guard
+#ifndef LOOPERKILLER_SERVICE_HH
+#define LOOPERKILLER_SERVICE_HH
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base class
+#include "artg4/actionBase/SteppingActionBase.hh"
+
+#include "artg4/pluginActions/looperKiller/LooperKillerSummary.hh"
+
+class G4LogicalVolume;
+
+namespace artg4 {
+
+  class LooperKillerService : public SteppingActionBase {
+  public:
+    LooperKillerService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~LooperKillerService();
+
+    // Update the track's tallies and kill it if it is over a limit
+    virtual void userSteppingAction(const G4Step*) override;
+
+    // Tell Art what we'll be producing
+    virtual void callArtProduces(art::EDProducer * producer) override;
+
+    // Start a new summary
+    virtual void fillRunBeginWithArtStuff(art::Run & r) override;
+
+    // Log the summary and put it into the run
+    virtual void fillRunEndWithArtStuff(art::Run & r) override;
+
+  private:
+
+    struct Limits {
+      Limits() : maxSteps(0), maxPathLength(0), maxTurns(0), maxProperTime(0), belowKineticEnergy(0) {}
+      explicit Limits(fhicl::ParameterSet const& p);
+      bool any() const { return maxSteps > 0 || maxPathLength > 0 || maxTurns > 0 || maxProperTime > 0; }
+
+      unsigned int maxSteps;
+      double maxPathLength;
+      double maxTurns;
+      double maxProperTime;
+      double belowKineticEnergy;
+    };
+
+    // Which limit a track broke (indexes the summary's n*Exceeded columns)
+    enum Limit { kNone, kSteps, kPathLength, kTurns, kProperTime };
+
+    // The summary row for this volume
+    std::size_t rowFor(const G4LogicalVolume* volume);
+
+    Limits defaultLimits_;
+    std::unordered_map<int, Limits> particleLimits_;
+
+    // The track being stepped
+    int currentTrackID_;
+    const Limits* currentLimits_;
+    double turnAngle_;
+
+    // This run
+    std::unique_ptr<LooperKillerSummary> summary_;
+    std::unordered_map<const G4LogicalVolume*, std::size_t> rows_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::LooperKillerService;
+DECLARE_ART_SERVICE(LooperKillerService,LEGACY)
+
+#endif
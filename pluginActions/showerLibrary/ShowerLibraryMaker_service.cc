@@ -0,0 +1,142 @@
+// Implementation of ShowerLibraryMakerService
+
+#include "artg4/pluginActions/showerLibrary/ShowerLibraryMaker_service.hh"
+
+#include <cmath>
+
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4VTouchable.hh"
+#include "Geant4/G4NavigationHistory.hh"
+#include "Geant4/G4AffineTransform.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+namespace {
+
+  artg4::ShowerLibrary::Binning binningFrom(fhicl::ParameterSet const& p) {
+    artg4::ShowerLibrary::Binning binning;
+    binning.pdgIDs = p.get<std::vector<int> >("pdgIDs", std::vector<int>{ 22, 11, -11 });
+    binning.energyEdges = p.get<std::vector<double> >("energyEdges");
+    binning.nCosTheta = p.get<unsigned int>("nCosTheta", 4);
+    return binning;
+  }
+}
+
+artg4::ShowerLibraryMakerService::ShowerLibraryMakerService(fhicl::ParameterSet const & p,
+                                                            art::ActivityRegistry &)
+  : SteppingActionBase(p.get<std::string>("name", "showerLibraryMaker")),
+    outputFile_( p.get<std::string>("outputFile") ),
+    volumes_(),
+    spotSize_( p.get<double>("spotSize", 1.0) * CLHEP::mm ),
+    builder_( binningFrom(p), p.get<unsigned int>("maxShowersPerBin", 1000) ),
+    recordings_(),
+    showerOf_(),
+    logInfo_("ShowerLibraryMaker")
+{
+  std::vector<std::string> volumes = p.get<std::vector<std::string> >("volumes");
+  volumes_.insert( volumes.begin(), volumes.end() );
+}
+
+artg4::ShowerLibraryMakerService::~ShowerLibraryMakerService()
+{}
+
+int artg4::ShowerLibraryMakerService::startShower(const G4Step* step) {
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  if ( pre->GetStepStatus() != fGeomBoundary || ! pre->GetPhysicalVolume() ) return -1;
+  if ( volumes_.find( pre->GetPhysicalVolume()->GetLogicalVolume()->GetName() ) == volumes_.end() ) return -1;
+
+  // The entry angle is to the entered volume's local z axis
+  const G4Track* track = step->GetTrack();
+  int pdgID = track->GetDefinition()->GetPDGEncoding();
+  double energy = pre->GetKineticEnergy();
+  G4ThreeVector axis = pre->GetMomentumDirection();
+  double cosTheta = pre->GetTouchable()->GetHistory()->GetTopTransform().TransformAxis(axis).cosTheta();
+  if ( ! builder_.wants( pdgID, energy / CLHEP::MeV, cosTheta ) ) return -1;
+
+  Recording recording;
+  recording.pdgID = pdgID;
+  recording.energy = energy;
+  recording.cosTheta = cosTheta;
+  recording.origin = pre->GetPosition();
+  recording.axis = axis;
+  recording.across1 = axis.orthogonal().unit();
+  recording.across2 = axis.cross(recording.across1);
+  recording.t0 = pre->GetGlobalTime();
+  recordings_.push_back( std::move(recording) );
+  return recordings_.size() - 1;
+}
+
+void artg4::ShowerLibraryMakerService::userSteppingAction(const G4Step* step) {
+  const G4Track* track = step->GetTrack();
+
+  // Which shower this track is in: its own, or its parent's if it is new
+  int shower = -1;
+  auto found = showerOf_.find( track->GetTrackID() );
+  if ( found != showerOf_.end() ) {
+    shower = found->second;
+  }
+  else {
+    if ( track->GetCurrentStepNumber() == 1 ) {
+      auto parent = showerOf_.find( track->GetParentID() );
+      if ( parent != showerOf_.end() ) shower = parent->second;
+    }
+    if ( shower < 0 ) shower = startShower(step);
+    if ( shower < 0 ) return;
+    showerOf_[ track->GetTrackID() ] = shower;
+  }
+
+  double edep = step->GetTotalEnergyDeposit();
+  if ( edep <= 0 ) return;
+
+  // The middle of the step, in the shower's frame
+  Recording & recording = recordings_[shower];
+  G4ThreeVector where = 0.5 * ( step->GetPreStepPoint()->GetPosition() +
+                                step->GetPostStepPoint()->GetPosition() ) - recording.origin;
+  double along = where.dot(recording.axis);
+  double across1 = where.dot(recording.across1);
+  double across2 = where.dot(recording.across2);
+  double time = 0.5 * ( step->GetPreStepPoint()->GetGlobalTime() +
+                        step->GetPostStepPoint()->GetGlobalTime() ) - recording.t0;
+
+  std::array<int, 3> cell = { { static_cast<int>( std::floor(along / spotSize_) ),
+                                static_cast<int>( std::floor(across1 / spotSize_) ),
+                                static_cast<int>( std::floor(across2 / spotSize_) ) } };
+  SpotSum & sum = recording.spots[cell];
+  sum.along += edep * along;
+  sum.across1 += edep * across1;
+  sum.across2 += edep * across2;
+  sum.time += edep * time;
+  sum.energy += edep;
+}
+
+void artg4::ShowerLibraryMakerService::fillEventWithArtStuff(art::Event &) {
+  for ( auto const& recording : recordings_ ) {
+    std::vector<ShowerLibrary::Spot> spots;
+    spots.reserve( recording.spots.size() );
+    for ( auto const& cell : recording.spots ) {
+      SpotSum const& sum = cell.second;
+      ShowerLibrary::Spot spot = { static_cast<float>( sum.along / sum.energy / CLHEP::mm ),
+                                   static_cast<float>( sum.across1 / sum.energy / CLHEP::mm ),
+                                   static_cast<float>( sum.across2 / sum.energy / CLHEP::mm ),
+                                   static_cast<float>( sum.time / sum.energy / CLHEP::ns ),
+                                   static_cast<float>( sum.energy / recording.energy ) };
+      spots.push_back(spot);
+    }
+    builder_.add( recording.pdgID, recording.energy / CLHEP::MeV, recording.cosTheta, spots );
+  }
+
+  recordings_.clear();
+  showerOf_.clear();
+}
+
+void artg4::ShowerLibraryMakerService::fillRunEndWithArtStuff(art::Run &) {
+  builder_.write(outputFile_);
+  logInfo_ << "Wrote " << builder_.nShowers() << " showers to the shower library " << outputFile_ << "\n";
+}
+
+using artg4::ShowerLibraryMakerService;
+DEFINE_ART_SERVICE(ShowerLibraryMakerService)
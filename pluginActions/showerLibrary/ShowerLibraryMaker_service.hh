@@ -0,0 +1,130 @@
+// ShowerLibraryMakerService records showers from full simulation into a
+// shower library (see artg4/fastSim/ShowerLibrary.hh), for replay by
+// ShowerLibraryModel.
+
+// A shower starts when a particle of one of the pdgIDs, with a kinetic
+// energy within the energyEdges, crosses into one of the volumes. Every
+// energy deposit of that particle and of all its descendants, wherever it
+// is, then belongs to the shower. Deposits are merged into spots on a grid
+// of spotSize in the shower's frame (see ShowerLibrary.hh), so the library
+// stays compact. Showers are complete at the end of the event, and the
+// library is written at the end of each run with everything recorded so
+// far.
+
+// Run this with full simulation and without any fast simulation in the
+// calorimeter. The volumes should be the root volumes of the region the
+// library will be replayed in, so that the entry angles agree.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     ShowerLibraryMakerService: {
+//       @table::ShowerLibraryMakerDefaults
+//       outputFile: "caloShowers.bin"
+//       volumes: [ "calorimeter" ]
+//       energyEdges: [ 100, 200, 500, 1000, 2000, 5000 ]
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'showerLibraryMaker'.
+// - outputFile (string): Where to write the library.
+// - volumes (vector<string>): Logical volumes whose entering particles
+//       start showers.
+// - pdgIDs (vector<int>): The particles to record. Default is gamma, e-
+//       and e+.
+// - energyEdges (vector<double>, MeV): The energy bins.
+// - nCosTheta (unsigned): The number of entry angle bins. Default is 4.
+// - maxShowersPerBin (unsigned): Stop recording a bin once it has this
+//       many showers. 0 means no limit. Default is 1000.
+// - spotSize (double, mm): Deposits closer than this are merged. Default
+//       is 1 mm.
+
+// Include guard
+#ifndef SHOWERLIBRARYMAKER_SERVICE_HH
+#define SHOWERLIBRARYMAKER_SERVICE_HH
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Geant4/G4ThreeVector.hh"
+
+// Get the base class
+#include "artg4/actionBase/SteppingActionBase.hh"
+
+#include "artg4/fastSim/ShowerLibrary.hh"
+
+namespace artg4 {
+
+  class ShowerLibraryMakerService : public SteppingActionBase {
+  public:
+    ShowerLibraryMakerService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~ShowerLibraryMakerService();
+
+    // Start showers and collect their deposits
+    virtual void userSteppingAction(const G4Step*) override;
+
+    // Add the event's showers to the library
+    virtual void fillEventWithArtStuff(art::Event &) override;
+
+    // Write out the library
+    virtual void fillRunEndWithArtStuff(art::Run &) override;
+
+  private:
+
+    // Deposits in one spot cell, summed
+    struct SpotSum {
+      double along, across1, across2;   // energy weighted
+      double time;                      // energy weighted
+      double energy;
+    };
+
+    // A shower being recorded
+    struct Recording {
+      int pdgID;
+      double energy;
+      double cosTheta;
+      G4ThreeVector origin, axis, across1, across2;
+      double t0;
+      std::map<std::array<int, 3>, SpotSum> spots;
+    };
+
+    // Start recording a shower for this track, if it is one we want
+    int startShower(const G4Step* step);
+
+    std::string outputFile_;
+    std::set<std::string> volumes_;
+    double spotSize_;
+
+    ShowerLibraryBuilder builder_;
+
+    // This event: the showers, and which one each track belongs to
+    std::vector<Recording> recordings_;
+    std::unordered_map<int, int> showerOf_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::ShowerLibraryMakerService;
+DECLARE_ART_SERVICE(ShowerLibraryMakerService,LEGACY)
+
+#endif
@@ -0,0 +1,98 @@
+// Implementation of the stepping stone file reader and writer
+
+#include "artg4/pluginActions/steppingStones/SteppingStoneFile.hh"
+
+#include "cetlib/exception.h"
+
+#include <algorithm>
+
+namespace {
+
+  const char fileMagic[8] = { 'A','R','T','G','4','S','S','T' };
+  const std::uint32_t fileVersion = 1;
+
+  // Files from a build with a different record layout are refused
+  const std::uint32_t recordSize = sizeof(artg4::SteppingStone);
+}
+
+
+artg4::SteppingStoneWriter::SteppingStoneWriter(std::string const& fileName) :
+  fileName_(fileName),
+  out_( fileName.c_str(), std::ios::binary | std::ios::trunc ),
+  nWritten_(0)
+{
+  if ( ! out_ ) {
+    throw cet::exception("SteppingStoneFile") << "Cannot open " << fileName << " for writing\n";
+  }
+  out_.write( fileMagic, sizeof(fileMagic) );
+  out_.write( reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion) );
+  out_.write( reinterpret_cast<const char*>(&recordSize), sizeof(recordSize) );
+}
+
+void artg4::SteppingStoneWriter::write(SteppingStone const& stone) {
+  out_.write( reinterpret_cast<const char*>(&stone), sizeof(stone) );
+  ++nWritten_;
+}
+
+void artg4::SteppingStoneWriter::flush() {
+  out_.flush();
+  if ( ! out_ ) {
+    throw cet::exception("SteppingStoneFile") << "Error writing " << fileName_ << "\n";
+  }
+}
+
+
+artg4::SteppingStoneReader::SteppingStoneReader(std::string const& fileName) :
+  fileName_(fileName),
+  in_( fileName.c_str(), std::ios::binary ),
+  firstStone_(),
+  havePending_(false),
+  pending_()
+{
+  if ( ! in_ ) {
+    throw cet::exception("SteppingStoneFile") << "Cannot open stepping stone file " << fileName << "\n";
+  }
+
+  char magic[8];
+  std::uint32_t version = 0, size = 0;
+  in_.read( magic, sizeof(magic) );
+  in_.read( reinterpret_cast<char*>(&version), sizeof(version) );
+  in_.read( reinterpret_cast<char*>(&size), sizeof(size) );
+  if ( ! in_ || ! std::equal( magic, magic + sizeof(magic), fileMagic ) || version != fileVersion ||
+       size != recordSize ) {
+    throw cet::exception("SteppingStoneFile") << fileName << " is not a version " << fileVersion
+                                              << " stepping stone file\n";
+  }
+  firstStone_ = in_.tellg();
+}
+
+bool artg4::SteppingStoneReader::readOne(SteppingStone & stone) {
+  if ( havePending_ ) {
+    stone = pending_;
+    havePending_ = false;
+    return true;
+  }
+  in_.read( reinterpret_cast<char*>(&stone), sizeof(stone) );
+  return in_.gcount() == sizeof(stone);
+}
+
+bool artg4::SteppingStoneReader::read(std::vector<SteppingStone> & stones, std::size_t n) {
+  stones.clear();
+
+  SteppingStone stone;
+  while ( ( n == 0 || stones.size() < n ) && readOne(stone) ) {
+    if ( n == 0 && ! stones.empty() && stone.event != stones.front().event ) {
+      pending_ = stone;
+      havePending_ = true;
+      break;
+    }
+    stones.push_back(stone);
+  }
+  return ! stones.empty();
+}
+
+void artg4::SteppingStoneReader::rewind() {
+  in_.clear();
+  in_.seekg(firstStone_);
+  havePending_ = false;
+}
@@ -0,0 +1,84 @@
+// Stepping stone files - tracks frozen at a boundary, to be resumed later
+
+// A stepping stone is the state of a track as it crossed into a chosen
+// volume: what it was, where, when, which way it was going, its
+// polarization and its weight. SteppingStoneRecorderService writes them as
+// tracks cross (usually killing the tracks there), and
+// SteppingStoneSourceService reads them back as the primaries of a later
+// job. Everything upstream of the boundary is then simulated once, however
+// many downstream configurations are run from it.
+
+// The file is a short header followed by fixed size records, in the order
+// they were recorded, in native endianness.
+
+#ifndef STEPPINGSTONEFILE_HH
+#define STEPPINGSTONEFILE_HH
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace artg4 {
+
+  struct SteppingStone {
+    double x, y, z;           // mm, global
+    double time;              // ns, global
+    float px, py, pz;         // MeV
+    float polX, polY, polZ;
+    float weight;
+    std::int32_t pdgID;
+    std::uint32_t event;      // the upstream event it came from
+  };
+
+  class SteppingStoneWriter {
+  public:
+
+    // Start a new file. Throws cet::exception if it cannot be opened.
+    explicit SteppingStoneWriter(std::string const& fileName);
+
+    void write(SteppingStone const& stone);
+
+    // Make sure everything so far is on disk. Throws cet::exception if
+    // anything could not be written.
+    void flush();
+
+    std::string const& fileName() const { return fileName_; }
+    std::size_t nWritten() const { return nWritten_; }
+
+  private:
+    std::string fileName_;
+    std::ofstream out_;
+    std::size_t nWritten_;
+  };
+
+  class SteppingStoneReader {
+  public:
+
+    // Open a file. Throws cet::exception if it is not a stepping stone
+    // file.
+    explicit SteppingStoneReader(std::string const& fileName);
+
+    // The stones of the next upstream event, or the next n stones if n is
+    // not 0. Returns false, with stones empty, at the end of the file.
+    bool read(std::vector<SteppingStone> & stones, std::size_t n = 0);
+
+    // Back to the first stone
+    void rewind();
+
+    std::string const& fileName() const { return fileName_; }
+
+  private:
+    bool readOne(SteppingStone & stone);
+
+    std::string fileName_;
+    std::ifstream in_;
+    std::streampos firstStone_;
+
+    // Read ahead, while looking for the end of an event
+    bool havePending_;
+    SteppingStone pending_;
+  };
+}
+
+#endif
@@ -0,0 +1,78 @@
+// Implementation of SteppingStoneRecorderService
+
+#include "artg4/pluginActions/steppingStones/SteppingStoneRecorder_service.hh"
+
+#include <vector>
+
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "artg4/services/ActionHolder_service.hh"
+
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::SteppingStoneRecorderService::SteppingStoneRecorderService(fhicl::ParameterSet const & p,
+                                                                  art::ActivityRegistry &)
+  : SteppingActionBase(p.get<std::string>("name", "steppingStoneRecorder")),
+    volumes_(),
+    killAtBoundary_( p.get<bool>("killAtBoundary", true) ),
+    pdgIDs_(),
+    minKineticEnergy_( p.get<double>("minKineticEnergy", 0.) * CLHEP::MeV ),
+    writer_( p.get<std::string>("outputFile") ),
+    logInfo_("SteppingStoneRecorder")
+{
+  std::vector<std::string> volumes = p.get<std::vector<std::string> >("volumes");
+  volumes_.insert( volumes.begin(), volumes.end() );
+  std::vector<int> pdgIDs = p.get<std::vector<int> >("particlePdgIDs", std::vector<int>());
+  pdgIDs_.insert( pdgIDs.begin(), pdgIDs.end() );
+}
+
+artg4::SteppingStoneRecorderService::~SteppingStoneRecorderService()
+{}
+
+void artg4::SteppingStoneRecorderService::userSteppingAction(const G4Step* step) {
+  const G4StepPoint* post = step->GetPostStepPoint();
+  if ( post->GetStepStatus() != fGeomBoundary || ! post->GetPhysicalVolume() ) return;
+  if ( volumes_.find( post->GetPhysicalVolume()->GetLogicalVolume()->GetName() ) == volumes_.end() ) return;
+
+  G4Track* track = step->GetTrack();
+  int pdgID = track->GetDefinition()->GetPDGEncoding();
+  if ( ! pdgIDs_.empty() && pdgIDs_.find(pdgID) == pdgIDs_.end() ) return;
+  if ( post->GetKineticEnergy() < minKineticEnergy_ ) return;
+
+  art::ServiceHandle<ActionHolderService> actionHolder;
+  G4ThreeVector const& position = post->GetPosition();
+  G4ThreeVector momentum = post->GetMomentum();
+  G4ThreeVector polarization = post->GetPolarization();
+
+  SteppingStone stone;
+  stone.x = position.x() / CLHEP::mm;
+  stone.y = position.y() / CLHEP::mm;
+  stone.z = position.z() / CLHEP::mm;
+  stone.time = post->GetGlobalTime() / CLHEP::ns;
+  stone.px = momentum.x() / CLHEP::MeV;
+  stone.py = momentum.y() / CLHEP::MeV;
+  stone.pz = momentum.z() / CLHEP::MeV;
+  stone.polX = polarization.x();
+  stone.polY = polarization.y();
+  stone.polZ = polarization.z();
+  stone.weight = track->GetWeight();
+  stone.pdgID = pdgID;
+  stone.event = actionHolder->getCurrArtEvent().id().event();
+  writer_.write(stone);
+
+  if ( killAtBoundary_ ) track->SetTrackStatus(fStopAndKill);
+}
+
+void artg4::SteppingStoneRecorderService::fillRunEndWithArtStuff(art::Run & r) {
+  writer_.flush();
+  logInfo_ << "Recorded " << writer_.nWritten() << " stepping stones to " << writer_.fileName()
+           << " by the end of run " << r.id().run() << "\n";
+}
+
+using artg4::SteppingStoneRecorderService;
+DEFINE_ART_SERVICE(SteppingStoneRecorderService)
@@ -0,0 +1,89 @@
+// SteppingStoneRecorderService freezes tracks at a boundary into a
+// stepping stone file (see SteppingStoneFile.hh), to be resumed by
+// SteppingStoneSourceService in later jobs.
+
+// Every track that crosses into one of the volumes is recorded at the
+// boundary, and then killed unless killAtBoundary is false. Give
+// particlePdgIDs or minKineticEnergy to record only some of them (the
+// rest go on as usual).
+
+// The file is written as the job runs and flushed at the end of each run.
+// Forked workers (see artg4Main's forkWorkers) each write their own, in
+// their own directories, if outputFile is a relative path.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     SteppingStoneRecorderService: {
+//       @table::SteppingStoneRecorderDefaults
+//       outputFile: "inflectorExit.stones"
+//       volumes: [ "inflectorExitPlane" ]
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'steppingStoneRecorder'.
+// - outputFile (string): Where to write the stones.
+// - volumes (vector<string>): Logical volumes whose entrances are the
+//       boundary.
+// - killAtBoundary (bool): Stop tracking recorded tracks. Default is true.
+// - particlePdgIDs (vector<int>): Only record these particles. Default
+//       (empty) is all.
+// - minKineticEnergy (double, MeV): Only record tracks above this. Default
+//       is 0.
+
+// Include guard
+#ifndef STEPPINGSTONERECORDER_SERVICE_HH
+#define STEPPINGSTONERECORDER_SERVICE_HH
+
+#include <set>
+#include <string>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base class
+#include "artg4/actionBase/SteppingActionBase.hh"
+
+#include "artg4/pluginActions/steppingStones/SteppingStoneFile.hh"
+
+namespace artg4 {
+
+  class SteppingStoneRecorderService : public SteppingActionBase {
+  public:
+    SteppingStoneRecorderService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~SteppingStoneRecorderService();
+
+    // Record (and kill) tracks entering the volumes
+    virtual void userSteppingAction(const G4Step*) override;
+
+    // Flush the file
+    virtual void fillRunEndWithArtStuff(art::Run &) override;
+
+  private:
+
+    std::set<std::string> volumes_;
+    bool killAtBoundary_;
+    std::set<int> pdgIDs_;
+    double minKineticEnergy_;
+
+    SteppingStoneWriter writer_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::SteppingStoneRecorderService;
+DECLARE_ART_SERVICE(SteppingStoneRecorderService,LEGACY)
+
+#endif
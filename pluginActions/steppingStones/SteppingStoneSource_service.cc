@@ -0,0 +1,53 @@
+// Implementation of SteppingStoneSourceService
+
+#include "artg4/pluginActions/steppingStones/SteppingStoneSource_service.hh"
+
+#include "Geant4/G4Event.hh"
+#include "Geant4/G4PrimaryVertex.hh"
+#include "Geant4/G4PrimaryParticle.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::SteppingStoneSourceService::SteppingStoneSourceService(fhicl::ParameterSet const & p,
+                                                              art::ActivityRegistry &)
+  : PrimaryGeneratorActionBase(p.get<std::string>("name", "steppingStoneSource")),
+    reader_( p.get<std::string>("inputFile") ),
+    stonesPerEvent_( p.get<unsigned int>("stonesPerEvent", 0) ),
+    loop_( p.get<bool>("loop", false) ),
+    exhausted_(false),
+    stones_(),
+    logInfo_("SteppingStoneSource")
+{}
+
+artg4::SteppingStoneSourceService::~SteppingStoneSourceService()
+{}
+
+void artg4::SteppingStoneSourceService::generatePrimaries(G4Event* event) {
+  if ( exhausted_ ) return;
+
+  if ( ! reader_.read(stones_, stonesPerEvent_) ) {
+    if ( loop_ ) {
+      logInfo_ << "Starting again from the top of " << reader_.fileName() << "\n";
+      reader_.rewind();
+    }
+    if ( ! loop_ || ! reader_.read(stones_, stonesPerEvent_) ) {
+      mf::LogWarning("SteppingStoneSource") << "No stepping stones left in " << reader_.fileName()
+                                            << "; the remaining events will be empty";
+      exhausted_ = true;
+      return;
+    }
+  }
+
+  for ( SteppingStone const& stone : stones_ ) {
+    G4PrimaryVertex* vertex = new G4PrimaryVertex( G4ThreeVector( stone.x, stone.y, stone.z ) * CLHEP::mm,
+                                                   stone.time * CLHEP::ns );
+    G4PrimaryParticle* particle = new G4PrimaryParticle( stone.pdgID, stone.px * CLHEP::MeV,
+                                                         stone.py * CLHEP::MeV, stone.pz * CLHEP::MeV );
+    particle->SetPolarization( stone.polX, stone.polY, stone.polZ );
+    particle->SetWeight( stone.weight );
+    vertex->SetPrimary(particle);
+    event->AddPrimaryVertex(vertex);
+  }
+}
+
+using artg4::SteppingStoneSourceService;
+DEFINE_ART_SERVICE(SteppingStoneSourceService)
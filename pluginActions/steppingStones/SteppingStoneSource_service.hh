@@ -0,0 +1,81 @@
+// SteppingStoneSourceService resumes tracks frozen by
+// SteppingStoneRecorderService: it makes primaries from a stepping stone
+// file (see SteppingStoneFile.hh).
+
+// By default each event gets the stones of one upstream event, so that
+// whatever was correlated upstream stays together; with stonesPerEvent it
+// gets that many stones instead, regardless of where they came from. Each
+// stone is a primary vertex with one particle, with the stone's momentum,
+// polarization and weight.
+
+// When the file runs out the source starts again from the top if loop is
+// true; otherwise the remaining events are empty, with a warning. Reusing
+// stones repeats the upstream simulation's statistics, so only loop with
+// care.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     SteppingStoneSourceService: {
+//       @table::SteppingStoneSourceDefaults
+//       inputFile: "inflectorExit.stones"
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'steppingStoneSource'.
+// - inputFile (string): The stones to replay.
+// - stonesPerEvent (unsigned): 0 (the default) keeps the upstream events.
+// - loop (bool): Start again at the end of the file. Default is false.
+
+// Include guard
+#ifndef STEPPINGSTONESOURCE_SERVICE_HH
+#define STEPPINGSTONESOURCE_SERVICE_HH
+
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base class
+#include "artg4/actionBase/PrimaryGeneratorActionBase.hh"
+
+#include "artg4/pluginActions/steppingStones/SteppingStoneFile.hh"
+
+namespace artg4 {
+
+  class SteppingStoneSourceService : public PrimaryGeneratorActionBase {
+  public:
+    SteppingStoneSourceService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~SteppingStoneSourceService();
+
+    // Make this event's primaries from the next stones
+    virtual void generatePrimaries(G4Event*) override;
+
+  private:
+
+    SteppingStoneReader reader_;
+    unsigned int stonesPerEvent_;
+    bool loop_;
+    bool exhausted_;
+
+    std::vector<SteppingStone> stones_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::SteppingStoneSourceService;
+DECLARE_ART_SERVICE(SteppingStoneSourceService,LEGACY)
+
+#endif
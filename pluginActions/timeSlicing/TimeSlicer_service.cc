@@ -0,0 +1,95 @@
+// Implementation of TimeSlicerService
+
+#include "artg4/pluginActions/timeSlicing/TimeSlicer_service.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "cetlib/exception.h"
+
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "artg4/services/DetectorHolder_service.hh"
+
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::TimeSlicerService::TimeSlicerService(fhicl::ParameterSet const & p,
+                                            art::ActivityRegistry &)
+  : StackingActionBase(p.get<std::string>("name", "timeSlicer")),
+    SteppingActionBase(p.get<std::string>("name", "timeSlicer")),
+    sliceLength_( p.get<double>("sliceLength") * CLHEP::ns ),
+    sliceEnd_(sliceLength_),
+    earliestDeferred_(DBL_MAX),
+    nEvents_(0),
+    nSlices_(0),
+    nSuspended_(0),
+    slicesThisEvent_(0),
+    maxSlices_(0),
+    logInfo_("TimeSlicer")
+{
+  if ( sliceLength_ <= 0 ) {
+    throw cet::exception("TimeSlicerService") << "sliceLength must be positive\n";
+  }
+}
+
+artg4::TimeSlicerService::~TimeSlicerService()
+{}
+
+bool artg4::TimeSlicerService::deferNewTrack(const G4Track* track, unsigned int) {
+  double time = track->GetGlobalTime();
+  if ( time < sliceEnd_ ) return false;
+  earliestDeferred_ = std::min(earliestDeferred_, time);
+  return true;
+}
+
+bool artg4::TimeSlicerService::abortAfterStage(unsigned int) {
+  // The next window is the one the earliest waiting track is in, if that is
+  // later than the one after this
+  double nextStart = sliceEnd_;
+  if ( earliestDeferred_ != DBL_MAX && earliestDeferred_ > nextStart ) {
+    nextStart = std::floor( earliestDeferred_ / sliceLength_ ) * sliceLength_;
+  }
+
+  art::ServiceHandle<DetectorHolderService> detectorHolder;
+  detectorHolder->flushTimeSlice(nextStart);
+
+  sliceEnd_ = nextStart + sliceLength_;
+  earliestDeferred_ = DBL_MAX;
+  ++nSlices_;
+  maxSlices_ = std::max(maxSlices_, ++slicesThisEvent_);
+  return false;
+}
+
+void artg4::TimeSlicerService::prepareNewEvent() {
+  sliceEnd_ = sliceLength_;
+  earliestDeferred_ = DBL_MAX;
+  ++nEvents_;
+  ++nSlices_;
+  slicesThisEvent_ = 1;
+  maxSlices_ = std::max(maxSlices_, slicesThisEvent_);
+}
+
+void artg4::TimeSlicerService::userSteppingAction(const G4Step* step) {
+  G4Track* track = step->GetTrack();
+  if ( track->GetTrackStatus() != fAlive ) return;
+  if ( step->GetPostStepPoint()->GetGlobalTime() < sliceEnd_ ) return;
+
+  // Back to the stack, where deferNewTrack puts it off
+  track->SetTrackStatus(fSuspend);
+  ++nSuspended_;
+}
+
+void artg4::TimeSlicerService::fillRunEndWithArtStuff(art::Run & r) {
+  logInfo_ << "Time slicing in run " << r.id().run() << ": " << nEvents_ << " events in " << nSlices_
+           << " slices of " << sliceLength_ / CLHEP::ns << " ns (at most " << maxSlices_
+           << " in an event), " << nSuspended_ << " tracks suspended at the end of a slice\n";
+
+  nEvents_ = nSlices_ = nSuspended_ = 0;
+  maxSlices_ = 0;
+}
+
+using artg4::TimeSlicerService;
+DEFINE_ART_SERVICE(TimeSlicerService)
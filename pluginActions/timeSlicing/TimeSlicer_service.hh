@@ -0,0 +1,108 @@
+// TimeSlicerService simulates long events in slices of global time.
+
+// A muon fill lasts hundreds of microseconds, and simulated as one Geant
+// event everything it deposits piles up in the sensitive detectors until
+// the end of the event. With this action the event is tracked one window of
+// global time, sliceLength long, at a time:
+// * a track that steps past the end of the window is suspended, and
+//   goes onto the waiting stack with everything else that starts later
+//   (the stacking stages of StackingActionBase.hh)
+// * once nothing is left in the window, the detectors hand the slice's hits
+//   over (see DetectorBase::doFlushTimeSlice and
+//   artg4/util/TimeSlicedHits.hh), and the next window is started
+// Windows with nothing in them are skipped. The last slice is handed over
+// with the rest of the event, as usual.
+
+// Steps are not split at the end of a window, so a hit belongs to the slice
+// its step started in. Other stacking actions that defer tracks by stage
+// end the slices early. Detectors that do not slice their hits are not
+// affected.
+
+// A suspended track goes through the tracking actions again when it is
+// resumed: postUserTrackingAction sees it with status fSuspend, and
+// preUserTrackingAction sees it again with a current step number above 0.
+// Tracking actions that count or record tracks must tell a resumed track
+// from a new one that way (TruthRecordService and
+// FastOpticsMapMakerService do).
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     TimeSlicerService: {
+//       @table::TimeSlicerDefaults
+//       sliceLength: 10000   // ns
+//     }
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action. Default is 'timeSlicer'.
+// - sliceLength (double, ns): The length of a time slice. Must be positive.
+
+// Include guard
+#ifndef TIMESLICER_SERVICE_HH
+#define TIMESLICER_SERVICE_HH
+
+#include <string>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base classes
+#include "artg4/actionBase/StackingActionBase.hh"
+#include "artg4/actionBase/SteppingActionBase.hh"
+
+namespace artg4 {
+
+  class TimeSlicerService : public StackingActionBase, public SteppingActionBase {
+  public:
+    TimeSlicerService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~TimeSlicerService();
+
+    // Put off tracks that start after the current window
+    virtual bool deferNewTrack(const G4Track*, unsigned int) override;
+
+    // Flush the slice and move on to the next window with tracks in it
+    virtual bool abortAfterStage(unsigned int) override;
+
+    // Start at the first window
+    virtual void prepareNewEvent() override;
+
+    // Suspend tracks that have left the current window
+    virtual void userSteppingAction(const G4Step*) override;
+
+    // Log the counts
+    virtual void fillRunEndWithArtStuff(art::Run &) override;
+
+  private:
+
+    double sliceLength_;
+
+    // The end of the current window, and the earliest track put off past it
+    double sliceEnd_;
+    double earliestDeferred_;
+
+    // This run
+    unsigned long nEvents_;
+    unsigned long nSlices_;
+    unsigned long nSuspended_;
+    unsigned int slicesThisEvent_;
+    unsigned int maxSlices_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::TimeSlicerService;
+DECLARE_ART_SERVICE(TimeSlicerService,LEGACY)
+
+#endif
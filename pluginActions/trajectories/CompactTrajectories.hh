@@ -0,0 +1,65 @@
+// CompactTrajectories - decimated trajectories of an event
+
+// All trajectories of an event in one object. Per-trajectory quantities
+// are one vector each; the points of all trajectories are stored end to end
+// in x, y, z, and the points of trajectory i are the ones from
+// pointOffset[i] up to (not including) pointOffset[i+1].
+//
+// Made by TrajectoryStoreService, which drops points that do not change the
+// picture (see there).
+
+#ifndef COMPACTTRAJECTORIES_HH
+#define COMPACTTRAJECTORIES_HH
+
+#include <vector>
+
+namespace artg4 {
+
+  class CompactTrajectories {
+  public:
+
+    CompactTrajectories() :
+      trackID(), parentID(), pdgID(), pointOffset(1, 0), x(), y(), z()
+    {}
+
+    virtual ~CompactTrajectories() {}
+
+    // h3. Per trajectory
+    std::vector<int> trackID;
+    std::vector<int> parentID;
+    std::vector<int> pdgID;
+    std::vector<unsigned int> pointOffset;   // size() + 1 entries
+
+    // h3. Points (global, mm)
+    std::vector<float> x, y, z;
+
+    // h3. Accessors
+
+    unsigned int size() const { return trackID.size(); }
+
+    unsigned int nPoints(unsigned int i) const { return pointOffset.at(i+1) - pointOffset.at(i); }
+
+#ifndef __GCCXML__
+
+    // Start a trajectory; add its points with addPoint
+    void addTrajectory(int track, int parent, int pdg) {
+      trackID.push_back(track);
+      parentID.push_back(parent);
+      pdgID.push_back(pdg);
+      pointOffset.push_back( pointOffset.back() );
+    }
+
+    // Add a point to the last trajectory
+    void addPoint(float px, float py, float pz) {
+      x.push_back(px);
+      y.push_back(py);
+      z.push_back(pz);
+      ++pointOffset.back();
+    }
+
+#endif
+
+  };
+}
+
+#endif
@@ -0,0 +1,96 @@
+// Implementation of TrajectoryStoreService
+
+#include "artg4/pluginActions/trajectories/TrajectoryStore_service.hh"
+
+#include "Geant4/G4Event.hh"
+#include "Geant4/G4TrajectoryContainer.hh"
+#include "Geant4/G4VTrajectory.hh"
+#include "Geant4/G4VTrajectoryPoint.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::TrajectoryStoreService::TrajectoryStoreService(fhicl::ParameterSet const & p,
+                                                      art::ActivityRegistry &)
+  : EventActionBase(p.get<std::string>("name", "trajectories")),
+    minDistance_( p.get<double>("minDistance", 1.0) * CLHEP::mm ),
+    maxDistance_( p.get<double>("maxDistance", 0.0) * CLHEP::mm ),
+    maxAngle_( p.get<double>("maxAngle", 0.05) ),
+    minMomentum_( p.get<double>("minMomentum", 0.0) * CLHEP::MeV ),
+    trajectories_( new CompactTrajectories ),
+    warned_(false),
+    logInfo_("TrajectoryStore")
+{}
+
+artg4::TrajectoryStoreService::~TrajectoryStoreService()
+{}
+
+void artg4::TrajectoryStoreService::addDecimated(std::vector<G4ThreeVector> const& points) {
+  if ( points.empty() ) return;
+
+  G4ThreeVector lastKept = points.front();
+  trajectories_->addPoint( lastKept.x(), lastKept.y(), lastKept.z() );
+
+  const std::size_t last = points.size() - 1;
+  for ( std::size_t i = 1; i < last; ++i ) {
+    G4ThreeVector fromKept = points[i] - lastKept;
+    double distance = fromKept.mag();
+    if ( distance < minDistance_ ) continue;
+
+    G4ThreeVector ahead = points[i+1] - points[i];
+    bool turns = ahead.mag2() > 0 && fromKept.angle(ahead) > maxAngle_;
+    bool far = maxDistance_ > 0 && distance > maxDistance_;
+    if ( turns || far ) {
+      lastKept = points[i];
+      trajectories_->addPoint( lastKept.x(), lastKept.y(), lastKept.z() );
+    }
+  }
+
+  if ( last > 0 ) trajectories_->addPoint( points[last].x(), points[last].y(), points[last].z() );
+}
+
+void artg4::TrajectoryStoreService::endOfEventAction(const G4Event* event) {
+
+  G4TrajectoryContainer* container = event->GetTrajectoryContainer();
+  if ( ! container ) {
+    if ( ! warned_ ) {
+      mf::LogWarning("TrajectoryStore") << "Geant stored no trajectories; set storeTrajectories: true "
+                                        << "in the artg4Main configuration";
+      warned_ = true;
+    }
+    return;
+  }
+
+  std::vector<G4ThreeVector> points;
+  std::size_t nOriginal = 0;
+  for ( int i = 0; i < container->entries(); ++i ) {
+    G4VTrajectory* trajectory = (*container)[i];
+    if ( trajectory->GetInitialMomentum().mag() < minMomentum_ ) continue;
+
+    points.clear();
+    for ( int j = 0; j < trajectory->GetPointEntries(); ++j ) {
+      points.push_back( trajectory->GetPoint(j)->GetPosition() );
+    }
+    nOriginal += points.size();
+
+    trajectories_->addTrajectory( trajectory->GetTrackID(), trajectory->GetParentID(),
+                                  trajectory->GetPDGEncoding() );
+    addDecimated(points);
+  }
+
+  mf::LogDebug("TrajectoryStore") << "Kept " << trajectories_->x.size() << " of " << nOriginal
+                                  << " points in " << trajectories_->size() << " trajectories";
+}
+
+void artg4::TrajectoryStoreService::callArtProduces(art::EDProducer * producer) {
+  producer->produces<CompactTrajectories>( myName() );
+}
+
+void artg4::TrajectoryStoreService::fillEventWithArtStuff(art::Event & e) {
+  e.put( std::move(trajectories_), myName() );
+
+  // See the comment in PhysicalVolumeStoreService::fillRunEndWithArtStuff
+  trajectories_.release();
+  trajectories_.reset( new CompactTrajectories );
+}
+
+using artg4::TrajectoryStoreService;
+DEFINE_ART_SERVICE(TrajectoryStoreService)
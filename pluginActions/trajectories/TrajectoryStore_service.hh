@@ -0,0 +1,98 @@
+// TrajectoryStoreService puts the trajectories Geant recorded for an event
+// into the Art event as CompactTrajectories (see CompactTrajectories.hh).
+
+// Geant only records trajectories if asked to; set storeTrajectories: true
+// in the artg4Main configuration (it is on by default only with
+// visualization).
+
+// Most trajectory points add nothing to a picture of the event, so points
+// are dropped unless
+// * the track turns by more than maxAngle there, or
+// * it is more than maxDistance from the last kept point, or
+// * it is the first or last point of the trajectory,
+// and points closer than minDistance to the last kept point are always
+// dropped (apart from the last one).
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     TrajectoryStoreService: @local::TrajectoryStoreDefaults
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action and instance name of the product.
+//       Default is 'trajectories'.
+// - minDistance (double): mm. Default is 1.
+// - maxDistance (double): mm, 0 means no limit. Default is 0.
+// - maxAngle (double): radians. Default is 0.05.
+// - minMomentum (double): Skip trajectories with a smaller initial
+//       momentum (MeV). Default is 0.
+
+// Include guard
+#ifndef TRAJECTORYSTORE_SERVICE_HH
+#define TRAJECTORYSTORE_SERVICE_HH
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Event.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Geant4/G4ThreeVector.hh"
+
+// Get the base class
+#include "artg4/actionBase/EventActionBase.hh"
+
+#include "artg4/pluginActions/trajectories/CompactTrajectories.hh"
+
+namespace artg4 {
+
+  class TrajectoryStoreService : public EventActionBase {
+  public:
+    TrajectoryStoreService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~TrajectoryStoreService();
+
+    // Copy the event's trajectories, decimated
+    virtual void endOfEventAction(const G4Event*) override;
+
+    // Tell Art what we'll be producing
+    virtual void callArtProduces(art::EDProducer * producer) override;
+
+    // Put the trajectories into the event
+    virtual void fillEventWithArtStuff(art::Event & e) override;
+
+  private:
+
+    // Add the points of one trajectory that survive decimation
+    void addDecimated(std::vector<G4ThreeVector> const& points);
+
+    double minDistance_;
+    double maxDistance_;
+    double maxAngle_;
+    double minMomentum_;
+
+    std::unique_ptr<CompactTrajectories> trajectories_;
+
+    // Complain only once if Geant is not storing trajectories
+    bool warned_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::TrajectoryStoreService;
+DECLARE_ART_SERVICE(TrajectoryStoreService,LEGACY)
+
+#endif
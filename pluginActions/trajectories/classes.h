@@ -0,0 +1,8 @@
+// classes.h
+
+#include <vector>
+
+#include "art/Persistency/Common/Wrapper.h"
+
+#include "artg4/pluginActions/trajectories/CompactTrajectories.hh"
+template class art::Wrapper<artg4::CompactTrajectories>;
@@ -0,0 +1,76 @@
+// TruthRecord - a compact table of the tracks of an event
+
+// One row per kept track, one vector per quantity. Links between tracks are
+// row indices rather than pointers, so the record can be stored and read
+// back as is:
+//
+// * parentIndex is the row of the nearest kept ancestor, or -1 if there is
+//   none (primaries, and tracks whose whole ancestry was pruned away).
+// * processID indexes processNames; the creator process of primaries is
+//   "primary".
+//
+// The record is made by TruthRecordService, which also decides which tracks
+// are kept.
+
+#ifndef TRUTHRECORD_HH
+#define TRUTHRECORD_HH
+
+#include <string>
+#include <vector>
+
+namespace artg4 {
+
+  class TruthRecord {
+  public:
+
+    TruthRecord() :
+      trackID(), parentIndex(), pdgID(), generation(), processID(),
+      startX(), startY(), startZ(), startT(), startPx(), startPy(), startPz(),
+      endX(), endY(), endZ(), endT(), processNames()
+    {}
+
+    virtual ~TruthRecord() {}
+
+    // h3. The columns
+
+    std::vector<int> trackID;
+    std::vector<int> parentIndex;
+    std::vector<int> pdgID;
+    std::vector<unsigned short> generation;   // 0 for primaries
+    std::vector<unsigned int> processID;
+
+    // Creation point and momentum (global, mm, ns, MeV)
+    std::vector<float> startX, startY, startZ;
+    std::vector<double> startT;
+    std::vector<float> startPx, startPy, startPz;
+
+    // Where the track ended
+    std::vector<float> endX, endY, endZ;
+    std::vector<double> endT;
+
+    // Names for processID
+    std::vector<std::string> processNames;
+
+    // h3. Accessors
+
+    unsigned int size() const { return trackID.size(); }
+
+    const std::string & creatorProcess(unsigned int row) const { return processNames.at( processID.at(row) ); }
+
+#ifndef __GCCXML__
+
+    // The rows whose parentIndex is the given row
+    std::vector<unsigned int> children(unsigned int row) const {
+      std::vector<unsigned int> c;
+      for ( unsigned int i = row + 1; i < size(); ++i ) {
+        if ( parentIndex[i] == static_cast<int>(row) ) c.push_back(i);
+      }
+      return c;
+    }
+
+#endif
+
+  };
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Implementation of TruthRecordService
+
+#include "artg4/pluginActions/truthRecord/TruthRecord_service.hh"
+
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4VProcess.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+
+artg4::TruthRecordService::TruthRecordService(fhicl::ParameterSet const & p,
+                                              art::ActivityRegistry &)
+  : TrackingActionBase(p.get<std::string>("name", "truthRecord")),
+    minKineticEnergy_( p.get<double>("minKineticEnergy", 0.) * CLHEP::MeV ),
+    maxGeneration_( p.get<int>("maxGeneration", -1) ),
+    dropProcesses_(),
+    keepProcesses_(),
+    record_( new TruthRecord ),
+    tracks_(),
+    currentRow_(-1),
+    processIDs_(),
+    processNames_(),
+    logInfo_("TruthRecord")
+{
+  std::vector<std::string> drop = p.get<std::vector<std::string> >("dropProcesses", std::vector<std::string>());
+  std::vector<std::string> keep = p.get<std::vector<std::string> >("keepProcesses", std::vector<std::string>());
+  dropProcesses_.insert( drop.begin(), drop.end() );
+  keepProcesses_.insert( keep.begin(), keep.end() );
+}
+
+artg4::TruthRecordService::~TruthRecordService()
+{}
+
+unsigned int artg4::TruthRecordService::processIDGivenName(std::string const& name) {
+  auto found = processIDs_.find(name);
+  if ( found != processIDs_.end() ) return found->second;
+
+  unsigned int id = processNames_.size();
+  processNames_.push_back(name);
+  processIDs_[name] = id;
+  return id;
+}
+
+bool artg4::TruthRecordService::keep(const G4Track* track, int generation, std::string const& process) const {
+  if ( generation == 0 ) return true;
+  if ( track->GetVertexKineticEnergy() < minKineticEnergy_ ) return false;
+  if ( maxGeneration_ >= 0 && generation > maxGeneration_ ) return false;
+  if ( dropProcesses_.count(process) ) return false;
+  if ( ! keepProcesses_.empty() && ! keepProcesses_.count(process) ) return false;
+  return true;
+}
+
+void artg4::TruthRecordService::preUserTrackingAction(const G4Track* track) {
+
+  // A suspended track (e.g. by time slicing) comes back here when it is
+  // resumed. It already has its row, if it was kept; carry on with that
+  // one so that its end is filled in when it really ends.
+  if ( track->GetCurrentStepNumber() > 0 ) {
+    currentRow_ = -1;
+    auto seen = tracks_.find( track->GetTrackID() );
+    if ( seen != tracks_.end() ) {
+      int row = seen->second.keptIndex;
+      if ( row >= 0 && record_->trackID[row] == track->GetTrackID() ) currentRow_ = row;
+      return;
+    }
+  }
+
+  // The parent has always been seen already: daughters are only tracked
+  // after their parent
+  TrackInfo info = { 0, -1 };
+  if ( track->GetParentID() != 0 ) {
+    auto parent = tracks_.find( track->GetParentID() );
+    if ( parent != tracks_.end() ) {
+      info.generation = parent->second.generation + 1;
+      info.keptIndex = parent->second.keptIndex;
+    }
+  }
+
+  const G4VProcess* creator = track->GetCreatorProcess();
+  std::string process = creator ? std::string( creator->GetProcessName() ) : std::string("primary");
+
+  currentRow_ = -1;
+  if ( keep(track, info.generation, process) ) {
+    currentRow_ = record_->size();
+
+    const G4ThreeVector & pos = track->GetPosition();
+    G4ThreeVector mom = track->GetMomentum();
+    record_->trackID.push_back( track->GetTrackID() );
+    record_->parentIndex.push_back( info.keptIndex );
+    record_->pdgID.push_back( track->GetDefinition()->GetPDGEncoding() );
+    record_->generation.push_back( info.generation );
+    record_->processID.push_back( processIDGivenName(process) );
+    record_->startX.push_back( pos.x() );
+    record_->startY.push_back( pos.y() );
+    record_->startZ.push_back( pos.z() );
+    record_->startT.push_back( track->GetGlobalTime() );
+    record_->startPx.push_back( mom.x() );
+    record_->startPy.push_back( mom.y() );
+    record_->startPz.push_back( mom.z() );
+
+    // Filled in when the track ends
+    record_->endX.push_back(0);
+    record_->endY.push_back(0);
+    record_->endZ.push_back(0);
+    record_->endT.push_back(0);
+
+    info.keptIndex = currentRow_;
+  }
+
+  tracks_[ track->GetTrackID() ] = info;
+}
+
+void artg4::TruthRecordService::postUserTrackingAction(const G4Track* track) {
+  if ( currentRow_ < 0 ) return;
+
+  const G4ThreeVector & pos = track->GetPosition();
+  record_->endX[currentRow_] = pos.x();
+  record_->endY[currentRow_] = pos.y();
+  record_->endZ[currentRow_] = pos.z();
+  record_->endT[currentRow_] = track->GetGlobalTime();
+  currentRow_ = -1;
+}
+
+void artg4::TruthRecordService::callArtProduces(art::EDProducer * producer) {
+  producer->produces<TruthRecord>( myName() );
+}
+
+void artg4::TruthRecordService::fillEventWithArtStuff(art::Event & e) {
+
+  mf::LogDebug("TruthRecord") << "Kept " << record_->size() << " of " << tracks_.size() << " tracks";
+
+  record_->processNames = processNames_;
+  e.put( std::move(record_), myName() );
+
+  // See the comment in PhysicalVolumeStoreService::fillRunEndWithArtStuff
+  record_.release();
+  record_.reset( new TruthRecord );
+  tracks_.clear();
+  currentRow_ = -1;
+}
+
+using artg4::TruthRecordService;
+DEFINE_ART_SERVICE(TruthRecordService)
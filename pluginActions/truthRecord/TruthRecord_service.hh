@@ -0,0 +1,115 @@
+// TruthRecordService builds a TruthRecord (see TruthRecord.hh) of the
+// tracks in each event and puts it in the event.
+
+// Tracks are pruned as they are simulated, so the record only ever holds
+// the tracks that are kept. A track is kept if it is a primary, or if all
+// of these hold:
+// * its kinetic energy at creation is at least minKineticEnergy
+// * its generation (primaries are 0, their daughters 1, ...) is at most
+//   maxGeneration
+// * its creator process is not in dropProcesses and, if keepProcesses is
+//   not empty, is in keepProcesses
+//
+// A kept track points to its nearest kept ancestor, so pruning a track
+// does not cut its kept descendants off from the tree.
+
+// To use this action, put it in the services section of the configuration
+// file, like this:
+//
+// services: {
+//   ...
+//   user: {
+//     TruthRecordService: @local::TruthRecordDefaults
+//     ...
+//   }
+// }
+
+// Expected parameters:
+// - name (string): Name of the action and instance name of the product.
+//       Default is 'truthRecord'.
+// - minKineticEnergy (double): In MeV. Default is 0 (no cut).
+// - maxGeneration (int): Negative means no limit. Default is -1.
+// - dropProcesses (vector<string>): Default is empty.
+// - keepProcesses (vector<string>): Default is empty (all processes).
+
+// Include guard
+#ifndef TRUTHRECORD_SERVICE_HH
+#define TRUTHRECORD_SERVICE_HH
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "fhiclcpp/ParameterSet.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Event.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Get the base class
+#include "artg4/actionBase/TrackingActionBase.hh"
+
+#include "artg4/pluginActions/truthRecord/TruthRecord.hh"
+
+namespace artg4 {
+
+  class TruthRecordService : public TrackingActionBase {
+  public:
+    TruthRecordService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    virtual ~TruthRecordService();
+
+    // Decide whether to keep the track and, if so, add its row
+    virtual void preUserTrackingAction(const G4Track*) override;
+
+    // Fill in where a kept track ended
+    virtual void postUserTrackingAction(const G4Track*) override;
+
+    // Tell Art what we'll be producing
+    virtual void callArtProduces(art::EDProducer * producer) override;
+
+    // Put the record into the event
+    virtual void fillEventWithArtStuff(art::Event & e) override;
+
+  private:
+
+    // What we need to know about every track seen this event, kept or not,
+    // to link its daughters
+    struct TrackInfo {
+      int generation;
+      int keptIndex;   // its own row if kept, otherwise its nearest kept ancestor's (or -1)
+    };
+
+    bool keep(const G4Track* track, int generation, std::string const& process) const;
+
+    unsigned int processIDGivenName(std::string const& name);
+
+    // Pruning
+    double minKineticEnergy_;
+    int maxGeneration_;
+    std::set<std::string> dropProcesses_;
+    std::set<std::string> keepProcesses_;
+
+    // This event
+    std::unique_ptr<TruthRecord> record_;
+    std::unordered_map<int, TrackInfo> tracks_;
+
+    // The row of the track being simulated, or -1 if it was not kept
+    int currentRow_;
+
+    // Process name lookup; the names are copied into every record
+    std::map<std::string, unsigned int> processIDs_;
+    std::vector<std::string> processNames_;
+
+    // A message logger for this action
+    mf::LogInfo logInfo_;
+  };
+}
+
+using artg4::TruthRecordService;
+DECLARE_ART_SERVICE(TruthRecordService,LEGACY)
+
+#endif
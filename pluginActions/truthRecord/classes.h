@@ -0,0 +1,9 @@
+// classes.h
+
+#include <string>
+#include <vector>
+
+#include "art/Persistency/Common/Wrapper.h"
+
+#include "artg4/pluginActions/truthRecord/TruthRecord.hh"
+template class art::Wrapper<artg4::TruthRecord>;
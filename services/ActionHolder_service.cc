@@ -43,6 +43,9 @@ artg4::ActionHolderService::ActionHolderService(fhicl::ParameterSet const&,
   stackingActionsMap_(),
   primaryGeneratorActionsMap_(),
   currentArtEvent_(nullptr),
+  currentStage_(0),
+  stageAbortedBy_(),
+  nStageAborts_(0),
   allActionsMap_()
 {}
 
@@ -190,6 +193,12 @@ void artg4::ActionHolderService::fillRunBeginWithArtStuff()
 
 void artg4::ActionHolderService::fillRunEndWithArtStuff()
 {
+  if ( nStageAborts_ > 0 ) {
+    mf::LogInfo(msgctg) << nStageAborts_ << " events were aborted early by stacking actions in run "
+                        << getCurrArtRun().id().run();
+    nStageAborts_ = 0;
+  }
+
   // Loop over the activities and call @fillRunEndWithArtStuff@ on each
   for ( auto entry : allActionsMap_ ) {
     (entry.second)->fillRunEndWithArtStuff(getCurrArtRun());
@@ -266,12 +275,46 @@ bool artg4::ActionHolderService::killNewTrack(const G4Track* newTrack) {
   
   return killTrack;
 }
+
+bool artg4::ActionHolderService::deferNewTrack(const G4Track* newTrack) {
+  for ( auto entry : stackingActionsMap_ ) {
+    if ( (entry.second)->deferNewTrack(newTrack, currentStage_) ) return true;
+  }
+  return false;
+}
+
+void artg4::ActionHolderService::prepareNewEvent() {
+  currentStage_ = 0;
+  stageAbortedBy_.clear();
+  for ( auto entry : stackingActionsMap_ ) {
+    (entry.second)->prepareNewEvent();
+  }
+}
+
+bool artg4::ActionHolderService::endOfStage() {
+  for ( auto entry : stackingActionsMap_ ) {
+    if ( (entry.second)->abortAfterStage(currentStage_) ) {
+      stageAbortedBy_ = entry.first;
+      ++nStageAborts_;
+      mf::LogDebug(msgctg) << "Action " << entry.first << " aborted the event after stage "
+                           << currentStage_;
+      return true;
+    }
+  }
+  ++currentStage_;
+  return false;
+}
   
 // h3. Primary generator actions
 void artg4::ActionHolderService::generatePrimaries(G4Event* theEvent) {
   for ( auto entry : primaryGeneratorActionsMap_ ) {
     (entry.second)->generatePrimaries(theEvent);
   }
+
+  // Now that the event has all its primaries
+  for ( auto entry : primaryGeneratorActionsMap_ ) {
+    (entry.second)->filterPrimaries(theEvent);
+  }
 }
 
 
@@ -106,6 +106,17 @@ namespace artg4 {
     
     // h4. Stacking actions
     bool killNewTrack(const G4Track* );
+    bool deferNewTrack(const G4Track* );
+    void prepareNewEvent();
+
+    // The current stage is done. Returns true if an action wants the event
+    // aborted; otherwise moves on to the next stage.
+    bool endOfStage();
+
+    // The stage of the current event, and which action aborted it (empty
+    // if none did)
+    unsigned int currentStage() const { return currentStage_; }
+    std::string const& stageAbortedBy() const { return stageAbortedBy_; }
     
     // h4. Primary Generator actions
     void generatePrimaries(G4Event*);
@@ -127,6 +138,11 @@ namespace artg4 {
     // Hold on to the current Art run
     art::Run * currentArtRun_;
 
+    // Staged stacking (see StackingActionBase.hh)
+    unsigned int currentStage_;
+    std::string stageAbortedBy_;
+    unsigned int nStageAborts_;
+
     // An uber-collection of all registered actions, arranged by name
     std::map<std::string, ActionBase*> allActionsMap_;
         
@@ -4,15 +4,36 @@
 // Date: July 2012
 
 //Includes
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 #include "artg4/services/DetectorHolder_service.hh"
 #include "art/Framework/Services/Registry/ServiceMacros.h"
 #include "messagefacility/MessageLogger/MessageLogger.h" 
 
 #include "artg4/Core/DetectorBase.hh"
+#include "artg4/util/Fingerprint.hh"
+#include "artg4/fastSim/ParameterizedEMShowerModel.hh"
+#include "artg4/fastSim/ShowerLibraryModel.hh"
+#include "artg4/overlay/BackgroundLibrary.hh"
 
 #include "Geant4/G4HCofThisEvent.hh"
+#include "Geant4/G4Material.hh"
+#include "Geant4/G4Region.hh"
+#include "Geant4/G4RegionStore.hh"
+#include "Geant4/G4ProductionCuts.hh"
+#include "Geant4/G4UserLimits.hh"
+#include "Geant4/G4LogicalVolume.hh"
+#include "Geant4/G4LogicalVolumeStore.hh"
+#include "Geant4/G4VPhysicalVolume.hh"
+#include "Geant4/G4SystemOfUnits.hh"
+#include "Geant4/Randomize.hh"
 
 // Save ourselves the trouble of typing 'std::' all the time
 using std::string;
@@ -25,11 +46,96 @@ static std::string msgctg = "DetectorHolderService";
 
 // PUBLIC METHODS
 
-// Constructor doesn't do anything with either of its passed components.
-artg4::DetectorHolderService::DetectorHolderService(fhicl::ParameterSet const&,
-						    art::ActivityRegistry&) :
+namespace {
+  typedef std::chrono::steady_clock hitClock;
+
+  double secondsSince(hitClock::time_point start) {
+    return std::chrono::duration<double>( hitClock::now() - start ).count();
+  }
+
+  // The rows of some background hits that fall in a time window, copied
+  // out of the library so that they can be handed over as BackgroundHits
+  class BackgroundRows {
+  public:
+    void select(artg4::BackgroundHits const& hits, double timeShift, double low, double high) {
+      time_.clear(); edep_.clear(); x_.clear(); y_.clear(); z_.clear();
+      volumeID_.clear(); pdgID_.clear(); weight_.clear();
+      for ( std::size_t i = 0; i < hits.size; ++i ) {
+        double t = hits.time[i] + timeShift;
+        if ( t < low || t >= high ) continue;
+        time_.push_back( hits.time[i] );
+        edep_.push_back( hits.edep[i] );
+        x_.push_back( hits.x[i] );
+        y_.push_back( hits.y[i] );
+        z_.push_back( hits.z[i] );
+        volumeID_.push_back( hits.volumeID[i] );
+        pdgID_.push_back( hits.pdgID[i] );
+        weight_.push_back( hits.weight[i] );
+      }
+    }
+
+    artg4::BackgroundHits view() const {
+      artg4::BackgroundHits hits = { time_.size(), time_.data(), edep_.data(), x_.data(), y_.data(),
+                                     z_.data(), volumeID_.data(), pdgID_.data(), weight_.data() };
+      return hits;
+    }
+
+  private:
+    std::vector<double> time_;
+    std::vector<float> edep_, x_, y_, z_;
+    std::vector<std::uint32_t> volumeID_;
+    std::vector<std::int32_t> pdgID_;
+    std::vector<float> weight_;
+  };
+}
+
+// Constructor
+artg4::DetectorHolderService::DetectorHolderService(fhicl::ParameterSet const& p,
+						    art::ActivityRegistry& reg) :
   categoryMap_(),
-  worldPV_(nullptr)
+  worldPV_(nullptr),
+  currentArtEvent_(nullptr),
+  fastSimRegions_(),
+  timeSliceStart_(0),
+  parallelHitConversion_( p.get<bool>("parallelHitConversion", false) ),
+  reportHitConversionTiming_( p.get<bool>("reportHitConversionTiming", false) ),
+  hitTiming_(),
+  background_(),
+  overlayEventsPerEvent_(0),
+  overlayPoisson_(true),
+  overlayTimeMin_(0),
+  overlayTimeMax_(0),
+  nOverlaidEvents_(0),
+  nOverlaidHits_(0),
+  overlayPicks_(),
+  overlayDrawn_(false),
+  overlayDoneBelow_( -std::numeric_limits<double>::infinity() )
+{
+  if ( reportHitConversionTiming_ ) {
+    reg.sPostEndJob.watch(this, &DetectorHolderService::reportHitConversionTiming);
+  }
+
+  if ( p.has_key("backgroundOverlay") ) {
+    fhicl::ParameterSet overlay = p.get<fhicl::ParameterSet>("backgroundOverlay");
+    background_.reset( new BackgroundLibrary( overlay.get<std::string>("libraryFile") ) );
+    if ( background_->nEvents() == 0 ) {
+      throw cet::exception("DetectorHolderService") << "Background library " << background_->fileName()
+                                                    << " has no events\n";
+    }
+    overlayEventsPerEvent_ = overlay.get<double>("eventsPerEvent");
+    overlayPoisson_ = overlay.get<bool>("poisson", true);
+    std::vector<double> timeShift = overlay.get<std::vector<double> >("timeShift", std::vector<double>(2, 0.));
+    if ( timeShift.size() != 2 || timeShift[0] > timeShift[1] ) {
+      throw cet::exception("DetectorHolderService") << "backgroundOverlay.timeShift must be [min, max]\n";
+    }
+    overlayTimeMin_ = timeShift[0] * CLHEP::ns;
+    overlayTimeMax_ = timeShift[1] * CLHEP::ns;
+    reg.sPostEndJob.watch(this, &DetectorHolderService::reportOverlay);
+  }
+}
+
+// Destructor (here, where BackgroundLibrary is complete)
+artg4::DetectorHolderService::~DetectorHolderService()
 {}
 
 // Register a detector object with this service
@@ -77,6 +183,16 @@ void artg4::DetectorHolderService::initialize() {
     
     (entry.second)->initialize();
   }
+
+  // Background hits for a category nobody registered would be dropped
+  if ( background_ ) {
+    for ( auto const& category : background_->categories() ) {
+      if ( categoryMap_.find(category) == categoryMap_.end() ) {
+        mf::LogWarning(msgctg) << "Background library " << background_->fileName() << " has hits for "
+                               << "category " << category << ", but there is no such detector";
+      }
+    }
+  }
 }
 
 // Set up all the detectors' PVs
@@ -89,6 +205,133 @@ void artg4::DetectorHolderService::constructAllPVs()
 
     placeDetector(entry.second);
   } 
+
+  // Regions may name volumes of other detectors, so wait until all are placed
+  for ( auto entry : categoryMap_ ) {
+    applyRegions(entry.second);
+  }
+  for ( auto entry : categoryMap_ ) {
+    applyFastSimulation(entry.second);
+  }
+}
+
+// Fast simulation region and models for a detector
+void artg4::DetectorHolderService::applyFastSimulation(DetectorBase * const db)
+{
+  fhicl::ParameterSet params = db->parameters();
+  if ( ! params.has_key("fastSimulation") ) return;
+  fhicl::ParameterSet fp = params.get<fhicl::ParameterSet>("fastSimulation");
+
+  // The envelope: a named region, or one of its own
+  G4Region * region = nullptr;
+  if ( fp.has_key("region") ) {
+    std::string name = fp.get<std::string>("region");
+    region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if ( ! region ) {
+      throw cet::exception("DetectorHolderService") << "Fast simulation for detector " << db->category()
+                                                    << ": no region named " << name << "\n";
+    }
+  }
+  else {
+    std::string name = db->category() + "FastSim";
+    region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if ( ! region ) {
+      region = new G4Region(name);
+      for ( G4LogicalVolume * lv : db->lvs() ) region->AddRootLogicalVolume(lv);
+    }
+  }
+
+  if ( ! fastSimRegions_.insert( region->GetName() ).second ) return;
+
+  // Models are tried in the order they are made, so a shower library comes
+  // before the parameterization that covers what it cannot
+  fhicl::ParameterSet libraryParams = fp.get<fhicl::ParameterSet>("showerLibrary", fhicl::ParameterSet());
+  if ( libraryParams.get<bool>("enabled", false) ) {
+    new ShowerLibraryModel( db->category() + "ShowerLibrary", region, libraryParams );
+  }
+
+  // The built-in model takes its shower shape from the envelope's material
+  fhicl::ParameterSet showerParams = fp.get<fhicl::ParameterSet>("parameterizedEMShower", fhicl::ParameterSet());
+  if ( showerParams.get<bool>("enabled", false) ) {
+    const G4Material * material = nullptr;
+    if ( region->GetNumberOfRootVolumes() > 0 ) {
+      material = ( *region->GetRootLogicalVolumeIterator() )->GetMaterial();
+    }
+    new ParameterizedEMShowerModel( db->category() + "ParameterizedEMShower", region, showerParams, material );
+  }
+
+  db->makeFastSimulationModels(region);
+
+  mf::LogDebug(msgctg) << "Fast simulation set up for detector " << db->category()
+                       << " in region " << region->GetName();
+}
+
+// Regions, production cuts and user limits for a detector
+void artg4::DetectorHolderService::applyRegions(DetectorBase * const db)
+{
+  std::vector<fhicl::ParameterSet> regions =
+    db->parameters().get<std::vector<fhicl::ParameterSet> >("regions", std::vector<fhicl::ParameterSet>());
+
+  for ( auto const& rp : regions ) {
+    std::string name = rp.get<std::string>("name");
+    G4Region * region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if ( ! region ) region = new G4Region(name);
+
+    // The region's root volumes: named ones, or else all of the detector's
+    std::vector<std::string> volumeNames = rp.get<std::vector<std::string> >("volumes", std::vector<std::string>());
+    std::vector<G4LogicalVolume*> roots;
+    if ( volumeNames.empty() ) roots = db->lvs();
+    for ( auto const& volumeName : volumeNames ) {
+      G4LogicalVolume * lv = G4LogicalVolumeStore::GetInstance()->GetVolume(volumeName, false);
+      if ( ! lv ) {
+        throw cet::exception("DetectorHolderService") << "Region " << name << " of detector "
+                                                      << db->category() << ": no logical volume named "
+                                                      << volumeName << "\n";
+      }
+      roots.push_back(lv);
+    }
+    for ( G4LogicalVolume * lv : roots ) {
+      if ( worldPV_ && lv == worldPV_->GetLogicalVolume() ) {
+        throw cet::exception("DetectorHolderService") << "Region " << name << " of detector "
+                                                      << db->category() << ": the world volume is "
+                                                      << "always in the default region\n";
+      }
+      region->AddRootLogicalVolume(lv);
+    }
+
+    // Production cuts. Particles without their own cut get productionCut,
+    // which defaults to Geant's usual 0.7 mm.
+    static const char* const cutParticles[][2] = { { "gammaCut", "gamma" }, { "electronCut", "e-" },
+                                                   { "positronCut", "e+" }, { "protonCut", "proton" } };
+    bool anyCut = rp.has_key("productionCut");
+    for ( auto const& particle : cutParticles ) anyCut = anyCut || rp.has_key( particle[0] );
+    if ( anyCut ) {
+      G4ProductionCuts * cuts = new G4ProductionCuts;
+      cuts->SetProductionCut( rp.get<double>("productionCut", 0.7) * CLHEP::mm );
+      for ( auto const& particle : cutParticles ) {
+        if ( rp.has_key( particle[0] ) ) {
+          cuts->SetProductionCut( rp.get<double>( particle[0] ) * CLHEP::mm, particle[1] );
+        }
+      }
+      region->SetProductionCuts(cuts);
+    }
+
+    // User limits. Zero means no limit.
+    double maxStep = rp.get<double>("maxStep", 0) * CLHEP::mm;
+    double maxTrackLength = rp.get<double>("maxTrackLength", 0) * CLHEP::mm;
+    double maxTime = rp.get<double>("maxTime", 0) * CLHEP::ns;
+    double minKineticEnergy = rp.get<double>("minKineticEnergy", 0) * CLHEP::MeV;
+    double minRange = rp.get<double>("minRange", 0) * CLHEP::mm;
+    if ( maxStep > 0 || maxTrackLength > 0 || maxTime > 0 || minKineticEnergy > 0 || minRange > 0 ) {
+      region->SetUserLimits( new G4UserLimits( maxStep > 0 ? maxStep : DBL_MAX,
+                                               maxTrackLength > 0 ? maxTrackLength : DBL_MAX,
+                                               maxTime > 0 ? maxTime : DBL_MAX,
+                                               minKineticEnergy, minRange ) );
+    }
+
+    mf::LogDebug(msgctg) << "Region " << name << " for detector " << db->category()
+                         << " has " << roots.size() << " root volumes";
+  }
 }
 
 // Get a specific detector, given a category string.
@@ -132,11 +375,156 @@ void artg4::DetectorHolderService::callArtProduces(art::EDProducer * prod)
 // Convert geant hits to art hits for all detectors
 void artg4::DetectorHolderService::fillEventWithArtHits(G4HCofThisEvent* hc) 
 {
-  // Let's loop over the detectors in the map
+  // Whatever background is left (all of it unless the event was time sliced)
+  if ( background_ ) {
+    overlayBackground( std::numeric_limits<double>::infinity() );
+    overlayPicks_.clear();
+    overlayDrawn_ = false;
+    overlayDoneBelow_ = -std::numeric_limits<double>::infinity();
+  }
+
+  // Detectors that can convert concurrently are started first (if parallel
+  // conversion is on), each on its own thread. Each returns how long it took.
+  std::vector< std::pair<DetectorBase*, std::future<double> > > running;
+  if ( parallelHitConversion_ ) {
+    for ( auto entry : categoryMap_ ) {
+      DetectorBase * db = entry.second;
+      if ( ! db->convertsHitsConcurrently() ) continue;
+      mf::LogDebug(msgctg) << "Starting hit conversion for category " << db->category();
+      running.push_back( std::make_pair( db, std::async( std::launch::async, [db, hc]() {
+                auto start = hitClock::now();
+                db->convertHits(hc);
+                return secondsSince(start);
+              } ) ) );
+    }
+  }
+
+  // Meanwhile, do everybody else here, in category order
   for ( auto entry : categoryMap_ ) {
-    mf::LogDebug(msgctg) << "Converting hits for category " 
-		      << (entry.second)->category();
-    (entry.second)->fillEventWithArtHits(hc);
+    DetectorBase * db = entry.second;
+    if ( parallelHitConversion_ && db->convertsHitsConcurrently() ) continue;
+
+    mf::LogDebug(msgctg) << "Converting hits for category " << db->category();
+    HitConversionTiming & timing = hitTiming_[ db->category() ];
+    auto start = hitClock::now();
+    if ( db->convertsHitsConcurrently() ) {
+      db->convertHits(hc);
+      timing.convertSeconds += secondsSince(start);
+      start = hitClock::now();
+      db->putHits( getCurrArtEvent() );
+      timing.putSeconds += secondsSince(start);
+    }
+    else {
+      // Conversion and put are not separable here; count it all as conversion
+      db->fillEventWithArtHits(hc);
+      timing.convertSeconds += secondsSince(start);
+    }
+    ++timing.nEvents;
+  }
+
+  // Collect the concurrent conversions and put their products serially.
+  // get() rethrows anything a conversion threw.
+  for ( auto & job : running ) {
+    DetectorBase * db = job.first;
+    HitConversionTiming & timing = hitTiming_[ db->category() ];
+    timing.convertSeconds += job.second.get();
+
+    auto start = hitClock::now();
+    db->putHits( getCurrArtEvent() );
+    timing.putSeconds += secondsSince(start);
+    ++timing.nEvents;
+  }
+
+  // The next event starts with a new slice
+  timeSliceStart_ = 0;
+}
+
+// Flush a time slice
+void artg4::DetectorHolderService::flushTimeSlice(double nextSliceStart)
+{
+  // The background that falls in this slice belongs in its hits
+  if ( background_ ) overlayBackground(nextSliceStart);
+
+  for ( auto entry : categoryMap_ ) {
+    mf::LogDebug(msgctg) << "Flushing the time slice starting at " << timeSliceStart_
+                         << " for category " << (entry.second)->category();
+    (entry.second)->flushTimeSlice(timeSliceStart_);
+  }
+  timeSliceStart_ = nextSliceStart;
+}
+
+// Overlay background events
+void artg4::DetectorHolderService::overlayBackground(double upTo)
+{
+  // Pick this event's background events the first time round
+  if ( ! overlayDrawn_ ) {
+    long n = overlayPoisson_ ? CLHEP::RandPoisson::shoot(overlayEventsPerEvent_)
+                             : std::lround(overlayEventsPerEvent_);
+    std::size_t nEvents = background_->nEvents();
+    for ( long i = 0; i < n; ++i ) {
+      std::size_t event = std::min( static_cast<std::size_t>( CLHEP::RandFlat::shoot() * nEvents ), nEvents - 1 );
+      double timeShift = CLHEP::RandFlat::shoot(overlayTimeMin_, overlayTimeMax_);
+      overlayPicks_.push_back( std::make_pair(event, timeShift) );
+    }
+    nOverlaidEvents_ += overlayPicks_.size();
+    overlayDrawn_ = true;
+  }
+
+  // Without time slicing this is the whole event, and the hits can be
+  // handed over straight from the library
+  bool wholeEvent = overlayDoneBelow_ == -std::numeric_limits<double>::infinity() &&
+                    upTo == std::numeric_limits<double>::infinity();
+  BackgroundRows rows;
+
+  for ( auto const& pick : overlayPicks_ ) {
+    for ( auto entry : categoryMap_ ) {
+      int category = background_->categoryIndex(entry.first);
+      if ( category < 0 ) continue;
+      BackgroundHits hits = background_->hits(pick.first, category);
+      if ( ! wholeEvent ) {
+        rows.select(hits, pick.second, overlayDoneBelow_, upTo);
+        hits = rows.view();
+      }
+      if ( hits.size == 0 ) continue;
+      (entry.second)->overlayHits(hits, pick.second);
+      nOverlaidHits_ += hits.size;
+    }
+  }
+  overlayDoneBelow_ = upTo;
+}
+
+// Log the overlay counts
+void artg4::DetectorHolderService::reportOverlay()
+{
+  mf::LogInfo(msgctg) << "Overlaid " << nOverlaidEvents_ << " background events (" << nOverlaidHits_
+                      << " hits) from " << background_->fileName();
+}
+
+// Hash the detectors and their parameters (not the materials; see the header)
+std::uint64_t artg4::DetectorHolderService::geometryFingerprint() const
+{
+  Fingerprint f;
+  for ( auto const& entry : categoryMap_ ) {
+    f.add( entry.first );
+    f.add( entry.second->parameters().to_string() );
+  }
+  return f.value();
+}
+
+// Report time spent on hits
+void artg4::DetectorHolderService::reportHitConversionTiming()
+{
+  mf::LogInfo log(msgctg);
+  log << "Hit conversion time per detector"
+      << ( parallelHitConversion_ ? " (parallel conversion on)" : "" ) << ":\n";
+  for ( auto const& entry : hitTiming_ ) {
+    HitConversionTiming const& t = entry.second;
+    log << "  " << entry.first << ": convert " << t.convertSeconds << " s, put "
+        << t.putSeconds << " s over " << t.nEvents << " events";
+    if ( t.nEvents > 0 ) {
+      log << " (" << 1000. * ( t.convertSeconds + t.putSeconds ) / t.nEvents << " ms/event)";
+    }
+    log << "\n";
   }
 }
 
@@ -15,6 +15,27 @@
 // describing geometry and detector configuration, or get a single detector
 // object of a given category.
 
+// Parameters:
+// - parallelHitConversion (bool): Convert the hits of detectors that support
+//       it (see @DetectorBase::doConvertsHitsConcurrently@) concurrently, one
+//       thread per detector. Their products are still put into the event one
+//       at a time, in category order. Default is false.
+// - reportHitConversionTiming (bool): Log the time each detector spent
+//       converting and putting hits at the end of the job. Default is false.
+// - backgroundOverlay (table): Overlay background events from a library on
+//       every event (see @artg4/util/BackgroundHits.hh@). Off if absent.
+//         backgroundOverlay: {
+//           libraryFile: "beamBackground.bkg"
+//           eventsPerEvent: 2.5       // mean number of background events
+//           poisson: true             // else always round(eventsPerEvent)
+//           timeShift: [ -100, 700 ]  // ns; each is shifted by a uniform time in this range
+//         }
+//       The number of background events and hits overlaid is logged at the
+//       end of the job. If the event is simulated in time slices (see
+//       @artg4/pluginActions/timeSlicing@), each slice gets the background
+//       hits whose shifted time falls in it before it is flushed, and the
+//       last one everything after.
+
 // Authors: Tasha Arvanitis, Adam Lyon
 // Date: July 2012
 
@@ -30,7 +51,12 @@
 
 //#include "artg4/Core/DetectorBase.hh"
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 class G4HCofThisEvent;
@@ -40,12 +66,14 @@ class G4VPhysicalVolume;
 namespace artg4 {
 
   class DetectorBase;
+  class BackgroundLibrary;
 
   class DetectorHolderService {
   public:
     
     // Constructor for GeometryHolder
     DetectorHolderService(fhicl::ParameterSet const&, art::ActivityRegistry&);
+    ~DetectorHolderService();
     
     // This registers the passed detector with the service. 
     void registerDetector(DetectorBase * const db);
@@ -78,6 +106,15 @@ namespace artg4 {
     // Convert GEANT4 hits to Art hits and put them in the event.
     void fillEventWithArtHits(G4HCofThisEvent* hc);
 
+    // The current time slice is done (see @DetectorBase::doFlushTimeSlice@):
+    // have the detectors hand its hits over. The next slice starts at
+    // nextSliceStart.
+    void flushTimeSlice(double nextSliceStart);
+
+    // The global time the open time slice started at; 0 unless the event
+    // is time sliced
+    double timeSliceStart() const { return timeSliceStart_; }
+
     // Set/get the current Art event
     void setCurrArtEvent(art::Event & e) { currentArtEvent_ = &e; }
     art::Event & getCurrArtEvent() { return (*currentArtEvent_); }
@@ -85,8 +122,34 @@ namespace artg4 {
     // Construct all the logical volumes.
     void constructAllLVs();
 
+    // A hash of what the geometry is built from: the detectors and their
+    // parameters. These are fixed for the job, so the hash does not change
+    // between runs; artg4Main uses it as a consistency check. The materials
+    // are deliberately left out: they come from code, and the global
+    // material table grows as materials are first asked for, so hashing it
+    // would make the fingerprint change during the job.
+    std::uint64_t geometryFingerprint() const;
+
   private:
 
+    // Time spent on one detector's hits, summed over events
+    struct HitConversionTiming {
+      HitConversionTiming() : convertSeconds(0), putSeconds(0), nEvents(0) {}
+      double convertSeconds;
+      double putSeconds;
+      unsigned int nEvents;
+    };
+
+    // Log hitTiming_ (at the end of the job)
+    void reportHitConversionTiming();
+
+    // Hand the detectors their hits from this event's background events
+    // that fall (once shifted) below upTo and were not handed over yet
+    void overlayBackground(double upTo);
+
+    // Log the overlay counts (at the end of the job)
+    void reportOverlay();
+
     // Construct all the physical volumes and assign the world physical volume
     // to worldPV_.
     void constructAllPVs();
@@ -100,6 +163,15 @@ namespace artg4 {
     // given detector.
     void placeDetector(DetectorBase * const db);
 
+    // Set up the G4 regions (production cuts and user limits) the given
+    // detector asks for in its @regions@ parameter (see DetectorBase.hh).
+    // Done once everything is placed.
+    void applyRegions(DetectorBase * const db);
+
+    // Set up fast simulation for the given detector, if its
+    // @fastSimulation@ parameter asks for it (see DetectorBase.hh)
+    void applyFastSimulation(DetectorBase * const db);
+
     // A complete map containing all of the detectors that
     // have registered with us so far. Key: DB's category (a string). 
     // Value: pointer to the DetectorBase object.
@@ -112,6 +184,34 @@ namespace artg4 {
     // Hold on to the current Art event
     art::Event * currentArtEvent_;
 
+    // Regions that have been given fast simulation models already (Geant
+    // may be initialized more than once)
+    std::set<std::string> fastSimRegions_;
+
+    // Start of the open time slice
+    double timeSliceStart_;
+
+    // Hit conversion settings (see above) and timing, by category
+    bool parallelHitConversion_;
+    bool reportHitConversionTiming_;
+    std::map<std::string, HitConversionTiming> hitTiming_;
+
+    // Background overlay (see above), and the counts
+    std::unique_ptr<BackgroundLibrary> background_;
+    double overlayEventsPerEvent_;
+    bool overlayPoisson_;
+    double overlayTimeMin_;
+    double overlayTimeMax_;
+    unsigned long nOverlaidEvents_;
+    unsigned long nOverlaidHits_;
+
+    // This event's background events (library index and time shift), drawn
+    // when first needed, and the time below which their hits have been
+    // handed over. A time sliced event gets them slice by slice.
+    std::vector< std::pair<std::size_t, double> > overlayPicks_;
+    bool overlayDrawn_;
+    double overlayDoneBelow_;
+
   };
 
 } // end namespace artg4
@@ -3,25 +3,120 @@
 #include "artg4/services/PhysicsListHolder_service.hh"
 #include "art/Framework/Services/Registry/ServiceMacros.h"
 #include "artg4/services/PhysicsListServiceBase.hh"
+#include "artg4/util/Fingerprint.hh"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Geant4/G4Material.hh"
+#include "Geant4/G4Element.hh"
+#include "Geant4/G4ProductionCuts.hh"
+#include "Geant4/G4Region.hh"
+#include "Geant4/G4RegionStore.hh"
+#include "Geant4/G4Version.hh"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  // The file that marks a complete cache directory
+  const std::string completeMarker = "artg4PhysicsTables.complete";
+
+  // mkdir -p
+  bool makeDirectories(std::string const& path) {
+    std::string::size_type pos = 0;
+    do {
+      pos = path.find('/', pos + 1);
+      std::string sub = path.substr(0, pos);
+      if ( ::mkdir(sub.c_str(), 0775) != 0 && errno != EEXIST ) return false;
+    } while ( pos != std::string::npos );
+    return true;
+  }
+
+  bool exists(std::string const& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+  }
+
+  // Remove a directory of plain files (which is how Geant stores tables)
+  void removeDirectory(std::string const& dir) {
+    if ( DIR* d = ::opendir(dir.c_str()) ) {
+      while ( struct dirent* entry = ::readdir(d) ) {
+        std::string name = entry->d_name;
+        if ( name != "." && name != ".." ) ::unlink( (dir + "/" + name).c_str() );
+      }
+      ::closedir(d);
+    }
+    ::rmdir(dir.c_str());
+  }
+
+  // Everything about the materials that goes into the tables
+  void addMaterials(artg4::Fingerprint & f) {
+    for ( const G4Material* m : *G4Material::GetMaterialTable() ) {
+      f.add( std::string(m->GetName()) );
+      f.add( m->GetDensity() ).add( m->GetTemperature() ).add( m->GetPressure() );
+      f.add( static_cast<int>( m->GetState() ) );
+      const G4double* fractions = m->GetFractionVector();
+      for ( std::size_t i = 0; i < m->GetNumberOfElements(); ++i ) {
+        const G4Element* e = m->GetElement(i);
+        f.add( e->GetZ() ).add( e->GetN() ).add( fractions[i] );
+      }
+    }
+  }
+
+  // The production cuts of every region (the default world region
+  // included), which decide the material-cuts couples the tables are for
+  void addRegionCuts(artg4::Fingerprint & f) {
+    for ( const G4Region* region : *G4RegionStore::GetInstance() ) {
+      f.add( std::string( region->GetName() ) );
+      const G4ProductionCuts* cuts = region->GetProductionCuts();
+      if ( ! cuts ) {
+        f.add( -1 );
+        continue;
+      }
+      for ( int i = 0; i < NumberOfG4CutIndex; ++i ) f.add( cuts->GetProductionCut(i) );
+    }
+  }
+}
+
+artg4::PhysicsListHolderService::PhysicsListHolderService(fhicl::ParameterSet const& p,
+                                                          art::ActivityRegistry&) :
+  physicsListService_(),
+  cacheBase_( p.get<std::string>("physicsTableCache", "") ),
+  cacheAscii_( p.get<bool>("physicsTableCacheAscii", false) ),
+  currentList_(nullptr),
+  storeTo_()
+{}
 
 void artg4::PhysicsListHolderService::registerPhysicsListService( PhysicsListServiceBase* pl ) {
   // There can be only one
   if ( physicsListService_ ) {
     throw cet::exception("PhysicsListHolderService") << "A physics list is already registered.\n";
   }
-  
+
   physicsListService_ = pl;
 }
 
 
-G4VUserPhysicsList* artg4::PhysicsListHolderService::makePhysicsList() const {
+G4VUserPhysicsList* artg4::PhysicsListHolderService::makePhysicsList() {
   // Make sure we have one
   if ( ! physicsListService_ ) {
     throw cet::exception("PhysicsListHolderService") << "No physics list has been registered.\n";
   }
-  
-  // Return the physics list (Geant is going to delete it)
-  return physicsListService_->makePhysicsList();
+
+  // Geant is going to delete it
+  currentList_ = physicsListService_->makePhysicsList();
+  storeTo_.clear();
+
+  return currentList_;
 }
 
 
@@ -30,10 +125,101 @@ void artg4::PhysicsListHolderService::initializePhysicsList() const {
   if ( ! physicsListService_ ) {
     throw cet::exception("PhysicsListHolderService") << "No physics list has been registered.\n";
   }
-  
+
   physicsListService_->initializePhysicsList();
 }
 
+
+void artg4::PhysicsListHolderService::setUpPhysicsTableCache() {
+  storeTo_.clear();
+  if ( cacheBase_.empty() || ! currentList_ ) return;
+
+  if ( physicsListService_->parameterSetID().empty() ) {
+    mf::LogWarning("PhysicsListHolderService")
+      << "The physics list service does not pass its ParameterSet to PhysicsListServiceBase, "
+      << "so cached physics tables are only keyed on its type; clear " << cacheBase_
+      << " after changing its parameters";
+  }
+
+  // Use cached tables if there are some, otherwise arrange to store them
+  std::string dir = cacheDirFor(currentList_);
+  if ( cacheAscii_ ) currentList_->SetStoredInAscii();
+  if ( exists(dir + "/" + completeMarker) ) {
+    mf::LogInfo("PhysicsListHolderService") << "Retrieving physics tables from " << dir;
+    currentList_->SetPhysicsTableRetrieved(dir);
+  }
+  else {
+    mf::LogInfo("PhysicsListHolderService") << "No cached physics tables in " << dir
+                                            << "; they will be built and stored";
+    storeTo_ = dir;
+  }
+}
+
+
+void artg4::PhysicsListHolderService::physicsTablesBuilt() {
+  if ( storeTo_.empty() || ! currentList_ ) return;
+  std::string dir = storeTo_;
+  storeTo_.clear();
+
+  // Another job may have stored them meanwhile
+  if ( exists(dir) ) return;
+
+  // Store into a private directory and move it into place only when
+  // complete, so that a job never sees half a cache
+  std::ostringstream tmp;
+  tmp << dir << ".tmp." << ::getpid();
+  if ( ! makeDirectories( tmp.str() ) ) {
+    mf::LogWarning("PhysicsListHolderService") << "Cannot make " << tmp.str()
+                                               << "; physics tables not cached";
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  bool stored = currentList_->StorePhysicsTable( tmp.str() );
+  if ( stored ) {
+    std::ofstream marker( (tmp.str() + "/" + completeMarker).c_str() );
+    marker << G4Version << "\n";
+    stored = marker.good();
+  }
+
+  if ( ! stored || std::rename( tmp.str().c_str(), dir.c_str() ) != 0 ) {
+    // Failed, or lost a race with another job (which is fine)
+    removeDirectory( tmp.str() );
+    if ( ! stored ) {
+      mf::LogWarning("PhysicsListHolderService") << "Could not store physics tables to " << dir;
+    }
+    return;
+  }
+
+  mf::LogInfo("PhysicsListHolderService")
+    << "Stored physics tables to " << dir << " in "
+    << std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() << " s";
+}
+
+
+std::uint64_t artg4::PhysicsListHolderService::physicsFingerprint() const {
+  Fingerprint f;
+  if ( physicsListService_ ) {
+    f.add( typeid(*physicsListService_).name() );
+    f.add( physicsListService_->parameterSetID() );
+  }
+  f.add( cacheBase_ ).add( cacheAscii_ ? 1 : 0 );
+  return f.value();
+}
+
+
+std::string artg4::PhysicsListHolderService::cacheDirFor(G4VUserPhysicsList* list) const {
+  Fingerprint f;
+  f.add( G4VERSION_NUMBER );
+  f.add( cacheAscii_ ? 1 : 0 );
+  f.add( typeid(*list).name() );
+  f.add( physicsListService_->parameterSetID() );
+  f.add( list->GetDefaultCutValue() );
+  addRegionCuts(f);
+  addMaterials(f);
+  return cacheBase_ + "/" + f.hex();
+}
+
 // Register the service with Art
 using artg4::PhysicsListHolderService;
 DEFINE_ART_SERVICE(PhysicsListHolderService)
@@ -7,6 +7,29 @@
 // to initialize Geant with the *real* physics list class (because it will
 // change things internally). 
 
+// Building the physics tables (cross sections, energy loss, ...) takes
+// minutes, and they only depend on the physics list, the cuts and the
+// materials. With the @physicsTableCache@ parameter set to a directory, the
+// service keeps built tables in a subdirectory of it named after a
+// fingerprint of those: the physics list's type and the ID of its service's
+// ParameterSet (see @PhysicsListServiceBase@), the production cuts of every
+// region, the materials and the Geant version. A later job with the same
+// configuration has Geant retrieve the tables from there instead of building
+// them; otherwise Geant builds them and they are stored once built (see
+// @physicsTablesBuilt@).
+//
+// The fingerprint is all that protects a job from unsuitable tables. Geant
+// only compares the stored material-cuts couples with the current ones (and
+// builds everything if they differ); it cannot tell that a process was
+// configured differently, and a process whose table cannot be retrieved
+// aborts the run rather than being rebuilt.
+
+// Parameters:
+// - physicsTableCache (string): Directory for the cache. Empty (the
+//       default) turns it off.
+// - physicsTableCacheAscii (bool): Store the tables as text rather than
+//       binary. Default is false.
+
 // Include guard
 #ifndef PHYSICSLIST_HOLDER_SERVICE_HH
 #define PHYSICSLIST_HOLDER_SERVICE_HH
@@ -18,6 +41,9 @@
 
 #include "Geant4/G4VUserPhysicsList.hh"
 
+#include <cstdint>
+#include <string>
+
 // Everything for the Art G4 simulation goes in the @artg4@ namespace
 namespace artg4 {
   
@@ -28,9 +54,7 @@ namespace artg4 {
   
     
     // Constructor for Physics List holder
-    PhysicsListHolderService(fhicl::ParameterSet const&, art::ActivityRegistry&) :
-      physicsListService_()
-    {}
+    PhysicsListHolderService(fhicl::ParameterSet const&, art::ActivityRegistry&);
     
     // Destructor - don't do anything
     virtual ~PhysicsListHolderService() {}
@@ -39,14 +63,43 @@ namespace artg4 {
     void registerPhysicsListService( PhysicsListServiceBase* );
     
     // Get Physics list
-    G4VUserPhysicsList* makePhysicsList() const;
+    G4VUserPhysicsList* makePhysicsList();
     
     // Initialize the physics list if necessary
     void initializePhysicsList() const;
 
+    // Call once Geant has been initialized with the list from
+    // @makePhysicsList@ (so the geometry, materials and region cuts are
+    // final) and before the run is. Has Geant retrieve the tables if the
+    // cache has them, otherwise arranges for them to be stored.
+    void setUpPhysicsTableCache();
+
+    // Call once Geant has built the physics tables for the list from
+    // @makePhysicsList@ (i.e. after the run has been initialized). Stores
+    // the tables if the cache did not have them.
+    void physicsTablesBuilt();
+
+    // A hash of what the physics is built from (the registered physics
+    // list service, its ParameterSet and the cache settings). Like
+    // DetectorHolderService::geometryFingerprint, it is fixed for the job.
+    std::uint64_t physicsFingerprint() const;
+
   private:
+
+    // The cache directory for this list and the current regions and
+    // materials
+    std::string cacheDirFor(G4VUserPhysicsList* list) const;
     
     PhysicsListServiceBase* physicsListService_;
+
+    // Physics table cache settings (see above)
+    std::string cacheBase_;
+    bool cacheAscii_;
+
+    // The list last made (Geant owns it) and the cache directory its tables
+    // should be stored to, if any
+    G4VUserPhysicsList* currentList_;
+    std::string storeTo_;
     
   }; // class PhysicsListHolderService
   
@@ -5,7 +5,10 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "artg4/services/PhysicsListHolder_service.hh"
 
+#include "fhiclcpp/ParameterSet.h"
+
 #include <memory>
+#include <string>
 #include "Geant4/G4VUserPhysicsList.hh"
 
 namespace artg4 {
@@ -14,11 +17,29 @@ namespace artg4 {
     
     public:
     
-    // The constructor does the registration
-    PhysicsListServiceBase() {
+    // The constructor does the registration. Pass the service's
+    // ParameterSet so that its configuration is part of the physics table
+    // cache key (see @PhysicsListHolderService@); otherwise only the type
+    // of the service is, and changing its parameters would reuse tables
+    // built for the old ones.
+    PhysicsListServiceBase() :
+      parameterSetID_()
+    {
+      art::ServiceHandle<PhysicsListHolderService> ph;
+      ph->registerPhysicsListService( this );
+    }
+
+    explicit PhysicsListServiceBase(fhicl::ParameterSet const& p) :
+      parameterSetID_( p.id().to_string() )
+    {
       art::ServiceHandle<PhysicsListHolderService> ph;
       ph->registerPhysicsListService( this );
     }
+
+    virtual ~PhysicsListServiceBase() {}
+
+    // The ID of the ParameterSet given to the constructor (empty if none)
+    std::string const& parameterSetID() const { return parameterSetID_; }
     
     
     // Make the physics list
@@ -28,6 +49,9 @@ namespace artg4 {
     // This gets called AFTER the physics list is given to Geant.
     // If you don't override it, then nothing will happen when called
     virtual void initializePhysicsList() {};
+
+  private:
+    std::string parameterSetID_;
   };
     
 }//namespace artg4
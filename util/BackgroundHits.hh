@@ -0,0 +1,41 @@
+// Background hits to overlay
+//
+// Beam backgrounds are independent of the signal, so instead of simulating
+// them in every event they can be simulated once, kept in a library (see
+// @artg4/overlay/BackgroundLibrary.hh@) and overlaid: at the end of each
+// event the DetectorHolderService picks background events from the library
+// at random, shifts them in time and hands each detector its hits from
+// them (see @DetectorBase::doOverlayHits@), before the detector puts its
+// hits into the event. A time sliced event gets each slice's share before
+// the slice is flushed.
+//
+// @BackgroundHits@ is one detector's hits from one background event: the
+// standard columns of a @SoAHitCollection@ (see @SoAHitCollection.hh@),
+// except the track IDs, which mean nothing in another event. The columns
+// point into the library and are only good until the detector returns.
+//
+// @SoASensitiveDetector@ (see @SoASensitiveDetector.hh@) can append them to
+// its collection with @overlay@.
+
+#ifndef BACKGROUNDHITS_HH
+#define BACKGROUNDHITS_HH
+
+#include <cstddef>
+#include <cstdint>
+
+namespace artg4 {
+
+  struct BackgroundHits {
+    std::size_t size;
+    const double* time;       // in the background event, before the shift
+    const float* edep;
+    const float* x;
+    const float* y;
+    const float* z;
+    const std::uint32_t* volumeID;
+    const std::int32_t* pdgID;
+    const float* weight;      // never empty; 1 for unweighted rows
+  };
+}
+
+#endif
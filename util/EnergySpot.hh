@@ -0,0 +1,40 @@
+// Energy spots from fast simulation
+//
+// A fast simulation model (e.g. @artg4::ParameterizedEMShowerModel@, see
+// @artg4/fastSim@) does not make G4 steps inside the volumes it covers.
+// Instead it deposits its energy as spots: a position, an energy and a
+// time. A sensitive detector that wants those spots recorded as hits
+// inherits from @EnergySpotSensitiveDetector@ as well as from
+// @G4VSensitiveDetector@; the model finds the volume each spot is in and
+// hands the spot to that volume's sensitive detector.
+//
+// @SoASensitiveDetector@ (see @SoASensitiveDetector.hh@) does this already.
+
+#ifndef ENERGYSPOT_HH
+#define ENERGYSPOT_HH
+
+#include "Geant4/G4ThreeVector.hh"
+
+class G4VTouchable;
+class G4Track;
+
+namespace artg4 {
+
+  struct EnergySpot {
+    G4ThreeVector position;   // global
+    double energy;
+    double time;              // global
+  };
+
+  class EnergySpotSensitiveDetector {
+  public:
+    virtual ~EnergySpotSensitiveDetector() {}
+
+    // Record a spot in the volume given by the touchable. The track is the
+    // one the model replaced (the shower's parent).
+    virtual void processSpot(EnergySpot const& spot, const G4VTouchable* touchable,
+                             const G4Track& track) = 0;
+  };
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Event abort status products
+//
+// When artg4Main has an event budget (see
+// @artg4/geantInit/ArtG4EventWatchdog.hh@), every event gets an
+// @EventAbortStatus@ saying whether Geant abandoned it for going over
+// budget. An aborted event's hits and other products are incomplete. The
+// status holds the state of the random engine at the start of the event, so
+// the event can be simulated again in isolation (e.g. to debug it) by
+// restoring that state.
+//
+// Each run gets an @EventAbortRunSummary@ counting the aborted events.
+
+#ifndef EVENTABORTSTATUS_HH
+#define EVENTABORTSTATUS_HH
+
+#include <string>
+#include <vector>
+
+namespace artg4 {
+
+  // Why an event was aborted
+  enum EventAbortReason {
+    kNotAborted = 0,
+    kWallTimeExceeded = 1,
+    kCPUTimeExceeded = 2,
+    kStepsExceeded = 3
+  };
+
+  class EventAbortStatus {
+  public:
+
+    EventAbortStatus() :
+      aborted(false), reason(kNotAborted), wallSeconds(0), cpuSeconds(0), nSteps(0),
+      engineName(), engineState()
+    {}
+
+    virtual ~EventAbortStatus() {}
+
+    bool aborted;
+    int reason;                 // an EventAbortReason
+    double wallSeconds;         // spent on the event (up to the abort)
+    double cpuSeconds;
+    unsigned long nSteps;
+
+    // The random engine at the start of the event, as written by
+    // @CLHEP::HepRandomEngine::put@ (aborted events only)
+    std::string engineName;
+    std::string engineState;
+  };
+
+  class EventAbortRunSummary {
+  public:
+
+    EventAbortRunSummary() :
+      nEvents(0), nWallTimeExceeded(0), nCPUTimeExceeded(0), nStepsExceeded(0),
+      abortedEvents()
+    {}
+
+    virtual ~EventAbortRunSummary() {}
+
+    unsigned int nEvents;
+    unsigned int nWallTimeExceeded;
+    unsigned int nCPUTimeExceeded;
+    unsigned int nStepsExceeded;
+
+    // Event numbers of the aborted events
+    std::vector<unsigned int> abortedEvents;
+
+#ifndef __GCCXML__
+    unsigned int nAborted() const { return abortedEvents.size(); }
+#endif
+  };
+}
+
+#endif
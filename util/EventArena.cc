@@ -0,0 +1,76 @@
+// Implementation of the event arena
+
+#include "artg4/util/EventArena.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+artg4::EventArena& artg4::EventArena::instance() {
+  static EventArena arena;
+  return arena;
+}
+
+artg4::EventArena::EventArena() :
+  blocks_(),
+  current_(0),
+  offset_(0),
+  bytesInUse_(0),
+  nAllocations_(0),
+  peakBytesInUse_(0)
+{}
+
+artg4::EventArena::~EventArena() {
+  for ( auto const& block : blocks_ ) ::operator delete(block.data);
+}
+
+void* artg4::EventArena::allocate(std::size_t bytes, std::size_t alignment) {
+
+  ++nAllocations_;
+  bytesInUse_ += bytes;
+
+  // Try the current block, then the (already allocated) ones after it
+  while ( current_ < blocks_.size() ) {
+    Block & block = blocks_[current_];
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block.data) + offset_;
+    std::size_t padding = ( alignment - start % alignment ) % alignment;
+    if ( offset_ + padding + bytes <= block.size ) {
+      offset_ += padding + bytes;
+      return reinterpret_cast<void*>(start + padding);
+    }
+    ++current_;
+    offset_ = 0;
+  }
+
+  // Need a new block. ::operator new memory is aligned for any type.
+  Block block;
+  block.size = std::max(bytes, blockSize_);
+  block.data = static_cast<char*>( ::operator new(block.size) );
+  blocks_.push_back(block);
+  current_ = blocks_.size() - 1;
+  offset_ = bytes;
+  return block.data;
+}
+
+void artg4::EventArena::reset() {
+  peakBytesInUse_ = std::max(peakBytesInUse_, bytesInUse_);
+
+  // Oversized blocks were for unusual events; don't hold on to them
+  std::vector<Block> kept;
+  for ( auto const& block : blocks_ ) {
+    if ( block.size > blockSize_ ) ::operator delete(block.data);
+    else kept.push_back(block);
+  }
+  blocks_.swap(kept);
+
+  current_ = 0;
+  offset_ = 0;
+  bytesInUse_ = 0;
+  nAllocations_ = 0;
+}
+
+std::size_t artg4::EventArena::bytesReserved() const {
+  std::size_t total = 0;
+  for ( auto const& block : blocks_ ) total += block.size;
+  return total;
+}
@@ -0,0 +1,103 @@
+// Event-scoped arena allocator for G4 hits
+//
+// Sensitive detectors typically allocate every G4 hit with @new@, and each
+// one is freed again with @delete@ when Geant deletes the event. In a long
+// production job that is a great deal of malloc/free traffic for objects
+// that all die at the same moment.
+//
+// A hit class can opt into the event arena instead:
+//
+//   class MyHit : public G4VHit, public artg4::EventArenaAllocated<MyHit> { ... };
+//
+// Its @operator new@ then carves the object out of large blocks owned by
+// the @EventArena@, and its @operator delete@ does nothing. Destructors
+// still run as usual (the hits collection still deletes its hits), only the
+// memory is not returned one object at a time. Instead the whole arena is
+// reset by @ArtG4RunManager@ once Geant has deleted the event, and its
+// blocks are reused for the next event.
+//
+// If Geant keeps events beyond the end of the event (e.g. for
+// visualization), the reset is put off until the end of the run.
+//
+// Only objects whose lifetime ends with the G4 event may use the arena. It
+// is not thread safe; artg4 runs Geant sequentially.
+
+#ifndef EVENTARENA_HH
+#define EVENTARENA_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace artg4 {
+
+  class EventArena {
+  public:
+
+    // The one arena
+    static EventArena& instance();
+
+    // Memory for one object. Requests larger than the block size get a
+    // block of their own.
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    // Forget everything allocated so far. Standard size blocks are kept for
+    // reuse; oversized ones are freed.
+    void reset();
+
+    // h3. Statistics
+
+    // Bytes handed out since the last reset
+    std::size_t bytesInUse() const { return bytesInUse_; }
+
+    // Bytes currently held in blocks
+    std::size_t bytesReserved() const;
+
+    // Allocations since the last reset
+    std::size_t nAllocations() const { return nAllocations_; }
+
+    // Largest bytesInUse seen at a reset
+    std::size_t peakBytesInUse() const { return peakBytesInUse_; }
+
+    ~EventArena();
+
+  private:
+
+    EventArena();
+    EventArena(EventArena const&);
+    EventArena& operator=(EventArena const&);
+
+    struct Block {
+      char* data;
+      std::size_t size;
+    };
+
+    static const std::size_t blockSize_ = 1 << 20;
+
+    // Blocks in allocation order; current_ is the one being filled
+    std::vector<Block> blocks_;
+    std::size_t current_;
+    std::size_t offset_;
+
+    std::size_t bytesInUse_;
+    std::size_t nAllocations_;
+    std::size_t peakBytesInUse_;
+  };
+
+  // Base class for types that live in the event arena (see above)
+  template <typename T>
+  class EventArenaAllocated {
+  public:
+    static void* operator new(std::size_t bytes) {
+      return EventArena::instance().allocate(bytes, alignof(T));
+    }
+
+    // The memory goes back when the arena is reset
+    static void operator delete(void*) {}
+
+  protected:
+    EventArenaAllocated() {}
+    ~EventArenaAllocated() {}
+  };
+}
+
+#endif
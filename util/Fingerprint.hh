@@ -0,0 +1,61 @@
+// Fingerprints for cache keys
+//
+// A 64 bit FNV-1a hash built up piece by piece, for naming caches after
+// everything that went into what they hold:
+//
+//   artg4::Fingerprint f;
+//   f.add(listName).add(defaultCut).add(G4VERSION_NUMBER);
+//   std::string dir = base + "/" + f.hex();
+//
+// Not a cryptographic hash; it only has to tell configurations apart.
+
+#ifndef FINGERPRINT_HH
+#define FINGERPRINT_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+namespace artg4 {
+
+  class Fingerprint {
+  public:
+
+    Fingerprint() : h_(14695981039346656037ULL) {}
+
+    // Raw bytes
+    Fingerprint& add(const void* data, std::size_t n) {
+      const unsigned char* p = static_cast<const unsigned char*>(data);
+      for ( std::size_t i = 0; i < n; ++i ) {
+        h_ ^= p[i];
+        h_ *= 1099511628211ULL;
+      }
+      return *this;
+    }
+
+    // A string, including its terminator (so "ab","c" differs from "a","bc")
+    Fingerprint& add(std::string const& s) { return add(s.c_str(), s.size() + 1); }
+    Fingerprint& add(const char* s) { return add( std::string(s) ); }
+
+    // A number
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, Fingerprint&>::type
+    add(T value) { return add(&value, sizeof value); }
+
+    std::uint64_t value() const { return h_; }
+
+    // 16 hex digits, e.g. for a file or directory name
+    std::string hex() const {
+      char buffer[17];
+      std::snprintf(buffer, sizeof buffer, "%016llx", static_cast<unsigned long long>(h_));
+      return buffer;
+    }
+
+  private:
+    std::uint64_t h_;
+  };
+}
+
+#endif
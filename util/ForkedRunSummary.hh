@@ -0,0 +1,54 @@
+// Run summary of a forked artg4 job
+//
+// When artg4Main forks workers (see @WorkerPartition.hh@), each worker puts
+// a summary of its part of the run into its own run, and the parent puts
+// the summaries of all workers (one row each) together with the aggregate
+// throughput into its run.
+
+#ifndef FORKEDRUNSUMMARY_HH
+#define FORKEDRUNSUMMARY_HH
+
+#include <vector>
+
+namespace artg4 {
+
+  class ForkedRunSummary {
+  public:
+
+    ForkedRunSummary() :
+      rank(), nEvents(), wallSeconds(), cpuSeconds(), totalEvents(0), eventsPerSecond(0)
+    {}
+
+    virtual ~ForkedRunSummary() {}
+
+    // h3. One row per worker
+
+    std::vector<int> rank;
+    std::vector<unsigned int> nEvents;      // events simulated in this run
+    std::vector<double> wallSeconds;        // from begin to end of run
+    std::vector<double> cpuSeconds;
+
+    // h3. All workers
+
+    unsigned int totalEvents;
+    double eventsPerSecond;   // totalEvents over the slowest worker's wall time
+
+#ifndef __GCCXML__
+
+    void addWorker(int r, unsigned int events, double wall, double cpu) {
+      rank.push_back(r);
+      nEvents.push_back(events);
+      wallSeconds.push_back(wall);
+      cpuSeconds.push_back(cpu);
+
+      totalEvents += events;
+      double slowest = 0;
+      for ( double w : wallSeconds ) if ( w > slowest ) slowest = w;
+      eventsPerSecond = slowest > 0 ? totalEvents / slowest : 0;
+    }
+
+#endif
+  };
+}
+
+#endif
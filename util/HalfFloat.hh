@@ -0,0 +1,76 @@
+// IEEE 754 half precision (16 bit) floats
+//
+// Conversion between float and the bit pattern of the nearest half, for
+// storing quantities that do not need float's 24 bits of mantissa (see
+// @QuantizedHitCollection.hh@). A half has an 11 bit mantissa (a relative
+// precision of about 5e-4) and covers 6e-8 to 65504.
+
+#ifndef HALFFLOAT_HH
+#define HALFFLOAT_HH
+
+#include <cstdint>
+#include <cstring>
+
+namespace artg4 {
+
+  // The half nearest to f (ties to even). Too large values become infinity.
+  inline std::uint16_t halfFromFloat(float f) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof bits);
+
+    std::uint32_t sign = (bits >> 16) & 0x8000;
+    std::uint32_t exponent = (bits >> 23) & 0xff;
+    std::uint32_t mantissa = bits & 0x7fffff;
+
+    // Infinity and NaN
+    if ( exponent == 0xff ) return sign | 0x7c00 | ( mantissa ? 0x200 : 0 );
+
+    int e = static_cast<int>(exponent) - 127 + 15;
+    if ( e >= 31 ) return sign | 0x7c00;
+
+    // Subnormal half (or zero)
+    if ( e <= 0 ) {
+      if ( e < -10 ) return sign;
+      mantissa |= 0x800000;
+      int shift = 14 - e;
+      std::uint32_t half = mantissa >> shift;
+      std::uint32_t rest = mantissa & ( (1u << shift) - 1 );
+      std::uint32_t halfway = 1u << (shift - 1);
+      if ( rest > halfway || ( rest == halfway && (half & 1) ) ) ++half;
+      return sign | half;
+    }
+
+    // A carry out of the mantissa correctly bumps the exponent
+    std::uint32_t half = ( static_cast<std::uint32_t>(e) << 10 ) | ( mantissa >> 13 );
+    std::uint32_t rest = mantissa & 0x1fff;
+    if ( rest > 0x1000 || ( rest == 0x1000 && (half & 1) ) ) ++half;
+    return sign | half;
+  }
+
+  // The float value of a half
+  inline float floatFromHalf(std::uint16_t h) {
+    std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+    std::uint32_t exponent = (h >> 10) & 0x1f;
+    std::uint32_t mantissa = h & 0x3ff;
+    std::uint32_t bits;
+
+    if ( exponent == 0 ) {
+      if ( mantissa == 0 ) bits = sign;
+      else {
+        // Normalize the subnormal
+        int e = 1;
+        while ( ! (mantissa & 0x400) ) { mantissa <<= 1; --e; }
+        mantissa &= 0x3ff;
+        bits = sign | ( static_cast<std::uint32_t>(e + 112) << 23 ) | ( mantissa << 13 );
+      }
+    }
+    else if ( exponent == 31 ) bits = sign | 0x7f800000 | ( mantissa << 13 );
+    else bits = sign | ( (exponent + 112) << 23 ) | ( mantissa << 13 );
+
+    float f;
+    std::memcpy(&f, &bits, sizeof f);
+    return f;
+  }
+}
+
+#endif
@@ -0,0 +1,174 @@
+// Hit quantization settings, and quantizing a SoAHitCollection
+//
+// Hits are recorded with full float and double precision, far more than
+// any detector resolves, and RootOutput compresses those low bits poorly. A
+// detector can instead put a @QuantizedHitCollection@ (see
+// @QuantizedHitCollection.hh@) with only the precision it needs.
+//
+// The settings come from a @quantization@ table in the detector's
+// parameters (@DetectorBase::parameters()@), e.g.
+//
+//   quantization: {
+//     enabled: true
+//     timeResolution: 0.01       // ns
+//     positionResolution: 0.01   // mm
+//     halfPrecisionEnergy: true  // 16 bit energies, else 32 bit
+//   }
+//
+// and the detector uses them like so:
+//
+//   // constructor
+//   quantization_( parameters() )
+//
+//   void MyDetector::doCallArtProduces(art::EDProducer * producer) {
+//     if ( quantization_.enabled ) producer->produces<artg4::BasicQuantizedHitCollection>(myName());
+//     else producer->produces<artg4::BasicSoAHitCollection>(myName());
+//   }
+//
+//   void MyDetector::doFillEventWithArtHits(G4HCofThisEvent*) {
+//     art::ServiceHandle<artg4::DetectorHolderService> dh;
+//     if ( quantization_.enabled ) dh->getCurrArtEvent().put( artg4::quantizeHits(sd_->takeHits(), quantization_), myName() );
+//     else dh->getCurrArtEvent().put( sd_->takeHits(), myName() );
+//   }
+//
+// By default a volume's cell origin is the position of its first hit. A
+// detector that knows its cell centres can pass a function returning them
+// instead, which keeps the offsets small.
+//
+// Times more than 2^32 ticks after the first hit are clamped to the last
+// tick.
+
+#ifndef HITQUANTIZATION_HH
+#define HITQUANTIZATION_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "artg4/util/SoAHitCollection.hh"
+#include "artg4/util/QuantizedHitCollection.hh"
+#include "artg4/util/HalfFloat.hh"
+
+namespace artg4 {
+
+  struct HitQuantization {
+
+    // Quantization off
+    HitQuantization() :
+      enabled(false), timeResolution(0.01), positionResolution(0.01), halfPrecisionEnergy(false)
+    {}
+
+    // From the @quantization@ table of a detector's parameters; off if there
+    // is no such table
+    explicit HitQuantization(fhicl::ParameterSet const& detectorParams) :
+      HitQuantization()
+    {
+      fhicl::ParameterSet p = detectorParams.get<fhicl::ParameterSet>("quantization", fhicl::ParameterSet());
+      enabled = p.get<bool>("enabled", false);
+      timeResolution = p.get<double>("timeResolution", timeResolution);
+      positionResolution = p.get<double>("positionResolution", positionResolution);
+      halfPrecisionEnergy = p.get<bool>("halfPrecisionEnergy", halfPrecisionEnergy);
+    }
+
+    bool enabled;
+    double timeResolution;       // ns
+    double positionResolution;   // mm
+    bool halfPrecisionEnergy;
+  };
+
+  // A detector's cell centre for a volume ID
+  typedef std::function< std::array<float, 3>(unsigned int) > CellCentreFunction;
+
+  // Quantize a collection (as returned by @SoASensitiveDetector::takeHits@).
+  // Its extra columns are moved over untouched.
+  template <typename EXTRA>
+  std::unique_ptr< QuantizedHitCollection<EXTRA> >
+  quantizeHits(std::unique_ptr< SoAHitCollection<EXTRA> > hits,
+               HitQuantization const& q,
+               CellCentreFunction const& cellCentre = CellCentreFunction())
+  {
+    std::unique_ptr< QuantizedHitCollection<EXTRA> > out( new QuantizedHitCollection<EXTRA> );
+    std::size_t n = hits->size();
+
+    out->timeResolution = q.timeResolution;
+    out->positionResolution = q.positionResolution;
+    out->halfEnergies = q.halfPrecisionEnergy;
+    out->t0 = n ? *std::min_element( hits->time.begin(), hits->time.end() ) : 0;
+
+    if ( q.halfPrecisionEnergy ) out->edepHalf.reserve(n);
+    else out->edepFloat.reserve(n);
+    out->timeTicks.reserve(n);
+    out->cell.reserve(n);
+    out->dx.reserve(n);
+    out->dy.reserve(n);
+    out->dz.reserve(n);
+
+    // The most recently made cell of each volume
+    std::unordered_map<unsigned int, std::uint32_t> cellOfVolume;
+    const double maxTicks = std::numeric_limits<std::uint32_t>::max();
+    const double maxOffset = std::numeric_limits<std::int16_t>::max();
+
+    auto addCell = [&out](unsigned int volume, float x, float y, float z) {
+      out->cellVolumeID.push_back(volume);
+      out->cellX.push_back(x);
+      out->cellY.push_back(y);
+      out->cellZ.push_back(z);
+      return static_cast<std::uint32_t>( out->cellVolumeID.size() - 1 );
+    };
+
+    auto offset = [&q](float pos, float origin) {
+      return std::round( (pos - origin) / q.positionResolution );
+    };
+
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( q.halfPrecisionEnergy ) out->edepHalf.push_back( halfFromFloat(hits->edep[i]) );
+      else out->edepFloat.push_back( hits->edep[i] );
+
+      double ticks = std::round( (hits->time[i] - out->t0) / q.timeResolution );
+      out->timeTicks.push_back( static_cast<std::uint32_t>( std::min(ticks, maxTicks) ) );
+
+      // Find a cell of this volume from which the hit can be reached, or
+      // make one
+      unsigned int volume = hits->volumeID[i];
+      float x = hits->x[i], y = hits->y[i], z = hits->z[i];
+      auto found = cellOfVolume.find(volume);
+      std::uint32_t c;
+      if ( found == cellOfVolume.end() ) {
+        if ( cellCentre ) {
+          std::array<float, 3> centre = cellCentre(volume);
+          c = addCell(volume, centre[0], centre[1], centre[2]);
+        }
+        else c = addCell(volume, x, y, z);
+        cellOfVolume[volume] = c;
+      }
+      else c = found->second;
+
+      double ox = offset(x, out->cellX[c]), oy = offset(y, out->cellY[c]), oz = offset(z, out->cellZ[c]);
+      if ( std::abs(ox) > maxOffset || std::abs(oy) > maxOffset || std::abs(oz) > maxOffset ) {
+        c = addCell(volume, x, y, z);
+        cellOfVolume[volume] = c;
+        ox = oy = oz = 0;
+      }
+      out->cell.push_back(c);
+      out->dx.push_back( static_cast<std::int16_t>(ox) );
+      out->dy.push_back( static_cast<std::int16_t>(oy) );
+      out->dz.push_back( static_cast<std::int16_t>(oz) );
+    }
+
+    out->trackID = std::move(hits->trackID);
+    out->pdgID = std::move(hits->pdgID);
+    out->weight = std::move(hits->weight);
+    out->extra = std::move(hits->extra);
+    return out;
+  }
+}
+
+#endif
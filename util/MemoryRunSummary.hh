@@ -0,0 +1,71 @@
+// Memory use of the events of a run
+//
+// When artg4Main has its @memoryMonitor@ on (see
+// @artg4/geantInit/ArtG4MemoryMonitor.hh@), each run gets a
+// @MemoryRunSummary@: for every event, how much the resident set (RSS) and
+// the heap in use (what the allocator has handed out and not had back)
+// changed in each phase of the event, and where they stood once the event
+// was gone. A job that grows event after event shows it in the heap at the
+// end of its events; the phase deltas say who is holding on to the memory:
+// Geant and the stepping actions while tracking, the detectors while
+// converting hits, or the actions while filling the Art event.
+//
+// All sizes are in bytes. The heap numbers are 0 where the allocator
+// cannot report them.
+
+#ifndef MEMORYRUNSUMMARY_HH
+#define MEMORYRUNSUMMARY_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace artg4 {
+
+  // The phases of an event, in order
+  enum MemoryPhase {
+    kGeneratePhase = 0,        // making the primaries
+    kTrackPhase = 1,           // tracking, up to the end of event action
+    kHitConversionPhase = 2,   // the detectors' hit conversion and put
+    kArtPutPhase = 3,          // the actions' fillEventWithArtStuff
+    kCleanupPhase = 4,         // from then until Geant has deleted the event
+    kNMemoryPhases = 5
+  };
+
+  class MemoryRunSummary {
+  public:
+
+    MemoryRunSummary() :
+      event(), rssAtEnd(), heapAtEnd(), rssDelta(), heapDelta(),
+      peakRss(0), longestGrowth(0), growthFlagged(false)
+    {}
+
+    virtual ~MemoryRunSummary() {}
+
+    // One entry per event
+    std::vector<unsigned int> event;
+    std::vector<long long> rssAtEnd;     // after the event was deleted
+    std::vector<long long> heapAtEnd;
+
+    // kNMemoryPhases entries per event, event by event
+    std::vector<long long> rssDelta;
+    std::vector<long long> heapDelta;
+
+    long long peakRss;                   // high water mark of the process so far
+    unsigned int longestGrowth;          // most events in a row that each ended bigger
+    bool growthFlagged;                  // longestGrowth reached the monitor's limit
+
+#ifndef __GCCXML__
+    std::size_t nEvents() const { return event.size(); }
+
+    long long rssDeltaOf(std::size_t i, MemoryPhase phase) const { return rssDelta[i * kNMemoryPhases + phase]; }
+    long long heapDeltaOf(std::size_t i, MemoryPhase phase) const { return heapDelta[i * kNMemoryPhases + phase]; }
+
+    static const char* phaseName(MemoryPhase phase) {
+      static const char* names[kNMemoryPhases] = { "generate", "track", "hit conversion", "art put", "cleanup" };
+      return names[phase];
+    }
+#endif
+  };
+}
+
+#endif
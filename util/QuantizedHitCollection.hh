@@ -0,0 +1,108 @@
+// Quantized structure-of-arrays hit collection
+//
+// The same rows as a @SoAHitCollection@ (see @SoAHitCollection.hh@), stored
+// with no more precision than the detector asked for, so that RootOutput
+// writes (and compresses) far fewer bytes:
+//
+// * time is an unsigned count of @timeResolution@ ticks after @t0@, the
+//   earliest hit time in the collection
+// * energy is a half precision float (see @HalfFloat.hh@) if
+//   @halfEnergies@, otherwise a float
+// * position is a 16 bit offset, in units of @positionResolution@, from the
+//   row's cell. The cells (a volume ID and an origin) are listed once per
+//   collection; a volume can have more than one cell if its hits are too far
+//   apart to reach from one origin.
+//
+// Make one from a @SoAHitCollection@ with @quantizeHits@ (see
+// @HitQuantization.hh@) and read it back with the accessors, e.g. @edep(i)@.
+//
+// Only the data members are visible to Root (hence the @__GCCXML__@ ifdefs).
+
+#ifndef QUANTIZEDHITCOLLECTION_HH
+#define QUANTIZEDHITCOLLECTION_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "artg4/util/SoAHitCollection.hh"
+
+#ifndef __GCCXML__
+#include "artg4/util/HalfFloat.hh"
+#endif
+
+namespace artg4 {
+
+  template <typename EXTRA = NoExtraHitColumns>
+  class QuantizedHitCollection {
+  public:
+
+    QuantizedHitCollection() :
+      t0(0), timeResolution(0), positionResolution(0), halfEnergies(false),
+      cellVolumeID(), cellX(), cellY(), cellZ(),
+      edepHalf(), edepFloat(), timeTicks(), cell(), dx(), dy(), dz(),
+      trackID(), pdgID(), weight(), extra()
+    {}
+
+    virtual ~QuantizedHitCollection() {}
+
+#ifndef __GCCXML__
+    // Movable, like SoAHitCollection
+    QuantizedHitCollection(QuantizedHitCollection const&) = default;
+    QuantizedHitCollection(QuantizedHitCollection &&) = default;
+    QuantizedHitCollection& operator=(QuantizedHitCollection const&) = default;
+    QuantizedHitCollection& operator=(QuantizedHitCollection &&) = default;
+#endif
+
+    // h3. Precision of this collection
+
+    double t0;                    // time of tick 0
+    double timeResolution;        // length of a tick
+    float positionResolution;     // position offset unit
+    bool halfEnergies;            // edepHalf is filled rather than edepFloat
+
+    // h3. The cells
+
+    std::vector<unsigned int> cellVolumeID;
+    std::vector<float> cellX, cellY, cellZ;
+
+    // h3. The columns
+
+    std::vector<std::uint16_t> edepHalf;
+    std::vector<float> edepFloat;
+    std::vector<std::uint32_t> timeTicks;
+    std::vector<std::uint32_t> cell;          // index into the cell list
+    std::vector<std::int16_t> dx, dy, dz;     // offset from the cell origin
+    std::vector<int> trackID;
+    std::vector<int> pdgID;
+    std::vector<float> weight;                // as in SoAHitCollection
+
+    EXTRA extra;
+
+#ifndef __GCCXML__
+
+    typedef EXTRA extra_type;
+
+    std::size_t size() const { return timeTicks.size(); }
+    bool empty() const { return timeTicks.empty(); }
+
+    // h3. Row i, as it was before quantization (to within the resolution)
+
+    float edep(std::size_t i) const {
+      return halfEnergies ? floatFromHalf(edepHalf[i]) : edepFloat[i];
+    }
+    double time(std::size_t i) const { return t0 + timeTicks[i] * timeResolution; }
+    float x(std::size_t i) const { return cellX[cell[i]] + dx[i] * positionResolution; }
+    float y(std::size_t i) const { return cellY[cell[i]] + dy[i] * positionResolution; }
+    float z(std::size_t i) const { return cellZ[cell[i]] + dz[i] * positionResolution; }
+    unsigned int volumeID(std::size_t i) const { return cellVolumeID[cell[i]]; }
+    float rowWeight(std::size_t i) const { return weight.empty() ? 1 : weight[i]; }
+
+#endif
+  };
+
+  // The quantized version of BasicSoAHitCollection
+  typedef QuantizedHitCollection<NoExtraHitColumns> BasicQuantizedHitCollection;
+}
+
+#endif
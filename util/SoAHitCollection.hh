@@ -0,0 +1,141 @@
+// Structure-of-arrays hit collection
+//
+// The usual way for a detector to get hits into the event is for its
+// sensitive detector to make one G4VHit object per step, and for
+// @doFillEventWithArtHits@ to loop over the G4 hits collection and copy
+// each one into a vector of Art hit objects. That is two allocations and a
+// copy for every hit.
+//
+// A @SoAHitCollection@ instead keeps one vector per quantity (a "column").
+// The sensitive detector appends straight into it (see
+// @SoASensitiveDetector.hh@) and the detector moves the whole thing into the
+// event with @put@. Reading code that only needs, say, the energies touches
+// only the energy column.
+//
+// Row i of the collection is edep[i], time[i], x[i], ... All columns always
+// have the same length, except @weight@: with variance reduction (see
+// @artg4/pluginActions/importanceBiasing@) tracks carry weights, and each
+// row should count @rowWeight(i)@ times. The weight column stays empty, and
+// costs nothing, as long as every row has weight 1.
+//
+// Detectors that need more quantities supply an EXTRA type with their own
+// columns. It must have @reserve(n)@ and @clear()@; its columns are filled
+// by the detector's sensitive detector alongside the standard ones (see
+// @NoExtraHitColumns@ for the minimal version). The extra type needs a Root
+// dictionary like any other data product member.
+//
+// Only the data members are visible to Root (hence the @__GCCXML__@ ifdefs).
+
+#ifndef SOAHITCOLLECTION_HH
+#define SOAHITCOLLECTION_HH
+
+#include <vector>
+#include <cstddef>
+
+namespace artg4 {
+
+  // The EXTRA type for detectors that need only the standard columns
+  struct NoExtraHitColumns {
+#ifndef __GCCXML__
+    void reserve(std::size_t) {}
+    void clear() {}
+#endif
+  };
+
+  template <typename EXTRA = NoExtraHitColumns>
+  class SoAHitCollection {
+  public:
+
+    SoAHitCollection() :
+      edep(), time(), x(), y(), z(), volumeID(), trackID(), pdgID(), weight(), extra()
+    {}
+
+    virtual ~SoAHitCollection() {}
+
+#ifndef __GCCXML__
+    // The destructor would otherwise stop the columns being moved, e.g.
+    // into a TimeSlicedHits
+    SoAHitCollection(SoAHitCollection const&) = default;
+    SoAHitCollection(SoAHitCollection &&) = default;
+    SoAHitCollection& operator=(SoAHitCollection const&) = default;
+    SoAHitCollection& operator=(SoAHitCollection &&) = default;
+#endif
+
+    // h3. The columns
+
+    std::vector<float> edep;              // energy deposited in the step
+    std::vector<double> time;             // global time (double: the run spans hundreds of us)
+    std::vector<float> x, y, z;           // global position
+    std::vector<unsigned int> volumeID;   // detector-defined volume identifier
+    std::vector<int> trackID;
+    std::vector<int> pdgID;
+    std::vector<float> weight;            // empty if all rows have weight 1
+
+    EXTRA extra;
+
+#ifndef __GCCXML__
+
+    typedef EXTRA extra_type;
+
+    std::size_t size() const { return edep.size(); }
+    bool empty() const { return edep.empty(); }
+
+    // Append a row of the standard columns and return its index. The
+    // caller appends to the extra columns, if any.
+    std::size_t push_back(float e, double t, float px, float py, float pz,
+                          unsigned int volume, int track, int pdg) {
+      edep.push_back(e);
+      time.push_back(t);
+      x.push_back(px);
+      y.push_back(py);
+      z.push_back(pz);
+      volumeID.push_back(volume);
+      trackID.push_back(track);
+      pdgID.push_back(pdg);
+      if ( ! weight.empty() ) weight.push_back(1);
+      return edep.size() - 1;
+    }
+
+    // The weight of row i, and setting it
+    float rowWeight(std::size_t i) const { return weight.empty() ? 1 : weight[i]; }
+    void setWeight(std::size_t i, float w) {
+      if ( weight.empty() ) {
+        if ( w == 1 ) return;
+        weight.assign(size(), 1);
+      }
+      weight[i] = w;
+    }
+
+    void reserve(std::size_t n) {
+      edep.reserve(n);
+      time.reserve(n);
+      x.reserve(n);
+      y.reserve(n);
+      z.reserve(n);
+      volumeID.reserve(n);
+      trackID.reserve(n);
+      pdgID.reserve(n);
+      extra.reserve(n);
+    }
+
+    void clear() {
+      edep.clear();
+      time.clear();
+      x.clear();
+      y.clear();
+      z.clear();
+      volumeID.clear();
+      trackID.clear();
+      pdgID.clear();
+      weight.clear();
+      extra.clear();
+    }
+
+#endif
+  };
+
+  // The collection most detectors will want
+  typedef SoAHitCollection<NoExtraHitColumns> BasicSoAHitCollection;
+}
+
+#endif
@@ -0,0 +1,244 @@
+// A sensitive detector that fills a SoAHitCollection directly
+//
+// Instead of making a G4VHit per step and a G4 hits collection, this
+// sensitive detector appends a row to a @SoAHitCollection@ (see
+// @SoAHitCollection.hh@) that it owns for the current event. The detector
+// takes the collection and moves it into the Art event:
+//
+//   void MyDetector::doFillEventWithArtHits(G4HCofThisEvent*) {
+//     art::ServiceHandle<artg4::DetectorHolderService> dh;
+//     dh->getCurrArtEvent().put( sd_->takeHits(), myName() );
+//   }
+//
+// and says so in @doCallArtProduces@ with
+// @producer->produces<artg4::BasicSoAHitCollection>(myName())@.
+//
+// By default a row is written for every step that deposits energy, with
+// the pre-step position and time, the copy number of the pre-step volume
+// as the volume ID and the track's weight. Override @acceptStep@, @volumeID@ or @fillRow@ to
+// change that; a detector with extra columns overrides @fillRow@, calls the
+// base version and then appends its own columns.
+//
+// Get one with @artg4::getSensitiveDetector<SoASensitiveDetector<> >(name)@
+// (see @util.hh@); the constructor registers it with the G4SDManager.
+//
+// Steps of the same track in the same cell can be merged into one row as
+// they happen; see @StepMerging.hh@. A detector with extra columns that
+// uses merging should also override @mergeRow@ to fold a step into its
+// extra columns.
+//
+// Energy spots from fast simulation models (see @EnergySpot.hh@) become
+// rows too, one per spot, with the copy number of the spot's volume as the
+// volume ID (@spotVolumeID@) and the shower parent's track and PDG IDs. A
+// detector with extra columns overrides @fillSpotRow@ as well.
+//
+// Hits from a background library (see @BackgroundHits.hh@) are appended
+// with @overlay@, with track ID 0 (no track of this event). A detector with
+// extra columns overrides @fillOverlayRow@ too.
+
+#ifndef SOASENSITIVEDETECTOR_HH
+#define SOASENSITIVEDETECTOR_HH
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Geant4/G4VSensitiveDetector.hh"
+#include "Geant4/G4SDManager.hh"
+#include "Geant4/G4Step.hh"
+#include "Geant4/G4StepPoint.hh"
+#include "Geant4/G4Track.hh"
+#include "Geant4/G4VTouchable.hh"
+#include "Geant4/G4ParticleDefinition.hh"
+
+#include "artg4/util/SoAHitCollection.hh"
+#include "artg4/util/StepMerging.hh"
+#include "artg4/util/EnergySpot.hh"
+#include "artg4/util/BackgroundHits.hh"
+
+class G4HCofThisEvent;
+class G4TouchableHistory;
+
+namespace artg4 {
+
+  template <typename COLLECTION = BasicSoAHitCollection>
+  class SoASensitiveDetector : public G4VSensitiveDetector, public EnergySpotSensitiveDetector {
+  public:
+
+    typedef COLLECTION collection_type;
+
+    explicit SoASensitiveDetector(G4String name) :
+      G4VSensitiveDetector(name),
+      hits_( new COLLECTION ),
+      expectedSize_(0),
+      merging_(),
+      openRows_(),
+      rowStartTime_(),
+      nSteps_(0)
+    {
+      G4SDManager::GetSDMpointer()->AddNewDetector(this);
+    }
+
+    virtual ~SoASensitiveDetector() {}
+
+    // Start a new event. Room for as many rows as the largest event so far
+    // is reserved up front so that the columns rarely reallocate.
+    virtual void Initialize(G4HCofThisEvent*) override {
+      if ( ! hits_ ) hits_.reset( new COLLECTION );
+      hits_->clear();
+      hits_->reserve(expectedSize_);
+      resetMerging();
+    }
+
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory*) override {
+      if ( ! acceptStep(step) ) return false;
+      ++nSteps_;
+
+      if ( ! merging_.enabled ) {
+        fillRow(step, *hits_);
+        return true;
+      }
+
+      // Fold into the open row of this track and cell if it is recent enough
+      std::uint64_t key = rowKey( step->GetTrack()->GetTrackID(), volumeID(step) );
+      double t = step->GetPreStepPoint()->GetGlobalTime();
+      auto open = openRows_.find(key);
+      if ( open != openRows_.end() && t - rowStartTime_[open->second] <= merging_.timeWindow ) {
+        mergeRow(step, *hits_, open->second);
+        return true;
+      }
+
+      std::size_t row = hits_->size();
+      fillRow(step, *hits_);
+      openRows_[key] = row;
+      rowStartTime_.resize(row + 1, t);
+      return true;
+    }
+
+    // A spot from a fast simulation model (see @EnergySpot.hh@)
+    virtual void processSpot(EnergySpot const& spot, const G4VTouchable* touchable,
+                             const G4Track& track) override {
+      fillSpotRow(spot, touchable, track, *hits_);
+    }
+
+    // Append background hits, shifted by timeShift (see
+    // @BackgroundHits.hh@)
+    void overlay(BackgroundHits const& background, double timeShift) {
+      for ( std::size_t i = 0; i < background.size; ++i ) {
+        fillOverlayRow(background, i, timeShift, *hits_);
+      }
+    }
+
+    // Turn step merging on or off (see @StepMerging.hh@)
+    void setStepMerging(StepMerging const& merging) { merging_ = merging; }
+    StepMerging const& stepMerging() const { return merging_; }
+
+    // Steps accepted so far this event. With merging, compare to
+    // hits().size() to see how much it saved.
+    std::size_t nSteps() const { return nSteps_; }
+
+    // Hand over this event's hits (for @art::Event::put@), or those of the
+    // time slice just done (see @TimeSlicedHits.hh@). The detector is left
+    // with an empty collection.
+    std::unique_ptr<COLLECTION> takeHits() {
+      if ( hits_ && hits_->size() > expectedSize_ ) expectedSize_ = hits_->size();
+      std::unique_ptr<COLLECTION> taken( std::move(hits_) );
+      hits_.reset( new COLLECTION );
+      resetMerging();
+      return taken;
+    }
+
+    // This event's hits so far
+    COLLECTION const& hits() const { return *hits_; }
+
+  protected:
+
+    // Should this step make a row?
+    virtual bool acceptStep(const G4Step* step) {
+      return step->GetTotalEnergyDeposit() > 0;
+    }
+
+    // The volumeID column for this step
+    virtual unsigned int volumeID(const G4Step* step) {
+      return step->GetPreStepPoint()->GetTouchable()->GetCopyNumber();
+    }
+
+    // Append this step to the collection
+    virtual void fillRow(const G4Step* step, COLLECTION & hits) {
+      const G4StepPoint* pre = step->GetPreStepPoint();
+      const G4Track* track = step->GetTrack();
+      const G4ThreeVector & pos = pre->GetPosition();
+      std::size_t row = hits.push_back( step->GetTotalEnergyDeposit(), pre->GetGlobalTime(),
+                                        pos.x(), pos.y(), pos.z(), volumeID(step),
+                                        track->GetTrackID(), track->GetDefinition()->GetPDGEncoding() );
+      hits.setWeight( row, track->GetWeight() );
+    }
+
+    // The volumeID column for a spot
+    virtual unsigned int spotVolumeID(const G4VTouchable* touchable) {
+      return touchable->GetCopyNumber();
+    }
+
+    // Append this spot to the collection
+    virtual void fillSpotRow(EnergySpot const& spot, const G4VTouchable* touchable,
+                             const G4Track& track, COLLECTION & hits) {
+      std::size_t row = hits.push_back( spot.energy, spot.time, spot.position.x(), spot.position.y(),
+                                        spot.position.z(), spotVolumeID(touchable), track.GetTrackID(),
+                                        track.GetDefinition()->GetPDGEncoding() );
+      hits.setWeight( row, track.GetWeight() );
+    }
+
+    // Append row i of the background hits
+    virtual void fillOverlayRow(BackgroundHits const& background, std::size_t i, double timeShift,
+                                COLLECTION & hits) {
+      std::size_t row = hits.push_back( background.edep[i], background.time[i] + timeShift,
+                                        background.x[i], background.y[i], background.z[i],
+                                        background.volumeID[i], 0, background.pdgID[i] );
+      hits.setWeight( row, background.weight[i] );
+    }
+
+    // Fold this step into an existing row: energies add, position and time
+    // become energy weighted averages
+    virtual void mergeRow(const G4Step* step, COLLECTION & hits, std::size_t row) {
+      const G4StepPoint* pre = step->GetPreStepPoint();
+      const G4ThreeVector & pos = pre->GetPosition();
+      double e = step->GetTotalEnergyDeposit();
+      double total = hits.edep[row] + e;
+      if ( total <= 0 ) return;
+
+      double wOld = hits.edep[row] / total;
+      double wNew = e / total;
+      hits.x[row] = wOld * hits.x[row] + wNew * pos.x();
+      hits.y[row] = wOld * hits.y[row] + wNew * pos.y();
+      hits.z[row] = wOld * hits.z[row] + wNew * pos.z();
+      hits.time[row] = wOld * hits.time[row] + wNew * pre->GetGlobalTime();
+      hits.edep[row] = total;
+    }
+
+  private:
+
+    // Track IDs and volume IDs both fit in 32 bits
+    static std::uint64_t rowKey(int trackID, unsigned int volume) {
+      return ( static_cast<std::uint64_t>( static_cast<std::uint32_t>(trackID) ) << 32 ) | volume;
+    }
+
+    void resetMerging() {
+      openRows_.clear();
+      rowStartTime_.clear();
+      nSteps_ = 0;
+    }
+
+    std::unique_ptr<COLLECTION> hits_;
+    std::size_t expectedSize_;
+
+    // Step merging: the row each (track, cell) is currently merging into,
+    // and the time of the first step of every row
+    StepMerging merging_;
+    std::unordered_map<std::uint64_t, std::size_t> openRows_;
+    std::vector<double> rowStartTime_;
+    std::size_t nSteps_;
+  };
+}
+
+#endif
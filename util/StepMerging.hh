@@ -0,0 +1,47 @@
+// Step merging settings for SoASensitiveDetector
+//
+// Without merging, a sensitive detector writes one hit per G4 step, so the
+// number of hits (and the output size and conversion time) follows the
+// step count rather than the physics. With merging on, a step is folded
+// into the previous hit of the same track in the same readout cell
+// (volumeID) if it starts within timeWindow of that hit's first step. The
+// merged hit has the summed energy and the energy-weighted position and
+// time.
+//
+// The settings come from a @stepMerging@ table in the detector's
+// parameters (@DetectorBase::parameters()@), e.g.
+//
+//   stepMerging: { enabled: true  timeWindow: 2.0 } // ns
+//
+// and are given to the sensitive detector with
+// @sd->setStepMerging( artg4::StepMerging(parameters()) )@.
+
+#ifndef STEPMERGING_HH
+#define STEPMERGING_HH
+
+#include "fhiclcpp/ParameterSet.h"
+
+namespace artg4 {
+
+  struct StepMerging {
+
+    // Merging off
+    StepMerging() : enabled(false), timeWindow(0) {}
+
+    // From the @stepMerging@ table of a detector's parameters; off if
+    // there is no such table
+    explicit StepMerging(fhicl::ParameterSet const& detectorParams) :
+      enabled(false),
+      timeWindow(0)
+    {
+      fhicl::ParameterSet p = detectorParams.get<fhicl::ParameterSet>("stepMerging", fhicl::ParameterSet());
+      enabled = p.get<bool>("enabled", false);
+      timeWindow = p.get<double>("timeWindow", 1.0);   // ns, the Geant time unit
+    }
+
+    bool enabled;
+    double timeWindow;
+  };
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Hits of a time-sliced event
+//
+// An event that lasts a long time (a muon fill lasts hundreds of
+// microseconds) can be simulated in time slices (see
+// @artg4/pluginActions/timeSlicing@): everything in one window of global
+// time is tracked before anything in the next. At the end of each slice the
+// detectors hand their hits for it over, and their sensitive detectors start
+// again with empty collections. A @TimeSlicedHits@ collects those slices
+// for the Art event, each as a collection of its own.
+//
+// Storing the slices quantized (see @HitQuantization.hh@) is what bounds a
+// detector's memory: only the open slice is kept at full precision. A
+// detector that slices its hits does it like so:
+//
+//   // member, made in the constructor
+//   std::unique_ptr<artg4::BasicTimeSlicedQuantizedHits> slices_;
+//
+//   void MyDetector::doCallArtProduces(art::EDProducer * producer) {
+//     producer->produces<artg4::BasicTimeSlicedQuantizedHits>(myName());
+//   }
+//
+//   void MyDetector::doFlushTimeSlice(double sliceStart) {
+//     slices_->addSlice( sliceStart, artg4::quantizeHits(sd_->takeHits(), quantization_) );
+//   }
+//
+//   void MyDetector::doFillEventWithArtHits(G4HCofThisEvent*) {
+//     art::ServiceHandle<artg4::DetectorHolderService> dh;
+//     doFlushTimeSlice( dh->timeSliceStart() );   // the last slice
+//     dh->getCurrArtEvent().put( std::move(slices_), myName() );
+//     slices_.reset( new artg4::BasicTimeSlicedQuantizedHits );
+//   }
+//
+// Slices without hits are not kept.
+//
+// Only the data members are visible to Root (hence the @__GCCXML__@ ifdefs).
+
+#ifndef TIMESLICEDHITS_HH
+#define TIMESLICEDHITS_HH
+
+#include <cstddef>
+#include <vector>
+
+#include "artg4/util/SoAHitCollection.hh"
+#include "artg4/util/QuantizedHitCollection.hh"
+
+#ifndef __GCCXML__
+#include <memory>
+#include <utility>
+#endif
+
+namespace artg4 {
+
+  template <typename COLLECTION>
+  class TimeSlicedHits {
+  public:
+
+    TimeSlicedHits() :
+      sliceStart(), slices()
+    {}
+
+    virtual ~TimeSlicedHits() {}
+
+    std::vector<double> sliceStart;     // global time each slice's window starts at
+    std::vector<COLLECTION> slices;
+
+#ifndef __GCCXML__
+
+    typedef COLLECTION collection_type;
+
+    std::size_t size() const { return slices.size(); }
+
+    // Hits in all the slices
+    std::size_t nHits() const {
+      std::size_t n = 0;
+      for ( auto const& slice : slices ) n += slice.size();
+      return n;
+    }
+
+    // Add the hits of the slice starting at sliceStart (e.g. from
+    // @SoASensitiveDetector::takeHits@)
+    void addSlice(double start, std::unique_ptr<COLLECTION> hits) {
+      if ( ! hits || hits->empty() ) return;
+      sliceStart.push_back(start);
+      slices.push_back( std::move(*hits) );
+    }
+
+#endif
+  };
+
+  typedef TimeSlicedHits<BasicSoAHitCollection> BasicTimeSlicedHits;
+  typedef TimeSlicedHits<BasicQuantizedHitCollection> BasicTimeSlicedQuantizedHits;
+}
+
+#endif
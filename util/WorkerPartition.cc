@@ -0,0 +1,205 @@
+// Implementation of the forked workers
+
+#include "artg4/util/WorkerPartition.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cetlib/exception.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace {
+
+  // Read or write all of the buffer, riding out interruptions. Returns the
+  // number of bytes transferred (short only at end of file or on error).
+  std::size_t readAll(int fd, char* buffer, std::size_t size) {
+    std::size_t done = 0;
+    while ( done < size ) {
+      ssize_t n = ::read(fd, buffer + done, size - done);
+      if ( n < 0 && errno == EINTR ) continue;
+      if ( n <= 0 ) break;
+      done += n;
+    }
+    return done;
+  }
+
+  std::size_t writeAll(int fd, const char* buffer, std::size_t size) {
+    std::size_t done = 0;
+    while ( done < size ) {
+      ssize_t n = ::write(fd, buffer + done, size - done);
+      if ( n < 0 && errno == EINTR ) continue;
+      if ( n <= 0 ) break;
+      done += n;
+    }
+    return done;
+  }
+
+  // The MessageFacility's logging thread is not copied by fork, so in a
+  // worker messages would pile up in its queue, and block the worker once
+  // the queue is full. Start the facility again in its single threaded
+  // mode, where messages are written by the thread that logs them.
+  //
+  // The MessageFacility has no supported way to do that, so this resets its
+  // service state by hand: MFPresence and MFServiceEnabled are the members
+  // of MessageFacilityService in messagefacility v1_10 (as required by the
+  // top level CMakeLists.txt), and util/CMakeLists.txt only defines
+  // ARTG4_MF_RESTART_AFTER_FORK for a v1_10 messagefacility. The old
+  // presence is leaked on purpose: destroying it would wait for the
+  // missing thread. Check this again before moving to another version.
+#ifdef ARTG4_MF_RESTART_AFTER_FORK
+  const bool canRestartLogging = true;
+
+  void restartLogging(fhicl::ParameterSet const& config) {
+    mf::MessageFacilityService & mfs = mf::MessageFacilityService::instance();
+    mfs.MFPresence.release();
+    mfs.MFServiceEnabled = false;
+    mf::StartMessageFacility( mf::MessageFacilityService::SingleThread, config );
+  }
+#else
+  const bool canRestartLogging = false;
+
+  void restartLogging(fhicl::ParameterSet const&) {}
+#endif
+}
+
+artg4::WorkerPartition& artg4::WorkerPartition::instance() {
+  static WorkerPartition partition;
+  return partition;
+}
+
+artg4::WorkerPartition::WorkerPartition() :
+  nWorkers_(0),
+  rank_(-1),
+  pids_(),
+  readFds_(),
+  writeFd_(-1)
+{}
+
+void artg4::WorkerPartition::forkWorkers(unsigned int n, std::string const& dirPrefix,
+                                         fhicl::ParameterSet const& messageConfig) {
+  if ( forked() ) {
+    throw cet::exception("WorkerPartition") << "Workers have already been forked\n";
+  }
+  if ( ! canRestartLogging ) {
+    throw cet::exception("WorkerPartition") << "Forked workers cannot restart the MessageFacility of this "
+                                            << "messagefacility version, so they would hang on their first "
+                                            << "messages; see restartLogging in WorkerPartition.cc\n";
+  }
+  nWorkers_ = n;
+
+  for ( unsigned int r = 0; r < n; ++r ) {
+    std::ostringstream dir;
+    dir << dirPrefix << r;
+    if ( ::mkdir(dir.str().c_str(), 0775) != 0 && errno != EEXIST ) {
+      throw cet::exception("WorkerPartition") << "Cannot make worker directory "
+                                              << dir.str() << ": " << std::strerror(errno) << "\n";
+    }
+
+    int fds[2];
+    if ( ::pipe(fds) != 0 ) {
+      throw cet::exception("WorkerPartition") << "Cannot make pipe for worker " << r
+                                              << ": " << std::strerror(errno) << "\n";
+    }
+
+    // Don't let buffered output be written twice, and don't fork while the
+    // logging thread is in the middle of a message
+    mf::FlushMessageLog();
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    pid_t pid = ::fork();
+    if ( pid < 0 ) {
+      throw cet::exception("WorkerPartition") << "Cannot fork worker " << r
+                                              << ": " << std::strerror(errno) << "\n";
+    }
+
+    if ( pid == 0 ) {
+      // The worker. It has no business with the other workers' pipes.
+      ::close(fds[0]);
+      for ( int fd : readFds_ ) ::close(fd);
+      readFds_.clear();
+      pids_.clear();
+      rank_ = r;
+      writeFd_ = fds[1];
+
+      // Log from the worker's own directory, but have logging back before
+      // anything (even a failed chdir) is reported
+      int chdirErrno = ( ::chdir(dir.str().c_str()) == 0 ) ? 0 : errno;
+      restartLogging(messageConfig);
+      if ( chdirErrno != 0 ) {
+        throw cet::exception("WorkerPartition") << "Worker " << r << " cannot change to "
+                                                << dir.str() << ": " << std::strerror(chdirErrno) << "\n";
+      }
+      return;
+    }
+
+    // The parent
+    ::close(fds[1]);
+    pids_.push_back(pid);
+    readFds_.push_back(fds[0]);
+  }
+}
+
+void artg4::WorkerPartition::sendReport(RunReport const& report) {
+  if ( writeFd_ < 0 ) return;
+  if ( writeAll(writeFd_, reinterpret_cast<const char*>(&report), sizeof report) != sizeof report ) {
+    mf::LogWarning("WorkerPartition") << "Worker " << rank_ << " could not send its run report";
+  }
+}
+
+std::vector<artg4::WorkerPartition::RunReport> artg4::WorkerPartition::collectReports() {
+  std::vector<RunReport> reports;
+  for ( unsigned int r = 0; r < readFds_.size(); ++r ) {
+    if ( readFds_[r] < 0 ) continue;
+
+    RunReport report;
+    if ( readAll(readFds_[r], reinterpret_cast<char*>(&report), sizeof report) == sizeof report ) {
+      reports.push_back(report);
+    }
+    else {
+      mf::LogError("WorkerPartition") << "Worker " << r << " ended without reporting its run";
+      ::close(readFds_[r]);
+      readFds_[r] = -1;
+    }
+  }
+  return reports;
+}
+
+void artg4::WorkerPartition::waitForWorkers() {
+  for ( int& fd : readFds_ ) {
+    if ( fd >= 0 ) ::close(fd);
+    fd = -1;
+  }
+
+  std::ostringstream failures;
+  for ( unsigned int r = 0; r < pids_.size(); ++r ) {
+    int status = 0;
+    pid_t done;
+    do {
+      done = ::waitpid(pids_[r], &status, 0);
+    } while ( done < 0 && errno == EINTR );
+
+    if ( done < 0 ) {
+      failures << "  worker " << r << ": " << std::strerror(errno) << "\n";
+    }
+    else if ( WIFSIGNALED(status) ) {
+      failures << "  worker " << r << " killed by signal " << WTERMSIG(status) << "\n";
+    }
+    else if ( WIFEXITED(status) && WEXITSTATUS(status) != 0 ) {
+      failures << "  worker " << r << " exited with status " << WEXITSTATUS(status) << "\n";
+    }
+  }
+  pids_.clear();
+
+  if ( ! failures.str().empty() ) {
+    throw cet::exception("WorkerPartition") << "Workers failed:\n" << failures.str();
+  }
+}
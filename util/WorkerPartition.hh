@@ -0,0 +1,101 @@
+// Forked workers for artg4Main
+//
+// Running N independent art processes on a node builds the geometry,
+// materials and physics tables N times and keeps N copies of them. Instead,
+// artg4Main can initialize Geant once and then fork N workers (its
+// @forkWorkers@ parameter). The workers share everything built so far
+// copy-on-write.
+//
+// Every process still reads every event from the source. Worker r
+// simulates the events whose number is r modulo N (put
+// @artg4WorkerFilter@ at the front of the path so that only those reach
+// the output). Each worker runs in its own directory, @<forkDirPrefix><r>@,
+// so relative output file names give each worker its own file. The parent
+// simulates nothing; it collects a summary of each worker's run through a
+// pipe (see @ForkedRunSummary.hh@) and waits for the workers at the end of
+// the job.
+//
+// Fork before any output file is opened and before any other threads are
+// started. The one thread that is already running is the MessageFacility's
+// logger, which does not survive the fork; each worker therefore restarts
+// the MessageFacility in its single threaded mode with the configuration
+// given to @forkWorkers@ (relative log file names then land in the worker's
+// directory). That relies on internals of messagefacility v1_10; with any
+// other version @forkWorkers@ throws instead.
+
+#ifndef WORKERPARTITION_HH
+#define WORKERPARTITION_HH
+
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include <sys/types.h>
+
+namespace artg4 {
+
+  class WorkerPartition {
+  public:
+
+    // The one partition of this process
+    static WorkerPartition& instance();
+
+    // Fork n workers. Returns in each worker (with its rank set and its
+    // logging restarted with messageConfig) and in the parent. Throws if a
+    // directory or a worker cannot be made.
+    void forkWorkers(unsigned int n, std::string const& dirPrefix,
+                     fhicl::ParameterSet const& messageConfig);
+
+    // h3. Who am I
+
+    bool forked() const { return nWorkers_ > 0; }
+    bool isParent() const { return forked() && rank_ < 0; }
+    bool isWorker() const { return rank_ >= 0; }
+    unsigned int nWorkers() const { return nWorkers_; }
+    int rank() const { return rank_; }
+
+    // Should this process simulate this event? Always true if not forked.
+    bool owns(unsigned int eventNumber) const {
+      if ( ! forked() ) return true;
+      return isWorker() && eventNumber % nWorkers_ == static_cast<unsigned int>(rank_);
+    }
+
+    // h3. Run summaries
+
+    struct RunReport {
+      int rank;
+      unsigned int nEvents;
+      double wallSeconds;
+      double cpuSeconds;
+    };
+
+    // Worker: send this run's report to the parent
+    void sendReport(RunReport const& report);
+
+    // Parent: wait for this run's report from every worker. A worker that
+    // has died is logged and left out.
+    std::vector<RunReport> collectReports();
+
+    // Parent: wait for all workers to exit. Throws if any did not exit
+    // cleanly.
+    void waitForWorkers();
+
+  private:
+
+    WorkerPartition();
+    WorkerPartition(WorkerPartition const&);
+    WorkerPartition& operator=(WorkerPartition const&);
+
+    unsigned int nWorkers_;
+    int rank_;
+
+    // Parent: the workers and the read end of each one's pipe (-1 once the
+    // worker has hung up). Worker: the write end of its pipe.
+    std::vector<pid_t> pids_;
+    std::vector<int> readFds_;
+    int writeFd_;
+  };
+}
+
+#endif
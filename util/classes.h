@@ -0,0 +1,37 @@
+// classes.h
+
+#include <vector>
+
+#include "art/Persistency/Common/Wrapper.h"
+
+// For the structure-of-arrays hit collections
+#include "artg4/util/SoAHitCollection.hh"
+template class artg4::SoAHitCollection<artg4::NoExtraHitColumns>;
+template class art::Wrapper< artg4::SoAHitCollection<artg4::NoExtraHitColumns> >;
+
+// For the quantized hit collections
+#include "artg4/util/QuantizedHitCollection.hh"
+template class artg4::QuantizedHitCollection<artg4::NoExtraHitColumns>;
+template class art::Wrapper< artg4::QuantizedHitCollection<artg4::NoExtraHitColumns> >;
+
+// For time-sliced hits
+#include "artg4/util/TimeSlicedHits.hh"
+template class std::vector< artg4::SoAHitCollection<artg4::NoExtraHitColumns> >;
+template class std::vector< artg4::QuantizedHitCollection<artg4::NoExtraHitColumns> >;
+template class artg4::TimeSlicedHits< artg4::SoAHitCollection<artg4::NoExtraHitColumns> >;
+template class artg4::TimeSlicedHits< artg4::QuantizedHitCollection<artg4::NoExtraHitColumns> >;
+template class art::Wrapper< artg4::TimeSlicedHits< artg4::SoAHitCollection<artg4::NoExtraHitColumns> > >;
+template class art::Wrapper< artg4::TimeSlicedHits< artg4::QuantizedHitCollection<artg4::NoExtraHitColumns> > >;
+
+// For the forked run summary
+#include "artg4/util/ForkedRunSummary.hh"
+template class art::Wrapper<artg4::ForkedRunSummary>;
+
+// For the event abort status
+#include "artg4/util/EventAbortStatus.hh"
+template class art::Wrapper<artg4::EventAbortStatus>;
+template class art::Wrapper<artg4::EventAbortRunSummary>;
+
+// For the memory run summary
+#include "artg4/util/MemoryRunSummary.hh"
+template class art::Wrapper<artg4::MemoryRunSummary>;